@@ -0,0 +1,656 @@
+#include "Benchmarks.h"
+
+#include <AnimationComponents.h>
+#include <Serialization.hpp>
+
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace FlexKit;
+
+using AnimationState	= AnimatorComponent::AnimationState;
+using TrackSample		= AnimationState::TrackSample;
+
+
+/************************************************************************************************/
+
+
+// Binary tree of joints built in place, parents always come before their children
+struct BenchmarkSkeleton
+{
+	BenchmarkSkeleton(iAllocator& IN_allocator, const size_t jointCount) :
+		allocator{ IN_allocator }
+	{
+		skeleton.InitiateSkeleton(&allocator, jointCount);
+		names.reserve(jointCount);
+
+		for (size_t I = 0; I < jointCount; ++I)
+		{
+			names.push_back(fmt::format("Joint_{}", I));
+
+			Joint joint;
+			joint.mID		= names.back().c_str();
+			joint.mParent	= I ? JointHandle((I - 1) / 2) : JointHandle(InvalidHandle);
+
+			skeleton.AddJoint(joint, float4x4::Identity());
+		}
+	}
+
+	~BenchmarkSkeleton()
+	{
+		allocator._aligned_free(skeleton.Joints);
+		allocator._aligned_free(skeleton.IPose);
+		allocator._aligned_free(skeleton.JointPoses);
+	}
+
+	PoseState CreatePose()
+	{
+		return CreatePoseState(skeleton, &allocator);
+	}
+
+	void ReleasePose(PoseState& pose)
+	{
+		for (auto& subPose : pose.poses)
+			allocator.free(subPose.jointPose);
+
+		allocator._aligned_free(pose.Joints);
+		allocator._aligned_free(pose.CurrentPose);
+	}
+
+	iAllocator&					allocator;
+	Skeleton					skeleton;
+	std::vector<std::string>	names;
+};
+
+
+/************************************************************************************************/
+
+
+// Rotation, translation and scale tracks for every joint, keys evenly spaced over duration
+static void BuildBenchmarkClip(Animation& clip, BenchmarkSkeleton& skeleton, iAllocator& allocator, const size_t keyCount, const float duration)
+{
+	const float keyTime = duration / float(keyCount);
+
+	for (size_t joint = 0; joint < skeleton.skeleton.JointCount; ++joint)
+	{
+		for (const char* trackName : { "rotation", "translation", "scale" })
+		{
+			AnimationTrack track{
+				.keyFrames	= { &allocator },
+				.type		= TrackType::Skeletal,
+				.trackName	= trackName,
+				.target		= skeleton.names[joint] };
+
+			for (size_t I = 0; I < keyCount; ++I)
+			{
+				const float angle = float(I + joint) * 0.05f;
+
+				track.keyFrames.push_back({
+					.Begin	= float(I) * keyTime,
+					.End	= I + 1 < keyCount ? float(I + 1) * keyTime : duration,
+					.Value	= trackName[0] == 'r' ?
+								float4{ 0.0f, std::sin(angle / 2), 0.0f, std::cos(angle / 2) } :
+								float4{ 0.0f, angle, 0.0f, 1.0f + 0.1f * std::sin(angle) } });
+			}
+
+			clip.tracks.push_back(std::move(track));
+		}
+	}
+}
+
+
+/************************************************************************************************/
+
+
+// Same bucketing as AnimatorView::Play, without needing a game object to hang the skeleton off
+static AnimationState PlayBenchmarkClip(Animation& clip, Skeleton& skeleton, iAllocator& allocator, const float T)
+{
+	AnimationState state{
+		.T				= T,
+		.ID				= 0,
+		.state			= AnimationState::State::Looping,
+		.trackGroups	= { &allocator, &allocator },
+		.resource		= &clip,
+		.duration		= clip.Duration(),
+	};
+
+	auto AddTrack = [&](auto& track, const char* trackName, const char* target)
+	{
+		const auto joint = skeleton.FindJoint(target);
+
+		if (!strcmp(trackName, "rotation"))
+			state.trackGroups[AnimationState::JointRotation].push_back(track, joint);
+		else if (!strcmp(trackName, "scale"))
+			state.trackGroups[AnimationState::JointScale].push_back(track, joint);
+	};
+
+	for (auto& track : clip.tracks)
+		AddTrack(track, track.trackName.c_str(), track.target.c_str());
+
+	for (auto& track : clip.compressedTracks)
+		AddTrack(track, track.trackName, track.target);
+
+	return state;
+}
+
+
+/************************************************************************************************/
+
+
+// What sampling cost before the cursor, a scan for the key covering T on every sample
+static TrackSample LinearSample(const AnimationTrack& track, const float T)
+{
+	const auto& keys = track.keyFrames;
+
+	size_t I = 0;
+	while (I < keys.size() && !(keys[I].Begin <= T && T < keys[I].End))
+		I++;
+
+	if (I == keys.size())
+		I = keys.size() - 1;
+
+	const size_t next	= Min(I + 1, keys.size() - 1);
+	const float  range	= keys[next].Begin - keys[I].Begin;
+
+	return {
+		.begin	= keys[I].Value,
+		.end	= keys[next].Value,
+		.u		= range != 0.0f ? clamp(0.0f, (T - keys[I].Begin) / range, 1.0f) : 0.0f,
+	};
+}
+
+
+static void LinearUpdate(AnimationState& state, PoseState::Pose& pose, const double dT)
+{
+	auto& rotations = state.trackGroups[AnimationState::JointRotation];
+
+	for (size_t I = 0; I < rotations.size(); ++I)
+	{
+		const auto sample	= LinearSample(*rotations.tracks[I].track, state.T);
+		const auto& A		= sample.begin;
+		const auto& B		= sample.end;
+
+		pose.jointPose[rotations.joints[I]].r *= sample.u == 0.0f ?
+			Quaternion{ A[0], A[1], A[2], A[3] } :
+			Qlerp(Quaternion{ A[0], A[1], A[2], A[3] }, Quaternion{ B[0], B[1], B[2], B[3] }, sample.u);
+	}
+
+	auto& scales = state.trackGroups[AnimationState::JointScale];
+
+	for (size_t I = 0; I < scales.size(); ++I)
+		pose.jointPose[scales.joints[I]].ts.w = LinearSample(*scales.tracks[I].track, state.T).begin.w;
+
+	state.T += dT;
+
+	if (state.T >= state.duration)
+		state.T = 0.0;
+}
+
+
+/************************************************************************************************/
+
+
+void AnimationSamplingBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t animatorCount	= 1000;
+	constexpr size_t jointCount		= 64;
+	constexpr size_t keyCount		= 120;
+	constexpr size_t frameCount		= 30;
+	constexpr float  duration		= 4.0f;
+	constexpr double dT				= 1.0 / 60.0;
+
+	BenchmarkSkeleton	skeleton{ ctx.allocator, jointCount };
+	Animation			clip{ ctx.allocator };
+
+	BuildBenchmarkClip(clip, skeleton, ctx.allocator, keyCount, duration);
+
+	std::vector<PoseState>		poses;
+	std::vector<AnimationState>	animations;
+
+	poses.reserve(animatorCount);
+	animations.reserve(animatorCount);
+
+	// Animators start out of phase so they don't all share the same keys
+	for (size_t I = 0; I < animatorCount; ++I)
+	{
+		poses.push_back(skeleton.CreatePose());
+		poses.back().CreateSubPose(GetTypeGUID(AnimationPose), ctx.allocator);
+
+		animations.push_back(PlayBenchmarkClip(clip, skeleton.skeleton, ctx.allocator, float(I % 240) / 60.0f));
+	}
+
+	std::vector<AnimatorComponent::AnimationStateContext> contexts;
+	contexts.reserve(animatorCount);
+
+	for (auto& pose : poses)
+		contexts.emplace_back(ctx.allocator).AddField(pose.poses.front());
+
+	Expect(animations.front().trackGroups[AnimationState::JointRotation].size() == jointCount, "rotation tracks were not bucketed");
+	Expect(animations.front().duration == duration, "clip duration does not cover its keys");
+
+	auto RunFrames = [&](auto&& update)
+	{
+		for (size_t frame = 0; frame < frameCount; ++frame)
+		{
+			for (size_t I = 0; I < animatorCount; ++I)
+			{
+				poses[I].poses.front().Clear(jointCount);
+				update(I);
+			}
+		}
+	};
+
+	const double forwardMS = BestOf(3,
+		[&]
+		{
+			RunFrames([&](const size_t I) { animations[I].Update(contexts[I], dT); });
+		});
+
+	// Scrubbing jumps around the clip, every sample misses the cursor and binary searches
+	std::minstd_rand						rng{ 1234 };
+	std::uniform_real_distribution<float>	seek{ 0.0f, duration };
+
+	const double seekMS = BestOf(3,
+		[&]
+		{
+			RunFrames(
+				[&](const size_t I)
+				{
+					animations[I].T = seek(rng);
+					animations[I].Update(contexts[I], dT);
+				});
+		});
+
+	const double linearMS = BestOf(3,
+		[&]
+		{
+			RunFrames([&](const size_t I) { LinearUpdate(animations[I], poses[I].poses.front(), dT); });
+		});
+
+	// Cursor sampling has to land on the same keys as the scan, forward, across the loop and after seeks
+	size_t mismatches	= 0;
+	auto& rotationTrack	= clip.tracks.front();
+
+	auto Differs = [](const float4& lhs, const float4& rhs)
+	{
+		for (size_t I = 0; I < 4; ++I)
+			if (std::abs(lhs[I] - rhs[I]) > 1e-5f)
+				return true;
+
+		return false;
+	};
+
+	AnimationState::TrackState trackState{ .track = &rotationTrack };
+
+	for (size_t I = 0; I < 2 * keyCount * 3; ++I)
+	{
+		const float T = I < keyCount * 4 ? std::fmod(float(I) * float(dT) * 0.75f, duration) : seek(rng);
+
+		const auto sample		= trackState.Sample(T);
+		const auto reference	= LinearSample(rotationTrack, T);
+
+		mismatches +=
+			Differs(sample.begin, reference.begin) ||
+			Differs(sample.end, reference.end) ||
+			std::abs(sample.u - reference.u) > 1e-5f;
+	}
+
+	Expect(mismatches == 0, "cursor sampling disagrees with the linear scan");
+	Expect(forwardMS < linearMS, "cursor sampling is not faster than a linear scan");
+
+	fmt::print("    {} animators x {} joints, {} keys | {} frames | forward: {:.2f} ms | seeking: {:.2f} ms | linear scan: {:.2f} ms | {:.2f}x\n",
+		animatorCount, jointCount, keyCount, frameCount, forwardMS, seekMS, linearMS, linearMS / forwardMS);
+
+	for (auto& pose : poses)
+		skeleton.ReleasePose(pose);
+}
+
+
+/************************************************************************************************/
+
+
+// Interpolated value of a sample, rotations are lined up with the reference so the quaternion sign doesn't count as error
+static float4 EvaluateSample(const TrackSample& sample, const bool rotation, const float4 reference)
+{
+	float d = 0.0f;
+	for (size_t I = 0; I < 4; ++I)
+		d += sample.begin[I] * sample.end[I];
+
+	const float endSign = rotation && d < 0.0f ? -1.0f : 1.0f;
+
+	float4 value;
+	for (size_t I = 0; I < 4; ++I)
+		value[I] = sample.begin[I] + (sample.end[I] * endSign - sample.begin[I]) * sample.u;
+
+	if (!rotation)
+		return value;
+
+	float r = 0.0f;
+	for (size_t I = 0; I < 4; ++I)
+		r += value[I] * reference[I];
+
+	if (r < 0.0f)
+		for (size_t I = 0; I < 4; ++I)
+			value[I] = -value[I];
+
+	return value;
+}
+
+
+void AnimationCompressionBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t animatorCount	= 1000;
+	constexpr size_t jointCount		= 64;
+	constexpr size_t keyCount		= 120;
+	constexpr size_t frameCount		= 30;
+	constexpr float  duration		= 4.0f;
+	constexpr double dT				= 1.0 / 60.0;
+
+	BenchmarkSkeleton	skeleton{ ctx.allocator, jointCount };
+	Animation			source{ ctx.allocator };
+
+	BuildBenchmarkClip(source, skeleton, ctx.allocator, keyCount, duration);
+
+	std::vector<AnimationTrackSource> sources;
+
+	for (auto& track : source.tracks)
+		sources.push_back({
+			.keyFrames	= { track.keyFrames.begin(), track.keyFrames.size() },
+			.trackName	= track.trackName.c_str(),
+			.target		= track.target.c_str(),
+			.type		= track.type });
+
+	InitiateAssetTable(&ctx.allocator, &ctx.threads);
+
+	// Written the way the editor exports clips, then handed to the asset table as if loaded from a pack
+	auto AddClip = [&](const GUID_t guid, const char* ID, const AnimationCompressionSettings& settings, const uint32_t version) -> size_t
+	{
+		AnimationResourceBlob::AnimationResourceHeader header = {
+			.Type		= EResourceType::EResource_Animation,
+			.GUID		= guid,
+			.trackCount	= (uint32_t)sources.size(),
+			.version	= version,
+		};
+
+		strncpy_s(header.ID, ID, _TRUNCATE);
+
+		Blob stream = WriteAnimationTracks(sources, settings);
+		header.ResourceSize = sizeof(header) + stream.size();
+
+		Blob blob{ header };
+		blob += stream;
+
+		auto buffer = ctx.allocator.malloc(blob.size());
+		memcpy(buffer, blob.data(), blob.size());
+
+		AddAssetBuffer((Resource*)buffer);
+
+		return blob.size();
+	};
+
+	const size_t rawSize		= AddClip(1, "RawClip",			{ .enabled = false },	AnimationResourceVersion);
+	const size_t compressedSize	= AddClip(2, "CompressedClip",	{},						AnimationResourceVersion);
+	AddClip(3, "StaleClip", {}, AnimationResourceVersion - 1);
+
+	Expect(LoadAnimation(GUID_t(3), ctx.allocator) == nullptr, "an animation with an old resource version was loaded");
+
+	Animation* raw			= LoadAnimation(GUID_t(1), ctx.allocator);
+	Animation* compressed	= LoadAnimation(GUID_t(2), ctx.allocator);
+
+	Expect(raw && compressed, "failed to load the benchmark clips");
+
+	if (!raw || !compressed)
+	{
+		ctx.allocator.release(raw);
+		ctx.allocator.release(compressed);
+		ReleaseAssetTable();
+		return;
+	}
+
+	Expect(raw->tracks.size() == sources.size() && compressed->compressedTracks.size() == sources.size(), "loaded clips are missing tracks");
+	Expect(compressedSize * 4 < rawSize, "compression did not shrink the clip");
+
+	// Every track of the clip is keyed at the same times, so they all reduce to one key set and one time table
+	std::set<const float*>	timeTables;
+	size_t					keptKeys = 0;
+
+	for (auto& track : compressed->compressedTracks)
+	{
+		timeTables.insert(track.times);
+		keptKeys += track.keyCount;
+	}
+
+	Expect(timeTables.size() == 1, "tracks with the same source keys did not share a time table");
+
+	// Compare against the raw clip at points between keys, where the reduction error shows up
+	float rotationError	= 0.0f;
+	float vectorError	= 0.0f;
+
+	for (size_t I = 0; I < sources.size(); ++I)
+	{
+		AnimationState::TrackState rawState{ .track = &raw->tracks[I] };
+		AnimationState::TrackState compressedState{ .compressed = &compressed->compressedTracks[I] };
+
+		const bool rotation = raw->tracks[I].trackName == "rotation";
+
+		for (size_t J = 0; J < keyCount * 4; ++J)
+		{
+			const float T = duration * float(J) / float(keyCount * 4);
+
+			const auto reference	= EvaluateSample(rawState.Sample(T), rotation, float4{ 0.0f, 0.0f, 0.0f, 1.0f });
+			const auto value		= EvaluateSample(compressedState.Sample(T), rotation, reference);
+
+			for (size_t K = 0; K < 4; ++K)
+			{
+				auto& error = rotation ? rotationError : vectorError;
+				error = Max(error, std::abs(value[K] - reference[K]));
+			}
+		}
+	}
+
+	const AnimationCompressionSettings settings;
+
+	Expect(rotationError < 4 * settings.rotationTolerance, "compressed rotations drifted from the source");
+	Expect(vectorError < 4 * settings.vectorTolerance, "compressed vectors drifted from the source");
+
+	std::vector<PoseState>		poses;
+	std::vector<AnimationState>	rawAnimations;
+	std::vector<AnimationState>	compressedAnimations;
+
+	for (size_t I = 0; I < animatorCount; ++I)
+	{
+		poses.push_back(skeleton.CreatePose());
+		poses.back().CreateSubPose(GetTypeGUID(AnimationPose), ctx.allocator);
+
+		rawAnimations.push_back(PlayBenchmarkClip(*raw, skeleton.skeleton, ctx.allocator, float(I % 240) / 60.0f));
+		compressedAnimations.push_back(PlayBenchmarkClip(*compressed, skeleton.skeleton, ctx.allocator, float(I % 240) / 60.0f));
+	}
+
+	std::vector<AnimatorComponent::AnimationStateContext> contexts;
+	contexts.reserve(animatorCount);
+
+	for (auto& pose : poses)
+		contexts.emplace_back(ctx.allocator).AddField(pose.poses.front());
+
+	auto RunFrames = [&](std::vector<AnimationState>& animations)
+	{
+		for (size_t frame = 0; frame < frameCount; ++frame)
+		{
+			for (size_t I = 0; I < animatorCount; ++I)
+			{
+				poses[I].poses.front().Clear(jointCount);
+				animations[I].Update(contexts[I], dT);
+			}
+		}
+	};
+
+	const double rawMS			= BestOf(3, [&] { RunFrames(rawAnimations); });
+	const double compressedMS	= BestOf(3, [&] { RunFrames(compressedAnimations); });
+
+	fmt::print("    {} tracks x {} keys | raw: {} bytes | compressed: {} bytes, {} keys kept, {} time tables | max error: {:.5f} rad, {:.5f}\n",
+		sources.size(), keyCount, rawSize, compressedSize, keptKeys, timeTables.size(), rotationError, vectorError);
+	fmt::print("    {} animators, {} frames | raw sampling: {:.2f} ms | compressed sampling: {:.2f} ms\n",
+		animatorCount, frameCount, rawMS, compressedMS);
+
+	for (auto& pose : poses)
+		skeleton.ReleasePose(pose);
+
+	ctx.allocator.release(raw);
+	ctx.allocator.release(compressed);
+
+	ReleaseAssetTable();
+}
+
+
+/************************************************************************************************/
+
+
+// UpdatePose before it worked four joints at a time, one GetPoseTransform and two matrix products per joint
+static void ScalarUpdatePose(PoseState& pose, std::vector<JointPose>& joints, std::vector<float4x4>& out)
+{
+	Skeleton* skeleton = pose.Sk;
+
+	for (size_t I = 0; I < pose.JointCount; ++I)
+		joints[I] = JointPose{ { 0, 0, 0, 1 }, { 0, 0, 0, 1 } };
+
+	for (auto& subPose : pose.poses)
+	{
+		for (size_t I = 0; I < pose.JointCount; ++I)
+		{
+			joints[I].r		*= subPose.jointPose[I].r;
+			joints[I].ts.w	*= subPose.jointPose[I].ts.w;
+			joints[I].ts	+= subPose.jointPose[I].ts.xyz();
+		}
+	}
+
+	for (size_t I = 0; I < skeleton->JointCount; ++I)
+	{
+		const auto poseT		= GetPoseTransform(joints[I]);
+		const auto skeletonT	= GetPoseTransform(skeleton->JointPoses[I]);
+
+		const auto parent		= skeleton->Joints[I].mParent;
+		const auto P			= (parent != 0xFFFF) ? out[parent] : float4x4::Identity();
+
+		out[I] = poseT * skeletonT * P;
+	}
+}
+
+
+void PoseUpdateBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t poseCount	= 500;
+	constexpr size_t jointCount	= 80;
+
+	BenchmarkSkeleton skeleton{ ctx.allocator, jointCount };
+
+	for (size_t I = 0; I < jointCount; ++I)
+	{
+		const float angle = 0.1f * float(I % 7);
+		skeleton.skeleton.JointPoses[I] = JointPose{ { 0.0f, std::sin(angle / 2), 0.0f, std::cos(angle / 2) }, { 0.0f, 0.5f, 0.0f, 1.0f } };
+	}
+
+	// One to three sub poses per character, like a base clip with additive layers on top
+	std::vector<PoseState> poses;
+	poses.reserve(poseCount);
+
+	for (size_t I = 0; I < poseCount; ++I)
+	{
+		poses.push_back(skeleton.CreatePose());
+
+		for (uint32_t layer = 0; layer < I % 3 + 1; ++layer)
+		{
+			auto& subPose = poses.back().CreateSubPose(layer + 1, ctx.allocator);
+
+			for (size_t J = 0; J < jointCount; ++J)
+			{
+				const float angle = 0.01f * float((I + J * 3 + layer * 11) % 64);
+
+				subPose.jointPose[J] = JointPose{
+					{ std::sin(angle / 2), 0.0f, 0.0f, std::cos(angle / 2) },
+					{ 0.1f * angle, 0.0f, 0.05f * float(layer), 1.0f + 0.1f * angle } };
+			}
+		}
+	}
+
+	std::vector<JointPose>					scratch(jointCount);
+	std::vector<std::vector<float4x4>>		reference(poseCount, std::vector<float4x4>(jointCount));
+	std::vector<std::vector<JointPose>>		referenceJoints(poseCount, std::vector<JointPose>(jointCount));
+
+	const double scalarMS = BestOf(5,
+		[&]
+		{
+			for (size_t I = 0; I < poseCount; ++I)
+				ScalarUpdatePose(poses[I], scratch, reference[I]);
+		});
+
+	for (size_t I = 0; I < poseCount; ++I)
+		ScalarUpdatePose(poses[I], referenceJoints[I], reference[I]);
+
+	const double serialMS = BestOf(5,
+		[&]
+		{
+			for (auto& pose : poses)
+				UpdatePose(pose, ctx.allocator);
+		});
+
+	auto MaxError = [&]() -> float
+	{
+		float error = 0.0f;
+
+		for (size_t I = 0; I < poseCount; ++I)
+		{
+			for (size_t J = 0; J < jointCount; ++J)
+			{
+				const float* lhs = poses[I].CurrentPose[J];
+				const float* rhs = reference[I][J];
+
+				for (size_t K = 0; K < 16; ++K)
+					error = Max(error, std::abs(lhs[K] - rhs[K]));
+
+				for (size_t K = 0; K < 4; ++K)
+				{
+					error = Max(error, std::abs(poses[I].Joints[J].r[K] - referenceJoints[I][J].r[K]));
+					error = Max(error, std::abs(poses[I].Joints[J].ts[K] - referenceJoints[I][J].ts[K]));
+				}
+			}
+		}
+
+		return error;
+	};
+
+	const float serialError = MaxError();
+
+	for (auto& pose : poses)
+		for (size_t J = 0; J < jointCount; ++J)
+			pose.CurrentPose[J] = float4x4::Identity();
+
+	// Same fan out as UpdatePoses, every character owns its pose
+	StackAllocator frame{ &ctx.allocator, 16 * MEGABYTE };
+
+	const double parallelMS = BestOf(5,
+		[&]
+		{
+			frame.clear();
+
+			Parallel_For(ctx.threads, frame, poses.begin(), poses.end(),
+				[](PoseState& pose, iAllocator& allocator) { UpdatePose(pose, allocator); });
+		});
+
+	const float parallelError = MaxError();
+
+	Expect(serialError < 1e-4f, "UpdatePose disagrees with the scalar reference");
+	Expect(parallelError < 1e-4f, "parallel pose updates disagree with the scalar reference");
+	Expect(serialMS < scalarMS, "4 joint blocks are not faster than composing joints one at a time");
+
+	if (ctx.threads.GetThreadCount() > 1)
+		Expect(parallelMS < serialMS, "parallel pose updates are not faster than updating serially");
+
+	fmt::print("    {} poses x {} joints | scalar: {:.2f} ms | blocks: {:.2f} ms | blocks + Parallel_For: {:.2f} ms | max error: {:.2e}\n",
+		poseCount, jointCount, scalarMS, serialMS, parallelMS, Max(serialError, parallelError));
+
+	for (auto& pose : poses)
+		skeleton.ReleasePose(pose);
+}
@@ -0,0 +1,277 @@
+#include "Benchmarks.h"
+
+#include <ArchetypeComponents.h>
+#include <Scene.h>
+#include <Transforms.h>
+
+#include <random>
+#include <vector>
+
+using namespace FlexKit;
+
+
+/************************************************************************************************/
+
+
+constexpr ComponentID BenchmarkPositionID		= GetTypeGUID(BenchmarkPosition);
+constexpr ComponentID BenchmarkVelocityID		= GetTypeGUID(BenchmarkVelocity);
+constexpr ComponentID ArchetypePositionID		= GetTypeGUID(ArchetypePosition);
+constexpr ComponentID ArchetypeVelocityID		= GetTypeGUID(ArchetypeVelocity);
+
+using BenchmarkPositionComponent	= BasicComponent_t<float3, Handle_t<32, BenchmarkPositionID>, BenchmarkPositionID>;
+using BenchmarkVelocityComponent	= BasicComponent_t<float3, Handle_t<32, BenchmarkVelocityID>, BenchmarkVelocityID>;
+using ArchetypePositionComponent	= ArchetypeComponent_t<float3, Handle_t<32, ArchetypePositionID>, ArchetypePositionID>;
+using ArchetypeVelocityComponent	= ArchetypeComponent_t<float3, Handle_t<32, ArchetypeVelocityID>, ArchetypeVelocityID>;
+
+using BenchmarkPositionView			= BenchmarkPositionComponent::View;
+using BenchmarkVelocityView			= BenchmarkVelocityComponent::View;
+using ArchetypePositionView			= ArchetypePositionComponent::View;
+using ArchetypeVelocityView			= ArchetypeVelocityComponent::View;
+
+
+/************************************************************************************************/
+
+
+// Integrates positions through the per object views of the basic component store and through archetype columns
+static void IntegrateBenchmark(BenchmarkContext& ctx, const size_t entityCount)
+{
+	constexpr size_t	frameCount	= 10;
+	constexpr float		dt			= 1.0f / 60.0f;
+
+	ArchetypeStorage			storage{ &ctx.allocator };
+	BenchmarkPositionComponent	basicPositions{ &ctx.allocator };
+	BenchmarkVelocityComponent	basicVelocities{ &ctx.allocator };
+	ArchetypePositionComponent	archetypePositions{ storage, &ctx.allocator };
+	ArchetypeVelocityComponent	archetypeVelocities{ storage, &ctx.allocator };
+
+	std::minstd_rand						rng{ uint32_t(entityCount) };
+	std::uniform_real_distribution<float>	distribution{ -10.0f, 10.0f };
+
+	GameObject* basicObjects		= new GameObject[entityCount];
+	GameObject* archetypeObjects	= new GameObject[entityCount];
+
+	for (size_t I = 0; I < entityCount; ++I)
+	{
+		const float3 position	= { distribution(rng), distribution(rng), distribution(rng) };
+		const float3 velocity	= { distribution(rng), distribution(rng), distribution(rng) };
+
+		basicObjects[I].AddView<BenchmarkPositionView>(position);
+		basicObjects[I].AddView<BenchmarkVelocityView>(velocity);
+		archetypeObjects[I].AddView<ArchetypePositionView>(position);
+		archetypeObjects[I].AddView<ArchetypeVelocityView>(velocity);
+	}
+
+	const double basicMS = BestOf(3,
+		[&]
+		{
+			for (size_t frame = 0; frame < frameCount; ++frame)
+			{
+				for (size_t I = 0; I < entityCount; ++I)
+				{
+					Apply(basicObjects[I],
+						[&](BenchmarkPositionView& position, BenchmarkVelocityView& velocity)
+						{
+							position.GetData() += velocity.GetData() * dt;
+						});
+				}
+			}
+		});
+
+	const double archetypeMS = BestOf(3,
+		[&]
+		{
+			for (size_t frame = 0; frame < frameCount; ++frame)
+			{
+				storage.QueryChunks(
+					[&](std::span<GameObject*>, std::span<float3> positions, std::span<const float3> velocities)
+					{
+						for (size_t row = 0; row < positions.size(); ++row)
+							positions[row] += velocities[row] * dt;
+					},
+					Mut<ArchetypePositionView>{}, ReadOnly<ArchetypeVelocityView>{});
+			}
+		});
+
+	// Both stores ran the same number of frames from the same start, so they have to agree
+	size_t mismatches = 0;
+	for (size_t I = 0; I < entityCount; ++I)
+	{
+		const float3 basic		= GetView<BenchmarkPositionView>(basicObjects[I]).GetData();
+		const float3 archetype	= GetView<ArchetypePositionView>(archetypeObjects[I]).GetData();
+
+		mismatches += (basic - archetype).magnitudeSq() > 1e-4f;
+	}
+
+	Expect(mismatches == 0, "archetype columns and the basic component store disagree");
+	Expect(storage.GetArchetypeCount() == 1, "position and velocity did not share an archetype");
+
+	fmt::print("    {:8} | integrate {} frames | basic store: {:7.2f} ms | archetype chunks: {:7.2f} ms | {:.2f}x\n",
+		entityCount, frameCount, basicMS, archetypeMS, basicMS / archetypeMS);
+
+	for (size_t I = 0; I < entityCount; ++I)
+	{
+		basicObjects[I].Release();
+		archetypeObjects[I].Release();
+	}
+
+	delete[] basicObjects;
+	delete[] archetypeObjects;
+}
+
+
+/************************************************************************************************/
+
+
+// Scene visibility now lives in an ArchetypeStorage, compares per handle lookups with a column walk
+static void VisibilityBenchmark(BenchmarkContext& ctx, const size_t entityCount)
+{
+	SceneVisibilityComponent visibility{ &ctx.allocator };
+
+	std::minstd_rand	rng{ uint32_t(entityCount) };
+	const SceneHandle	noScene = InvalidHandle;
+
+	GameObject*						objects = new GameObject[entityCount];
+	std::vector<VisibilityHandle>	handles;
+	std::vector<NodeHandle>			nodes;
+
+	handles.reserve(entityCount);
+	nodes.reserve(entityCount);
+
+	for (size_t I = 0; I < entityCount; ++I)
+	{
+		const NodeHandle node = GetZeroedNode();
+		nodes.push_back(node);
+
+		auto& view = objects[I].AddView<SceneVisibilityView>(node, noScene);
+		view.SetBoundingSphere({ 0, 0, 0, float(1 + rng() % 16) });
+
+		handles.push_back(view.visibility);
+	}
+
+	// Scene passes walk their entity lists in scene order, which is usually not storage order
+	std::shuffle(handles.begin(), handles.end(), rng);
+
+	float handleSum = 0.0f;
+	float columnSum = 0.0f;
+
+	const double handleMS = BestOf(5,
+		[&]
+		{
+			handleSum = 0.0f;
+
+			for (auto handle : handles)
+			{
+				const auto& fields = visibility[handle];
+				handleSum += fields.visable ? fields.boundingSphere.w : 0.0f;
+			}
+		});
+
+	const double columnMS = BestOf(5,
+		[&]
+		{
+			columnSum = 0.0f;
+
+			visibility.QueryChunks(
+				[&](std::span<GameObject*>, std::span<const VisibilityFields> column)
+				{
+					for (auto& fields : column)
+						columnSum += fields.visable ? fields.boundingSphere.w : 0.0f;
+				});
+		});
+
+	Expect(std::abs(handleSum - columnSum) <= 1e-3f * handleSum, "visibility column walk does not match the handle lookups");
+
+	fmt::print("    {:8} | visibility sweep | handle lookups: {:7.3f} ms | archetype chunks: {:7.3f} ms | {:.2f}x\n",
+		entityCount, handleMS, columnMS, handleMS / columnMS);
+
+	for (size_t I = 0; I < entityCount; ++I)
+		objects[I].Release();
+
+	delete[] objects;
+
+	for (auto node : nodes)
+		ReleaseNode(node);
+
+	UpdateTransforms();
+}
+
+
+/************************************************************************************************/
+
+
+// Visibility and positions on the same objects, sharing one storage. Objects move between three archetypes
+// as views come and go, every row has to stay with its object.
+static void SharedStorageCheck(BenchmarkContext& ctx)
+{
+	constexpr size_t objectCount = 1000;
+
+	ArchetypeStorage			storage{ &ctx.allocator };
+	SceneVisibilityComponent	visibility{ storage, &ctx.allocator };
+	ArchetypePositionComponent	positions{ storage, &ctx.allocator };
+
+	const SceneHandle		noScene = InvalidHandle;
+	GameObject*				objects = new GameObject[objectCount];
+	std::vector<NodeHandle>	nodes;
+
+	for (size_t I = 0; I < objectCount; ++I)
+	{
+		nodes.push_back(GetZeroedNode());
+
+		objects[I].AddView<SceneVisibilityView>(nodes.back(), noScene).SetBoundingSphere({ 0, 0, 0, float(I) });
+
+		if (I % 2)
+			objects[I].AddView<ArchetypePositionView>(float3{ float(I), 0.0f, 0.0f });
+	}
+
+	for (size_t I = 0; I < objectCount; I += 3)
+		objects[I].RemoveView(&GetView<SceneVisibilityView>(objects[I]));
+
+	size_t mismatches = 0;
+
+	for (size_t I = 0; I < objectCount; ++I)
+	{
+		auto& object = objects[I];
+
+		const bool hasVisibility	= I % 3 != 0;
+		const bool hasPosition		= I % 2 != 0;
+
+		if (hasVisibility)
+			mismatches += GetView<SceneVisibilityView>(object).GetBoundingSphere().w != float(I);
+
+		if (hasPosition)
+			mismatches += GetView<ArchetypePositionView>(object).GetData().x != float(I);
+
+		if (hasVisibility || hasPosition)
+			mismatches += object.archetypeStorage != &storage || !storage.Owns(object.archetypeEntity);
+		else
+			mismatches += object.archetypeStorage != nullptr || object.archetypeEntity != InvalidArchetypeEntity;
+	}
+
+	Expect(mismatches == 0, "archetype components sharing an object lost track of their rows");
+	Expect(storage.GetArchetypeCount() == 3, "shared storage did not split objects into visibility, position and both");
+
+	for (size_t I = 0; I < objectCount; ++I)
+		objects[I].Release();
+
+	delete[] objects;
+
+	for (auto node : nodes)
+		ReleaseNode(node);
+
+	UpdateTransforms();
+}
+
+
+/************************************************************************************************/
+
+
+void ArchetypeBenchmark(BenchmarkContext& ctx)
+{
+	SharedStorageCheck(ctx);
+
+	for (const size_t entityCount : { 10000, 100000 })
+	{
+		IntegrateBenchmark(ctx, entityCount);
+		VisibilityBenchmark(ctx, entityCount);
+	}
+}
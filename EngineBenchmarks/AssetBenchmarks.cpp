@@ -0,0 +1,400 @@
+#include "Benchmarks.h"
+
+#include <Assets.h>
+#include <Serialization.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+using namespace FlexKit;
+
+
+/************************************************************************************************/
+
+
+struct BenchmarkResource : public Resource
+{
+	BenchmarkResource(const size_t size, const GUID_t guid, const char* id)
+	{
+		ResourceSize	= size;
+		Type			= EResource_GameDB;
+		GUID			= guid;
+		State			= EResourceState_UNLOADED;
+		RefCount		= 0;
+
+		strncpy_s(ID, id, ID_LENGTH - 1);
+	}
+};
+
+
+// Fills a resource with the kind of low entropy data meshes and animations are made of, runs with small noise
+static std::vector<byte> CreateBenchmarkResource(const size_t size, const GUID_t guid, const char* id)
+{
+	std::vector<byte>	buffer(size);
+	std::minstd_rand	rng{ uint32_t(guid) };
+
+	uint32_t* words = reinterpret_cast<uint32_t*>(buffer.data());
+
+	for (size_t I = 0; I < size / sizeof(uint32_t); ++I)
+		words[I] = uint32_t(I / 16) ^ (rng() & 0x7);
+
+	new(buffer.data()) BenchmarkResource{ size, guid, id };
+
+	return buffer;
+}
+
+
+/************************************************************************************************/
+
+
+// Raw and block compressed reads of the same resource from a pack file, and offset reads through read contexts
+void ResourceReadBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t resourceSize	= 64 * MEGABYTE;
+	constexpr GUID_t rawGUID		= 0x1001;
+	constexpr GUID_t compressedGUID	= 0x1002;
+
+	const auto path			= (std::filesystem::temp_directory_path() / "FlexKitResourceBenchmark.gameres").string();
+	const auto badPath		= (std::filesystem::temp_directory_path() / "FlexKitResourceBenchmarkBadVersion.gameres").string();
+	const auto corruptPath	= (std::filesystem::temp_directory_path() / "FlexKitResourceBenchmarkCorrupt.gameres").string();
+	const auto resource		= CreateBenchmarkResource(resourceSize, rawGUID, "RawResource");
+
+	std::vector<byte> compressed;
+	Expect(CompressResource(resource.data(), resource.size(), compressed, &ctx.threads), "failed to compress the benchmark resource");
+
+	// Pack file with the same resource stored raw and compressed
+	auto WritePack =
+		[&](const char* file, const size_t version, const std::vector<byte>& compressedResource)
+		{
+			constexpr size_t tableSize = sizeof(ResourceTable) + 2 * sizeof(ResourceEntry);
+
+			alignas(ResourceTable) byte tableBuffer[tableSize] = {};
+			auto& table = *reinterpret_cast<ResourceTable*>(tableBuffer);
+
+			table.MagicNumber	= ResourceTableMagicNumber;
+			table.Version		= version;
+			table.ResourceCount	= 2;
+
+			table.Entries[0] = { rawGUID,			tableSize,					EResourceEncoding_Raw,				0, EResource_GameDB, "RawResource" };
+			table.Entries[1] = { compressedGUID,	tableSize + resource.size(),	EResourceEncoding_BlockCompressed,	0, EResource_GameDB, "CompressedResource" };
+
+			FILE* f = nullptr;
+			if (fopen_s(&f, file, "wb") || !f)
+				return false;
+
+			fwrite(tableBuffer, 1, tableSize, f);
+			fwrite(resource.data(), 1, resource.size(), f);
+			fwrite(compressedResource.data(), 1, compressedResource.size(), f);
+			fclose(f);
+
+			return true;
+		};
+
+	Expect(WritePack(path.c_str(), ResourceTableVersion, compressed), "failed to write the benchmark pack file");
+	Expect(WritePack(badPath.c_str(), ResourceTableVersion + 1, compressed), "failed to write the benchmark pack file");
+
+	InitiateAssetTable(&ctx.allocator, &ctx.threads);
+
+	FILE* f = nullptr;
+	fopen_s(&f, path.c_str(), "rb");
+
+	const size_t	tableSize	= ReadAssetTableSize(f);
+	ResourceTable*	table		= (ResourceTable*)ctx.allocator._aligned_malloc(tableSize);
+	Resource*		out			= (Resource*)ctx.allocator._aligned_malloc(resourceSize);
+
+	Expect(ReadAssetTable(f, table, tableSize), "failed to read the benchmark pack's table");
+
+	bool rawRead		= true;
+	bool compressedRead	= true;
+
+	const double rawMS			= BestOf(3, [&] { rawRead &= ReadResource(f, table, 0, out); });
+	const bool	 rawMatches		= memcmp(out, resource.data(), resourceSize) == 0;
+
+	memset(out, 0, resourceSize);
+
+	const double compressedMS		= BestOf(3, [&] { compressedRead &= ReadResource(f, table, 1, out); });
+	const bool	 compressedMatches	= memcmp(out, resource.data(), resourceSize) == 0;
+
+	// Serial decode of the blocks already in memory, what a single thread could do without any IO
+	const double decodeMS = BestOf(3,
+		[&]
+		{
+			CompressedResourceHeader header;
+			memcpy(&header, compressed.data(), sizeof(header));
+
+			for (size_t I = 0; I < header.BlockCount; ++I)
+			{
+				CompressedResourceBlock block;
+				memcpy(&block, compressed.data() + sizeof(header) + I * sizeof(block), sizeof(block));
+
+				const size_t outOffset = I * header.BlockSize;
+				DecompressBlock(compressed.data() + block.Offset, block.CompressedSize, (byte*)out + outOffset, Min(size_t(header.BlockSize), resourceSize - outOffset));
+			}
+		});
+
+	fclose(f);
+
+	Expect(rawRead && rawMatches, "raw resource read does not match what was written");
+	Expect(compressedRead && compressedMatches, "compressed resource read does not match what was written");
+
+	const auto MBps = [&](const double ms) { return double(resourceSize) / double(MEGABYTE) / (ms / 1000.0); };
+
+	fmt::print("    {} MB resource, {:.2f}x compression\n", resourceSize / MEGABYTE, double(resourceSize) / double(compressed.size()));
+	fmt::print("    raw read: {:.0f} MB/s | compressed read: {:.0f} MB/s | serial decode: {:.0f} MB/s\n",
+		MBps(rawMS), MBps(compressedMS), MBps(decodeMS));
+
+	// Offset reads of a compressed resource decompress a private copy that goes away with the context
+	AddAssetFile(path.c_str());
+
+	constexpr size_t readSize	= MEGABYTE;
+	constexpr size_t readOffset	= resourceSize / 2;
+
+	std::vector<byte>	read(readSize);
+	size_t				mismatches = 0;
+
+	const double contextMS = BestOf(3,
+		[&]
+		{
+			ReadContext context = OpenReadContext(compressedGUID);
+			ReadAsset(context, compressedGUID, read.data(), readSize, readOffset);
+
+			mismatches += memcmp(read.data(), resource.data() + readOffset, readSize) != 0;
+		});
+
+	Expect(mismatches == 0, "offset reads of a compressed resource do not match");
+
+	fmt::print("    open + 1 MB offset read + close of the compressed resource: {:.2f} ms\n", contextMS);
+
+	// Tables from a newer packer have to be rejected rather than misread
+	fopen_s(&f, badPath.c_str(), "rb");
+
+	if (f)
+	{
+		const size_t	badTableSize	= ReadAssetTableSize(f);
+		ResourceTable*	badTable		= (ResourceTable*)ctx.allocator._aligned_malloc(badTableSize);
+
+		Expect(!ReadAssetTable(f, badTable, badTableSize), "a resource table with an unknown version was accepted");
+
+		ctx.allocator._aligned_free(badTable);
+		fclose(f);
+	}
+
+	// Corrupt block tables have to fail the read before any block is decompressed into out
+	auto ReadCorrupt =
+		[&](auto&& corrupt)
+		{
+			std::vector<byte> corrupted = compressed;
+			corrupt(corrupted);
+
+			if (!WritePack(corruptPath.c_str(), ResourceTableVersion, corrupted))
+				return true;
+
+			FILE* corruptFile = nullptr;
+			fopen_s(&corruptFile, corruptPath.c_str(), "rb");
+
+			if (!corruptFile)
+				return true;
+
+			const bool read = ReadResource(corruptFile, table, 1, out);
+			fclose(corruptFile);
+
+			return read;
+		};
+
+	auto EditHeader =
+		[](std::vector<byte>& data, auto&& edit)
+		{
+			CompressedResourceHeader header;
+			memcpy(&header, data.data(), sizeof(header));
+			edit(header);
+			memcpy(data.data(), &header, sizeof(header));
+		};
+
+	auto EditBlock =
+		[](std::vector<byte>& data, const size_t I, auto&& edit)
+		{
+			CompressedResourceBlock block;
+			byte* entry = data.data() + sizeof(CompressedResourceHeader) + I * sizeof(block);
+
+			memcpy(&block, entry, sizeof(block));
+			edit(block);
+			memcpy(entry, &block, sizeof(block));
+		};
+
+	const bool extraBlock		= ReadCorrupt([&](auto& data) { EditHeader(data, [](auto& header) { header.BlockCount++; }); });
+	const bool grownResource	= ReadCorrupt([&](auto& data) { EditHeader(data, [](auto& header) { header.ResourceSize += header.BlockSize; }); });
+	const bool blockPastEnd		= ReadCorrupt([&](auto& data) { EditBlock(data, 1, [](auto& block) { block.CompressedSize = resourceSize * 4; }); });
+	const bool blocksOverlap	= ReadCorrupt([&](auto& data) { EditBlock(data, 2, [](auto& block) { block.Offset -= 16; }); });
+	const bool truncated		= ReadCorrupt([&](auto& data) { data.resize(data.size() / 2); });
+
+	Expect(!extraBlock && !grownResource, "a block table that does not tile the resource was accepted");
+	Expect(!blockPastEnd && !blocksOverlap && !truncated, "a block table with out of range blocks was accepted");
+
+	ctx.allocator._aligned_free(table);
+	ctx.allocator._aligned_free(out);
+
+	ReleaseAssetTable();
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(badPath);
+	std::filesystem::remove(corruptPath);
+}
+
+
+/************************************************************************************************/
+
+
+// GUID and string ID lookups through the asset indices, against the linear scans over every table entry they replaced
+void AssetLookupBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t entryCount		= 100000;
+	constexpr size_t loadedCount	= 10000;
+	constexpr size_t lookupCount	= 100000;
+
+	const auto path = (std::filesystem::temp_directory_path() / "FlexKitLookupBenchmark.gameres").string();
+
+	std::minstd_rand			rng{ 2024 };
+	std::vector<ResourceEntry>	entries(entryCount);
+
+	// Scattered GUIDs, the packer sorts entries by GUID
+	for (size_t I = 0; I < entryCount; ++I)
+	{
+		entries[I]			= { (GUID_t(rng()) << 32) | GUID_t(I), 0, EResourceEncoding_Raw, 0, EResource_GameDB };
+		entries[I].GUID		|= GUID_t(1) << 63;
+
+		snprintf(entries[I].ID, ID_LENGTH, "Assets/Meshes/Benchmark_%zu", I);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](auto& lhs, auto& rhs) { return lhs.GUID < rhs.GUID; });
+
+	{
+		alignas(ResourceTable) byte tableBuffer[sizeof(ResourceTable)] = {};
+		auto& table = *reinterpret_cast<ResourceTable*>(tableBuffer);
+
+		table.MagicNumber	= ResourceTableMagicNumber;
+		table.Version		= ResourceTableVersion;
+		table.ResourceCount	= entryCount;
+
+		FILE* f = nullptr;
+		if (!fopen_s(&f, path.c_str(), "wb") && f)
+		{
+			fwrite(tableBuffer, 1, sizeof(tableBuffer), f);
+			fwrite(entries.data(), sizeof(ResourceEntry), entries.size(), f);
+			fclose(f);
+		}
+	}
+
+	InitiateAssetTable(&ctx.allocator, &ctx.threads);
+
+	const double addFileMS = BestOf(1, [&] { AddAssetFile(path.c_str()); });
+
+	// Resources added at runtime land in the loaded indices
+	const double addLoadedMS = BestOf(1,
+		[&]
+		{
+			for (size_t I = 0; I < loadedCount; ++I)
+			{
+				auto resource = new(ctx.allocator.malloc(sizeof(BenchmarkResource))) BenchmarkResource{ sizeof(BenchmarkResource), GUID_t(I + 1), "" };
+				snprintf(resource->ID, ID_LENGTH, "Runtime/Benchmark_%zu", I);
+
+				AddAssetBuffer(resource);
+			}
+		});
+
+	std::vector<size_t> lookups(lookupCount);
+	for (auto& lookup : lookups)
+		lookup = rng() % entryCount;
+
+	size_t guidFound	= 0;
+	size_t idFound		= 0;
+	size_t scanFound	= 0;
+
+	const double guidMS = BestOf(3,
+		[&]
+		{
+			guidFound = 0;
+
+			for (auto lookup : lookups)
+				guidFound += GetResourceStringID(entries[lookup].GUID) != nullptr;
+		});
+
+	const double idMS = BestOf(3,
+		[&]
+		{
+			idFound = 0;
+
+			for (auto lookup : lookups)
+				idFound += FindAssetGUID(entries[lookup].ID) == entries[lookup].GUID;
+		});
+
+	size_t loadedFound = 0;
+
+	const double loadedMS = BestOf(3,
+		[&]
+		{
+			loadedFound = 0;
+
+			for (size_t I = 0; I < lookupCount; ++I)
+				loadedFound += isAssetAvailable(GUID_t(I % loadedCount + 1));
+		});
+
+	// Misses have to stop at the first empty slot instead of walking everything
+	size_t falseHits = 0;
+
+	const double missMS = BestOf(3,
+		[&]
+		{
+			falseHits = 0;
+
+			for (size_t I = 0; I < lookupCount; ++I)
+				falseHits += GetResourceStringID(GUID_t(I) << 40 | 0xFFFF) != nullptr;
+		});
+
+	// What every lookup used to cost, only a slice of the lookups since a full scan each is slow
+	const size_t scanCount = lookupCount / 100;
+
+	const double scanMS = BestOf(1,
+		[&]
+		{
+			for (size_t I = 0; I < scanCount; ++I)
+			{
+				const auto& target = entries[lookups[I]];
+
+				for (auto& entry : entries)
+				{
+					if (!strncmp(entry.ID, target.ID, ID_LENGTH))
+					{
+						scanFound++;
+						break;
+					}
+				}
+			}
+		}) * double(lookupCount / scanCount);
+
+	Expect(guidFound == lookupCount && idFound == lookupCount, "indexed lookups missed table entries");
+	Expect(loadedFound == lookupCount, "indexed lookups missed loaded resources");
+	Expect(falseHits == 0, "indexed lookups found GUIDs that were never added");
+	Expect(scanFound == scanCount, "linear scan missed table entries");
+
+	fmt::print("    {} table entries, {} loaded | add file: {:.2f} ms | add loaded: {:.2f} ms\n", entryCount, loadedCount, addFileMS, addLoadedMS);
+	fmt::print("    {} lookups | GUID: {:.2f} ms | string ID: {:.2f} ms | loaded GUID: {:.2f} ms | misses: {:.2f} ms | linear scan by ID (estimated): {:.0f} ms\n",
+		lookupCount, guidMS, idMS, loadedMS, missMS, scanMS);
+
+	Expect(idMS * 10 < scanMS, "indexed string ID lookups are not much faster than a linear scan");
+
+	// A second copy of a loaded GUID is dropped in favour of the resident one
+	{
+		const AssetHandle	resident	= LoadGameAsset(GUID_t(1));
+		const uint32_t		refCount	= GetAsset(resident)->RefCount;
+		auto				duplicate	= new(malloc(sizeof(BenchmarkResource))) BenchmarkResource{ sizeof(BenchmarkResource), GUID_t(1), "" };
+
+		Expect(AddAssetBuffer(duplicate) == resident, "re-adding a loaded GUID did not return the resident handle");
+		Expect(GetAsset(resident)->RefCount == refCount + 2, "re-adding a loaded GUID did not reference the resident copy");
+	}
+
+	ReleaseAssetTable();
+
+	std::filesystem::remove(path);
+}
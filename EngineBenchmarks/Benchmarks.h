@@ -0,0 +1,89 @@
+#pragma once
+
+#include <buildsettings.h>
+#include <EngineCore.h>
+#include <ThreadUtilities.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+
+/************************************************************************************************/
+
+
+struct BenchmarkContext
+{
+	FlexKit::EngineMemory&	memory;
+	FlexKit::ThreadManager&	threads;
+	FlexKit::iAllocator&	allocator;
+};
+
+
+using BenchmarkFN = void (*)(BenchmarkContext&);
+
+struct Benchmark
+{
+	const char*	name;
+	BenchmarkFN	fn;
+};
+
+
+/************************************************************************************************/
+
+
+inline bool benchmarkFailed = false;
+
+// Benchmarks double as regression checks, a failed expectation fails the whole run
+inline bool Expect(const bool condition, const char* description)
+{
+	if (!condition)
+	{
+		fmt::print("    FAILED: {}\n", description);
+		benchmarkFailed = true;
+	}
+
+	return condition;
+}
+
+
+// Returns the fastest of count runs in milliseconds
+template<typename FN>
+double BestOf(const size_t count, FN&& fn)
+{
+	double best = std::numeric_limits<double>::max();
+
+	for (size_t I = 0; I < count; ++I)
+	{
+		const auto begin	= std::chrono::high_resolution_clock::now();
+		fn();
+		const auto end		= std::chrono::high_resolution_clock::now();
+
+		best = std::min(best, std::chrono::duration<double, std::milli>(end - begin).count());
+	}
+
+	return best;
+}
+
+
+/************************************************************************************************/
+
+
+void AllocatorBenchmark(BenchmarkContext&);
+void TransformBenchmark(BenchmarkContext&);
+void SceneNodeStressTest(BenchmarkContext&);
+void SceneBVHRefitBenchmark(BenchmarkContext&);
+void SceneBVHBuildBenchmark(BenchmarkContext&);
+void ArchetypeBenchmark(BenchmarkContext&);
+void IdlePolicyBenchmark(BenchmarkContext&);
+void ThreadScalingBenchmark(BenchmarkContext&);
+void NestedParallelForBenchmark(BenchmarkContext&);
+void ParallelForBenchmark(BenchmarkContext&);
+void ArchiveLoadBenchmark(BenchmarkContext&);
+void ResourceReadBenchmark(BenchmarkContext&);
+void AssetLookupBenchmark(BenchmarkContext&);
+void TraceOverheadBenchmark(BenchmarkContext&);
+void AnimationSamplingBenchmark(BenchmarkContext&);
+void AnimationCompressionBenchmark(BenchmarkContext&);
+void PoseUpdateBenchmark(BenchmarkContext&);
@@ -0,0 +1,133 @@
+#include "Benchmarks.h"
+
+#include <ProfilingUtilities.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace FlexKit;
+
+
+/************************************************************************************************/
+
+
+// Small enough body that the scope cost dominates, large enough that the loop isn't folded away
+inline uint64_t ScopeBody(const uint64_t I, const uint64_t sum) noexcept
+{
+	return (sum ^ I) * 0x9E3779B97F4A7C15ull + (sum >> 29);
+}
+
+
+void TraceOverheadBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t scopeCount = 100000;
+
+	uint64_t bareSum	= 0;
+	uint64_t idleSum	= 0;
+	uint64_t traceSum	= 0;
+
+	const double bareMS = BestOf(5,
+		[&]
+		{
+			bareSum = 0;
+
+			for (uint64_t I = 0; I < scopeCount; ++I)
+				bareSum = ScopeBody(I, bareSum);
+		});
+
+	// Scopes left in while nothing is recording only pay for the recording check
+	const double idleMS = BestOf(5,
+		[&]
+		{
+			idleSum = 0;
+
+			for (uint64_t I = 0; I < scopeCount; ++I)
+			{
+				_TraceScope scope{ "TraceOverhead" };
+				idleSum = ScopeBody(I, idleSum);
+			}
+		});
+
+	// Rings hold no storage until their thread traces while recording
+	{
+		TraceRingBuffer ring;
+		const bool idleUnallocated = !ring.IsAllocated();
+
+		ring.Push({ ReadTraceTimestamp(), "TraceOverhead" });
+
+		Expect(idleUnallocated && ring.IsAllocated(), "trace ring storage allocated before its first event");
+	}
+
+	tracer.Start();
+
+	const double traceMS = BestOf(5,
+		[&]
+		{
+			traceSum = 0;
+
+			for (uint64_t I = 0; I < scopeCount; ++I)
+			{
+				_TraceScope scope{ "TraceOverhead" };
+				traceSum = ScopeBody(I, traceSum);
+			}
+		});
+
+	// Labels go into the JSON as is, these have to come out escaped
+	{
+		_TraceScope scope{ "Quote\"Back\\Slash" };
+	}
+
+	tracer.Stop();
+
+	Expect(bareSum == idleSum && bareSum == traceSum, "trace scopes changed the loop results");
+
+	const auto path = (std::filesystem::temp_directory_path() / "FlexKitTraceBenchmark.json").string();
+	Expect(tracer.ExportChromeTrace(path.c_str()), "failed to export the trace");
+
+	{
+		std::ifstream		file{ path };
+		std::stringstream	contents;
+		contents << file.rdbuf();
+
+		Expect(contents.str().find(R"("name":"Quote\"Back\\Slash")") != std::string::npos, "trace labels were not escaped");
+	}
+
+	std::filesystem::remove(path);
+	tracer.Clear();
+
+	auto PerScopeNS = [&](const double ms) { return Max(ms - bareMS, 0.0) * 1000000.0 / double(scopeCount); };
+
+	fmt::print("    {} scopes | bare loop: {:.3f} ms | trace idle: {:.1f} ns/scope | trace recording: {:.1f} ns/scope\n",
+		scopeCount, bareMS, PerScopeNS(idleMS), PerScopeNS(traceMS));
+
+#if USING(ENABLEPROFILER)
+	// The per frame profiler only runs while its window is drawn, compare against it when it is on
+	uint64_t	frameSum		= 0;
+	const bool	frameProfiling	= profiler.IsFrameProfiling();
+
+	profiler.frameProfiling = true;
+
+	const double frameMS = BestOf(5,
+		[&]
+		{
+			profiler.GetThreadProfiler().Clear();
+			frameSum = 0;
+
+			for (uint64_t I = 0; I < scopeCount; ++I)
+			{
+				_ProfileFunction scope{ "TraceOverhead", 0 };
+				frameSum = ScopeBody(I, frameSum);
+			}
+		});
+
+	profiler.GetThreadProfiler().Clear();
+	profiler.frameProfiling = frameProfiling;
+
+	Expect(frameSum == bareSum, "profiled scopes changed the loop results");
+	Expect(traceMS < frameMS, "recording trace scopes is not cheaper than the per frame profiler");
+
+	fmt::print("    frame profiler: {:.1f} ns/scope\n", PerScopeNS(frameMS));
+#endif
+}
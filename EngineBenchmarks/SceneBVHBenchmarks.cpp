@@ -0,0 +1,257 @@
+#include "Benchmarks.h"
+
+#include <Scene.h>
+#include <Transforms.h>
+
+#include <random>
+#include <vector>
+
+using namespace FlexKit;
+
+
+/************************************************************************************************/
+
+
+// Entities scattered through a cube, each with its own scene node directly under the root
+struct BenchmarkScene
+{
+	BenchmarkScene(iAllocator& allocator, const size_t entityCount, const uint32_t seed) :
+		scene	{ &allocator },
+		objects	{ new GameObject[entityCount] },
+		rng		{ seed }
+	{
+		nodes.reserve(entityCount);
+
+		for (size_t I = 0; I < entityCount; ++I)
+		{
+			const NodeHandle node = GetZeroedNode();
+			SetPositionL(node, RandomPosition());
+
+			scene.AddGameObject(objects[I], node);
+			SetBoundingSphere(objects[I], { 0, 0, 0, 1.0f });
+
+			nodes.push_back(node);
+		}
+	}
+
+	~BenchmarkScene()
+	{
+		scene.ClearScene();
+		delete[] objects;
+
+		for (auto node : nodes)
+			ReleaseNode(node);
+
+		UpdateTransforms();
+	}
+
+	float3 RandomPosition()
+	{
+		constexpr float extent = 1000.0f;
+		std::uniform_real_distribution<float> distribution{ -extent, extent };
+
+		return { distribution(rng), distribution(rng), distribution(rng) };
+	}
+
+	// Looks for the entity with a tiny box at point, only hits if its bounds in the BVH cover point
+	bool Contains(const SceneBVH& bvh, const size_t entity, const float3 point)
+	{
+		const VisibilityHandle	handle	= scene.sceneEntities[entity];
+		const AABB				query	= { point - 0.01f, point + 0.01f };
+		bool					found	= false;
+
+		bvh.Traverse(query,
+			[&](VisibilityHandle visibility, auto&, auto&)
+			{
+				found |= visibility == handle;
+			});
+
+		return found;
+	}
+
+	Scene					scene;
+	GameObject*				objects;
+	std::vector<NodeHandle>	nodes;
+	std::minstd_rand		rng;
+};
+
+
+/************************************************************************************************/
+
+
+void SceneBVHRefitBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t movedCount		= 256;
+	constexpr size_t resizedCount	= 64;
+
+	SceneVisibilityComponent visibility{ &ctx.allocator };
+
+	fmt::print("    entities | full build | refit {} moved | refit {} resized\n", movedCount, resizedCount);
+
+	for (const size_t entityCount : { 10000, 100000 })
+	{
+		BenchmarkScene benchmarkScene{ ctx.allocator, entityCount, uint32_t(entityCount) };
+		auto& scene = benchmarkScene.scene;
+
+		UpdateTransforms(ctx.threads, ctx.allocator);
+
+		SceneBVH	bvh;
+		const double buildMS = BestOf(3, [&] { bvh = SceneBVH::Build(scene, ctx.threads, ctx.allocator); });
+
+		// Small moves, refit time should follow the moved count rather than the scene size
+		std::uniform_real_distribution<float>	jitter{ -5.0f, 5.0f };
+		std::vector<size_t>						moved;
+		bool									refitted = true;
+
+		const double refitMS = BestOf(5,
+			[&]
+			{
+				moved.clear();
+
+				for (size_t I = 0; I < movedCount; ++I)
+				{
+					const size_t entity = benchmarkScene.rng() % entityCount;
+					const NodeHandle node = benchmarkScene.nodes[entity];
+
+					SetPositionL(node, GetPositionL(node) + float3{ jitter(benchmarkScene.rng), jitter(benchmarkScene.rng), jitter(benchmarkScene.rng) });
+					moved.push_back(entity);
+				}
+
+				UpdateTransforms(ctx.threads, ctx.allocator);
+				refitted &= bvh.Refit(scene, ctx.allocator);
+			});
+
+		size_t missed = 0;
+		for (const auto entity : moved)
+			missed += !benchmarkScene.Contains(bvh, entity, GetPositionW(benchmarkScene.nodes[entity]));
+
+		Expect(refitted, "refit fell back to a rebuild after a small number of moves");
+		Expect(missed == 0, "refit missed moved entities");
+
+		// Bounds only changes, nothing moves but the spheres grow
+		std::vector<size_t> resized;
+
+		const double resizeMS = BestOf(1,
+			[&]
+			{
+				for (size_t I = 0; I < resizedCount; ++I)
+				{
+					const size_t entity = benchmarkScene.rng() % entityCount;
+					SetBoundingSphere(benchmarkScene.objects[entity], { 0, 0, 0, 10.0f });
+					resized.push_back(entity);
+				}
+
+				UpdateTransforms(ctx.threads, ctx.allocator);
+				bvh.Refit(scene, ctx.allocator);
+			});
+
+		missed = 0;
+		for (const auto entity : resized)
+			missed += !benchmarkScene.Contains(bvh, entity, GetPositionW(benchmarkScene.nodes[entity]) + float3{ 9.0f, 0.0f, 0.0f });
+
+		Expect(missed == 0, "refit missed bounding sphere changes");
+
+		// Two transform updates between refits, the first update's moves must still reach the refit
+		auto MoveEntity =
+			[&]
+			{
+				const size_t		entity	= benchmarkScene.rng() % entityCount;
+				const NodeHandle	node	= benchmarkScene.nodes[entity];
+
+				SetPositionL(node, GetPositionL(node) + float3{ 20.0f, 0.0f, 0.0f });
+				return entity;
+			};
+
+		auto ContainsMoved =
+			[&](const size_t entity)
+			{
+				return benchmarkScene.Contains(bvh, entity, GetPositionW(benchmarkScene.nodes[entity]));
+			};
+
+		size_t firstMoved = MoveEntity();
+		UpdateTransforms(ctx.threads, ctx.allocator);
+
+		size_t secondMoved = MoveEntity();
+		UpdateTransforms(ctx.threads, ctx.allocator);
+
+		refitted = bvh.Refit(scene, ctx.allocator);
+
+		Expect(refitted, "refit fell back to a rebuild after two transform updates");
+		Expect(ContainsMoved(firstMoved) && ContainsMoved(secondMoved), "refit lost moves from a transform update before the last one");
+
+		// Another hierarchy consuming the list in between, this one must not lose the moves it has not seen
+		SceneBVH other = SceneBVH::Build(scene, ctx.allocator);
+
+		firstMoved = MoveEntity();
+		UpdateTransforms(ctx.threads, ctx.allocator);
+		other.Refit(scene, ctx.allocator);
+
+		secondMoved = MoveEntity();
+		UpdateTransforms(ctx.threads, ctx.allocator);
+
+		if (!bvh.Refit(scene, ctx.allocator))
+			bvh = SceneBVH::Build(scene, ctx.allocator);
+
+		Expect(ContainsMoved(firstMoved) && ContainsMoved(secondMoved), "refit lost moves consumed by another hierarchy");
+
+		fmt::print("    {:8} | {:7.3f} ms | {:10.3f} ms | {:10.3f} ms\n", entityCount, buildMS, refitMS, resizeMS);
+	}
+}
+
+
+/************************************************************************************************/
+
+
+void SceneBVHBuildBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t rayCount = 1024;
+
+	SceneVisibilityComponent visibility{ &ctx.allocator };
+
+	fmt::print("    entities | serial Morton | parallel Morton | speedup | binned SAH | SAH/Morton node area\n");
+
+	for (const size_t entityCount : { 10000, 100000, 1000000 })
+	{
+		BenchmarkScene benchmarkScene{ ctx.allocator, entityCount, uint32_t(entityCount) };
+		auto& scene = benchmarkScene.scene;
+
+		UpdateTransforms(ctx.threads, ctx.allocator);
+
+		const size_t runs = entityCount < 1000000 ? 5 : 2;
+
+		SceneBVH serial;
+		SceneBVH parallel;
+		SceneBVH sah;
+
+		const double serialMS	= BestOf(runs, [&] { serial		= SceneBVH::Build(scene, ctx.allocator); });
+		const double parallelMS	= BestOf(runs, [&] { parallel	= SceneBVH::Build(scene, ctx.threads, ctx.allocator); });
+		const double sahMS		= BestOf(runs, [&] { sah		= SceneBVH::BuildSAH(scene, ctx.allocator); });
+
+		Expect(serial.elements.size() == entityCount && parallel.elements.size() == entityCount && sah.elements.size() == entityCount,
+			"a builder dropped entities");
+
+		// Every builder has to agree on the closest hit
+		size_t mismatches = 0;
+
+		for (size_t I = 0; I < rayCount; ++I)
+		{
+			const float3	origin	= benchmarkScene.RandomPosition();
+			const float3	target	= GetPositionW(benchmarkScene.nodes[benchmarkScene.rng() % entityCount]);
+			const Ray		ray		= { (target - origin).normal(), origin };
+
+			const auto serialHit	= serial.RayCastClosest(ray, ctx.allocator);
+			const auto parallelHit	= parallel.RayCastClosest(ray, ctx.allocator);
+			const auto sahHit		= sah.RayCastClosest(ray, ctx.allocator);
+
+			if (!serialHit || !parallelHit || !sahHit)
+				mismatches += serialHit.has_value() + parallelHit.has_value() + sahHit.has_value() != 0;
+			else
+				mismatches += std::abs(serialHit->d - parallelHit->d) > 1e-3f || std::abs(serialHit->d - sahHit->d) > 1e-3f;
+		}
+
+		Expect(mismatches == 0, "builders disagree on closest hits");
+
+		fmt::print("    {:8} | {:10.2f} ms | {:12.2f} ms | {:6.2f}x | {:7.2f} ms | {:.2f}\n",
+			entityCount, serialMS, parallelMS, serialMS / parallelMS, sahMS, sah.buildCost / serial.buildCost);
+	}
+}
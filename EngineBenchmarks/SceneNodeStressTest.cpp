@@ -0,0 +1,99 @@
+#include "Benchmarks.h"
+
+#include <Scene.h>
+#include <Transforms.h>
+
+#include <random>
+#include <vector>
+
+using namespace FlexKit;
+
+
+/************************************************************************************************/
+
+
+// Creates and updates a million scene nodes, well past the old 16-bit index limit
+void SceneNodeStressTest(BenchmarkContext& ctx)
+{
+	constexpr size_t nodeCount	= 1000000;
+	constexpr size_t dirtyCount	= nodeCount / 100;
+
+	std::minstd_rand		rng{ 4096 };
+	std::vector<NodeHandle>	nodes;
+	std::vector<float3>		expected;
+
+	nodes.reserve(nodeCount);
+	expected.reserve(nodeCount);
+
+	const double createMS = BestOf(1,
+		[&]
+		{
+			for (size_t I = 0; I < nodeCount; ++I)
+			{
+				const NodeHandle	node	= GetZeroedNode();
+				const float3		offset	= { float(rng() % 8), 1.0f, 0.0f };
+
+				SetPositionL(node, offset);
+
+				// Parents are picked from a window of recent nodes, giving a deep and wide hierarchy
+				if (I > 0)
+				{
+					const size_t parent = I - 1 - rng() % Min(I, size_t(4096));
+
+					SetParentNode(nodes[parent], node);
+					expected.push_back(expected[parent] + offset);
+				}
+				else
+					expected.push_back(offset);
+
+				nodes.push_back(node);
+			}
+		});
+
+	const double layoutMS	= BestOf(1, [&] { UpdateTransforms(ctx.threads, ctx.allocator); });
+	const double idleMS		= BestOf(5, [&] { UpdateTransforms(ctx.threads, ctx.allocator); });
+
+	// Dirty roots of the hierarchy, updates ripple through every level below them
+	const double dirtyMS = BestOf(5,
+		[&]
+		{
+			for (size_t I = 0; I < dirtyCount; ++I)
+				SetFlag(nodes[rng() % nodes.size()], SceneNodes::DIRTY);
+
+			UpdateTransforms(ctx.threads, ctx.allocator);
+		});
+
+	const double allDirtyMS = BestOf(3,
+		[&]
+		{
+			for (auto node : nodes)
+				SetFlag(node, SceneNodes::DIRTY);
+
+			UpdateTransforms(ctx.threads, ctx.allocator);
+		});
+
+	const size_t bytesPerNode =
+		sizeof(Node) + sizeof(LT_Entry) + sizeof(WT_Entry) + sizeof(char) + 2 * sizeof(uint32_t);
+
+	fmt::print("    {} nodes, {} levels, {} bytes per node, {} byte BVH nodes\n",
+		nodeCount, SceneNodeTable.LevelFlags.size(), bytesPerNode, sizeof(SceneBVH::BVHNode));
+	fmt::print("    create: {:.1f} ms | layout: {:.1f} ms | idle update: {:.3f} ms | 1% dirty: {:.2f} ms | all dirty: {:.2f} ms\n",
+		createMS, layoutMS, idleMS, dirtyMS, allDirtyMS);
+
+	Expect(SceneNodeTable.size() > std::numeric_limits<uint16_t>::max(), "node table did not grow past 16-bit indices");
+
+	size_t mismatches = 0;
+	for (size_t I = 0; I < nodeCount; I += 31)
+	{
+		const float3 error = GetPositionW(nodes[I]) - expected[I];
+		mismatches += error.magnitudeSq() > 1e-2f;
+	}
+
+	Expect(mismatches == 0, "world transforms above the 16-bit index range are wrong");
+
+	for (auto node : nodes)
+		ReleaseNode(node);
+
+	UpdateTransforms(ctx.threads, ctx.allocator);
+	UpdateTransforms(ctx.threads, ctx.allocator);
+}
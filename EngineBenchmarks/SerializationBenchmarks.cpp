@@ -0,0 +1,181 @@
+#include "Benchmarks.h"
+
+#include <Serialization.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace FlexKit;
+
+
+/************************************************************************************************/
+
+
+struct ArchiveVertex
+{
+	float position[3];
+	float uv[2];
+};
+
+
+// Loaded either copied into vectors or as views into a mapped file, both read the same bytes
+template<template<typename> typename TY_Array>
+struct BenchmarkArchive
+{
+	TY_Array<ArchiveVertex>		vertices;
+	TY_Array<uint32_t>			indices;
+	std::vector<std::string>	names;
+
+	void Serialize(auto& ar)
+	{
+		ar& vertices;
+		ar& indices;
+		ar& names;
+	}
+
+	uint64_t Checksum() const
+	{
+		uint64_t sum = std::accumulate(indices.begin(), indices.end(), uint64_t(0));
+
+		for (size_t I = 0; I < vertices.size(); I += 4099)
+			sum += uint64_t(vertices[I].position[0]);
+
+		return sum + names.size();
+	}
+};
+
+template<typename TY> using CopiedArray	= std::vector<TY>;
+template<typename TY> using ViewArray	= std::span<const TY>;
+
+
+/************************************************************************************************/
+
+
+void ArchiveLoadBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t vertexCount	= 8 * 1024 * 1024;
+	constexpr size_t indexCount		= 3 * vertexCount / 2;
+	constexpr size_t nameCount		= 4096;
+
+	const auto path		= (std::filesystem::temp_directory_path() / "FlexKitArchiveBenchmark.bin").string();
+	const auto cutPath	= (std::filesystem::temp_directory_path() / "FlexKitArchiveBenchmarkTruncated.bin").string();
+
+	uint64_t expected = 0;
+
+	{
+		BenchmarkArchive<CopiedArray> archive;
+		archive.vertices.resize(vertexCount);
+		archive.indices.resize(indexCount);
+
+		for (size_t I = 0; I < vertexCount; ++I)
+			archive.vertices[I] = { { float(I % 1024), 0.0f, 1.0f }, { 0.5f, 0.5f } };
+
+		std::iota(archive.indices.begin(), archive.indices.end(), 0u);
+
+		for (size_t I = 0; I < nameCount; ++I)
+			archive.names.push_back(fmt::format("Resource_{}", I));
+
+		expected = archive.Checksum();
+
+		SaveArchiveContext save{ StreamedArchive{} };
+		save& archive;
+
+		auto f = fopen(path.c_str(), "wb");
+		Expect(f && save.WriteToFile(f), "failed to write the benchmark archive");
+
+		if (f)
+			fclose(f);
+	}
+
+	const double sizeMB = double(std::filesystem::file_size(path)) / double(MEGABYTE);
+
+	uint64_t fileSum	= 0;
+	uint64_t copySum	= 0;
+	uint64_t viewSum	= 0;
+
+	const double fileMS = BestOf(3,
+		[&]
+		{
+			auto f = fopen(path.c_str(), "rb");
+			if (!f)
+				return;
+
+			// Closes the file once done
+			BenchmarkArchive<CopiedArray>	archive;
+			LoadFileArchiveContext			load{ f };
+
+			load& archive;
+			fileSum = archive.Checksum();
+		});
+
+	const double copyMS = BestOf(3,
+		[&]
+		{
+			BenchmarkArchive<CopiedArray>	archive;
+			LoadMappedArchiveContext		load{ path.c_str() };
+
+			load& archive;
+			copySum = load.Failed() ? 0 : archive.Checksum();
+		});
+
+	const double viewMS = BestOf(3,
+		[&]
+		{
+			BenchmarkArchive<ViewArray>	archive;
+			LoadMappedArchiveContext	load{ path.c_str() };
+
+			load& archive;
+			viewSum = load.Failed() ? 0 : archive.Checksum();
+		});
+
+	Expect(fileSum == expected && copySum == expected && viewSum == expected, "loaded archives do not match what was written");
+
+	fmt::print("    {:.0f} MB archive | file reads: {:.2f} ms | mapped copy: {:.2f} ms | mapped views: {:.2f} ms\n",
+		sizeMB, fileMS, copyMS, viewMS);
+
+	Expect(viewMS < copyMS, "mapped views are not cheaper than copying out of the mapping");
+
+	// Truncated archives have to fail the load instead of reading past the end of the mapping
+	std::filesystem::copy_file(path, cutPath, std::filesystem::copy_options::overwrite_existing);
+	std::filesystem::resize_file(cutPath, std::filesystem::file_size(path) / 2);
+
+	{
+		BenchmarkArchive<ViewArray>	archive;
+		LoadMappedArchiveContext	load{ cutPath.c_str() };
+
+		if (load.IsOpen())
+			load& archive;
+
+		Expect(!load.IsOpen() || load.Failed(), "a truncated archive loaded without failing");
+	}
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(cutPath);
+
+	// Blobs of a streamed archive have to read the spilled chunks back, not just the ones still in memory
+	{
+		BenchmarkArchive<CopiedArray> archive;
+		archive.vertices.resize(3 * ArchiveWriteBuffer::ChunkSize / sizeof(ArchiveVertex) + 17);
+		archive.indices.resize(archive.vertices.size());
+
+		for (size_t I = 0; I < archive.vertices.size(); ++I)
+			archive.vertices[I] = { { float(I % 1024), float(I), 1.0f }, { 0.5f, 0.5f } };
+
+		std::iota(archive.indices.begin(), archive.indices.end(), 0u);
+
+		SaveArchiveContext streamed{ StreamedArchive{} };
+		SaveArchiveContext buffered;
+
+		streamed& archive;
+		buffered& archive;
+
+		Blob streamedBlob = streamed.GetBlob();
+		Blob bufferedBlob = buffered.GetBlob();
+
+		Expect(streamedBlob.size() == bufferedBlob.size() && memcmp(streamedBlob.data(), bufferedBlob.data(), bufferedBlob.size()) == 0,
+			"blob of a spilled archive does not match the in memory archive");
+	}
+}
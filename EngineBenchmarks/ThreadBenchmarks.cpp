@@ -0,0 +1,494 @@
+#include "Benchmarks.h"
+
+#include <Components.h>
+#include <Windows.h>
+
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace FlexKit;
+
+
+/************************************************************************************************/
+
+
+// User and kernel time of every thread in the process
+static double ProcessCPUTimeMS()
+{
+	FILETIME creation, exit, kernel, user;
+	GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+
+	const auto ToTicks = [](const FILETIME time) { return (uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+
+	return double(ToTicks(kernel) + ToTicks(user)) / 10000.0;
+}
+
+
+/************************************************************************************************/
+
+
+static const char* GetPolicyName(const WorkerIdlePolicy policy)
+{
+	switch (policy)
+	{
+	case WorkerIdlePolicy::Spin:	return "Spin";
+	case WorkerIdlePolicy::Backoff:	return "Backoff";
+	case WorkerIdlePolicy::Park:	return "Park";
+	default:						return "Unknown";
+	}
+}
+
+
+/************************************************************************************************/
+
+
+// Wake latency of a single task pushed to an idle pool, and the CPU the pool burns while idle
+void IdlePolicyBenchmark(BenchmarkContext& ctx)
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	constexpr size_t	wakeCount		= 200;
+	constexpr auto		settleTime		= std::chrono::milliseconds{ 5 };
+	constexpr auto		idleTime		= std::chrono::milliseconds{ 250 };
+
+	const auto previousPolicy = ctx.threads.GetIdlePolicy();
+
+	double parkedCores	= 0.0;
+	double spinCores	= 0.0;
+
+	fmt::print("    policy  | wake median | wake p99 | idle CPU (cores) | worker spin / parked ms\n");
+
+	for (const auto policy : { WorkerIdlePolicy::Spin, WorkerIdlePolicy::Backoff, WorkerIdlePolicy::Park })
+	{
+		ctx.threads.SetIdlePolicy(policy);
+		std::this_thread::sleep_for(settleTime);
+
+		std::vector<double> latencies;
+		latencies.reserve(wakeCount);
+
+		for (size_t I = 0; I < wakeCount; ++I)
+		{
+			// Workers have to fall back into their idle state before every push
+			std::this_thread::sleep_for(settleTime);
+
+			std::atomic<Clock::time_point::rep>	ranAt	= 0;
+			const auto							pushed	= Clock::now();
+
+			auto& work = CreateWorkItem(
+				[&](iAllocator&)
+				{
+					ranAt.store(Clock::now().time_since_epoch().count(), std::memory_order_release);
+				}, &ctx.allocator);
+
+			ctx.threads.AddWork(work);
+
+			while (ranAt.load(std::memory_order_acquire) == 0)
+				_mm_pause();
+
+			const auto ran = Clock::time_point{ Clock::duration{ ranAt.load(std::memory_order_relaxed) } };
+			latencies.push_back(std::chrono::duration<double, std::micro>(ran - pushed).count());
+		}
+
+		std::sort(latencies.begin(), latencies.end());
+
+		// Idle cost, the calling thread sleeps so any CPU time is the pool's
+		ctx.threads.ResetSchedulerStats();
+
+		const double cpuBegin	= ProcessCPUTimeMS();
+		const auto	 wallBegin	= Clock::now();
+
+		std::this_thread::sleep_for(idleTime);
+
+		const double cpuMS	= ProcessCPUTimeMS() - cpuBegin;
+		const double wallMS	= std::chrono::duration<double, std::milli>(Clock::now() - wallBegin).count();
+		const double cores	= cpuMS / wallMS;
+
+		const auto stats = ctx.threads.GetSchedulerStats();
+
+		double spinMS	= 0.0;
+		double parkedMS	= 0.0;
+
+		for (auto& worker : stats.workers)
+		{
+			spinMS		+= std::chrono::duration<double, std::milli>(worker.spinTime).count();
+			parkedMS	+= std::chrono::duration<double, std::milli>(worker.parkedTime).count();
+		}
+
+		if (policy == WorkerIdlePolicy::Spin)	spinCores	= cores;
+		if (policy == WorkerIdlePolicy::Park)	parkedCores	= cores;
+
+		fmt::print("    {:7} | {:8.1f} us | {:5.1f} us | {:16.2f} | {:.0f} / {:.0f}\n",
+			GetPolicyName(policy), latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], cores, spinMS, parkedMS);
+	}
+
+	ctx.threads.SetIdlePolicy(previousPolicy);
+
+	Expect(parkedCores < 0.5, "parked workers keep burning CPU while the pool is idle");
+	Expect(ctx.threads.GetThreadCount() < 2 || parkedCores < spinCores, "parking does not save any CPU over spinning");
+}
+
+
+/************************************************************************************************/
+
+
+// Cheap serial dependency chain, keeps a core busy without touching memory
+static uint64_t SpinWork(const uint64_t seed, const size_t iterations)
+{
+	uint64_t x = seed | 1;
+
+	for (size_t I = 0; I < iterations; ++I)
+		x = x * 6364136223846793005ull + 1442695040888963407ull;
+
+	return x;
+}
+
+
+/************************************************************************************************/
+
+
+// Fixed amount of work split over a growing number of tasks, time should drop until the width passes the pool size
+void ThreadScalingBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t totalIterations = 1 << 28;
+
+	const size_t threadCount	= ctx.threads.GetThreadCount() + 1; // Joining thread helps out
+	std::atomic_uint64_t sink	= 0;
+
+	auto RunWidth =
+		[&](const size_t width)
+		{
+			return BestOf(3,
+				[&]
+				{
+					WorkBarrier barrier{ ctx.threads, &ctx.allocator };
+
+					for (size_t I = 0; I < width; ++I)
+					{
+						auto& work = CreateWorkItem(
+							[&, I](iAllocator&)
+							{
+								sink.fetch_xor(SpinWork(I, totalIterations / width), std::memory_order_relaxed);
+							}, &ctx.allocator);
+
+						barrier.AddWork(work);
+						ctx.threads.AddWork(work);
+					}
+
+					barrier.Join();
+				});
+		};
+
+	const double serialMS = RunWidth(1);
+	double fullWidthSpeedup = 1.0;
+
+	fmt::print("    tasks | time | speedup ({} threads including the caller)\n", threadCount);
+	fmt::print("    {:5} | {:8.2f} ms | 1.00x\n", 1, serialMS);
+
+	for (size_t width = 2; width < threadCount * 4; width *= 2)
+	{
+		const double ms = RunWidth(width);
+
+		if (width <= threadCount)
+			fullWidthSpeedup = serialMS / ms;
+
+		fmt::print("    {:5} | {:8.2f} ms | {:.2f}x\n", width, ms, serialMS / ms);
+	}
+
+	Expect(threadCount < 4 || fullWidthSpeedup > 1.5, "work does not spread across the pool");
+
+	// Submissions from a thread outside of the pool go through the workers' inboxes
+	constexpr size_t outsideCount = 1024;
+
+	std::atomic_size_t	ran = 0;
+	WorkBarrier			barrier{ ctx.threads, &ctx.allocator };
+
+	const double outsideMS = BestOf(1,
+		[&]
+		{
+			std::thread submitter{
+				[&]
+				{
+					for (size_t I = 0; I < outsideCount; ++I)
+					{
+						auto& work = CreateWorkItem(
+							[&](iAllocator&)
+							{
+								ran.fetch_add(1, std::memory_order_relaxed);
+							}, &ctx.allocator);
+
+						barrier.AddWork(work);
+						ctx.threads.AddWork(work);
+					}
+				} };
+
+			submitter.join();
+			barrier.Join();
+		});
+
+	fmt::print("    {} tasks submitted from an outside thread: {:.2f} ms\n", outsideCount, outsideMS);
+
+	Expect(ran == outsideCount, "work submitted from an outside thread was lost");
+}
+
+
+/************************************************************************************************/
+
+
+// Update tasks that fan out with their own Parallel_For, either blocking in Join or co_awaiting the barrier.
+// Both have to finish every nested loop, awaiting tasks shouldn't hold their worker while the loop runs
+void NestedParallelForBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t taskCount	= 64;
+	constexpr size_t valueCount	= 1 << 16;
+	constexpr size_t blockSize	= 1024;
+
+	struct SumData
+	{
+		std::atomic_uint64_t sum = 0;
+	};
+
+	std::vector<uint64_t> values(valueCount);
+	std::iota(values.begin(), values.end(), 0);
+
+	const uint64_t expected = uint64_t(valueCount) * (valueCount - 1) / 2;
+
+	// Parallel_For2_Async's tasks are never freed, every run starts from an empty frame
+	StackAllocator		frameStack{ &ctx.allocator, 16 * MEGABYTE };
+	ThreadSafeAllocator	frameAllocator{ frameStack };
+
+	auto SumBlock =
+		[](SumData& data, const uint64_t* begin, const uint64_t* end)
+		{
+			uint64_t sum = 0;
+
+			for (auto itr = begin; itr < end; ++itr)
+				sum += *itr;
+
+			data.sum.fetch_add(sum, std::memory_order_relaxed);
+		};
+
+	auto RunGraph =
+		[&](const bool awaitLoops)
+		{
+			frameStack.clear();
+
+			UpdateDispatcher			dispatcher{ &ctx.threads, &frameAllocator };
+			std::vector<UpdateTask*>	tasks;
+			std::vector<SumData*>		sums;
+
+			for (size_t I = 0; I < taskCount; ++I)
+			{
+				// Every fourth task starts a new chain, the rest wait on the task before them
+				auto Link =
+					[&, I](auto& builder, SumData& data)
+					{
+						builder.SetDebugString("Nested Parallel_For");
+
+						if (I % 4)
+							builder.AddInput(*tasks.back());
+
+						sums.push_back(&data);
+					};
+
+				if (awaitLoops)
+				{
+					auto& task = dispatcher.Add<SumData>(Link,
+						[&](SumData& data, iAllocator&) -> WorkCoroutine
+						{
+							auto Sum = [&](const uint64_t* begin, const uint64_t* end, size_t, iAllocator&) { SumBlock(data, begin, end); };
+
+							WorkBarrier barrier{ ctx.threads, &frameAllocator };
+							Parallel_For2_Async(ctx.threads, frameAllocator, values.data(), values.data() + valueCount, blockSize, Sum, barrier);
+
+							co_await barrier;
+						});
+
+					tasks.push_back(task);
+				}
+				else
+				{
+					auto& task = dispatcher.Add<SumData>(Link,
+						[&](SumData& data, iAllocator& threadAllocator)
+						{
+							Parallel_For2(ctx.threads, threadAllocator, values.data(), values.data() + valueCount, blockSize,
+								[&](const uint64_t* begin, const uint64_t* end, size_t, iAllocator&) { SumBlock(data, begin, end); });
+						});
+
+					tasks.push_back(task);
+				}
+			}
+
+			dispatcher.Execute();
+
+			size_t mismatches = 0;
+			for (auto sum : sums)
+				mismatches += sum->sum.load(std::memory_order_relaxed) != expected;
+
+			return mismatches;
+		};
+
+	size_t blockingMismatches	= 0;
+	size_t awaitingMismatches	= 0;
+
+	const double blockingMS = BestOf(5, [&] { blockingMismatches += RunGraph(false); });
+	const double awaitingMS = BestOf(5, [&] { awaitingMismatches += RunGraph(true); });
+
+	fmt::print("    {} update tasks, each summing {} values in blocks of {}\n", taskCount, valueCount, blockSize);
+	fmt::print("    blocking Join: {:.2f} ms | co_await: {:.2f} ms | {:.2f}x\n", blockingMS, awaitingMS, blockingMS / awaitingMS);
+
+	Expect(blockingMismatches == 0, "a nested Parallel_For inside a blocking update task lost work");
+	Expect(awaitingMismatches == 0, "a nested Parallel_For inside a coroutine update task lost work");
+
+	ctx.allocator._aligned_free(frameStack.buffer());
+}
+
+
+/************************************************************************************************/
+
+
+// Fixed block sizes against the adaptive Parallel_For, over uniform items and items where a few cost far more than the rest
+void ParallelForBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t itemCount		= 1 << 16;
+	constexpr size_t baseIterations	= 256;
+	constexpr size_t smallLoopCount	= 64;
+
+	// Parallel_For2's tasks come from the allocator and are never freed
+	StackAllocator frame{ &ctx.allocator, 128 * MEGABYTE };
+
+	std::vector<size_t>		uniformCost(itemCount, baseIterations);
+	std::vector<size_t>		skewedCost(itemCount, baseIterations / 4);
+	std::vector<uint64_t>	results(itemCount);
+	uint64_t* const			out = results.data();
+
+	// One item in 64 is a hundred times heavier, clustered at the end of the range
+	for (size_t I = itemCount - itemCount / 64; I < itemCount; ++I)
+		skewedCost[I] = baseIterations * 100;
+
+	auto Expected =
+		[&](const std::vector<size_t>& costs)
+		{
+			uint64_t sum = 0;
+			for (size_t I = 0; I < itemCount; ++I)
+				sum ^= SpinWork(I, costs[I]);
+
+			return sum;
+		};
+
+	// Loops run over the result array, the item index is the offset into it
+	auto RunItems =
+		[&](const std::vector<size_t>& costs, uint64_t* begin, uint64_t* end)
+		{
+			for (auto itr = begin; itr < end; ++itr)
+			{
+				const size_t I = itr - out;
+				*itr = SpinWork(I, costs[I]);
+			}
+		};
+
+	auto Checksum =
+		[&]
+		{
+			uint64_t sum = 0;
+			for (auto result : results)
+				sum ^= result;
+
+			return sum;
+		};
+
+	fmt::print("    workload | serial | block 1 | block 64 | block N/threads | adaptive\n");
+
+	for (const auto& [name, workload] : { std::pair{ "uniform", &uniformCost }, std::pair{ "skewed", &skewedCost } })
+	{
+		const auto& costs = *workload;
+
+		const uint64_t expected = Expected(costs);
+
+		auto RunFixed =
+			[&](const size_t blockSize)
+			{
+				return BestOf(3,
+					[&]
+					{
+						frame.clear();
+
+						Parallel_For2(ctx.threads, frame, out, out + itemCount, blockSize,
+							[&](uint64_t* begin, uint64_t* end, size_t, iAllocator&) { RunItems(costs, begin, end); });
+					});
+			};
+
+		const double serialMS = BestOf(3, [&] { RunItems(costs, out, out + itemCount); });
+
+		const double block1MS		= RunFixed(1);
+		const double block64MS		= RunFixed(64);
+		const double blockEvenMS	= RunFixed(itemCount / (ctx.threads.GetThreadCount() + 1));
+
+		Expect(Checksum() == expected, "fixed block Parallel_For2 skipped items");
+
+		const double adaptiveMS = BestOf(3,
+			[&]
+			{
+				frame.clear();
+
+				Parallel_ForRange(ctx.threads, frame, out, out + itemCount,
+					[&](uint64_t* begin, uint64_t* end, iAllocator&) { RunItems(costs, begin, end); });
+			});
+
+		Expect(Checksum() == expected, "adaptive Parallel_For skipped items");
+
+		fmt::print("    {:8} | {:6.2f} ms | {:6.2f} ms | {:6.2f} ms | {:6.2f} ms | {:6.2f} ms\n",
+			name, serialMS, block1MS, block64MS, blockEvenMS, adaptiveMS);
+
+		// Even splits leave workers idle behind the heavy tail, the adaptive loop has to keep up with the best fixed size
+		Expect(adaptiveMS < 1.5 * std::min({ block1MS, block64MS, blockEvenMS }), "adaptive Parallel_For is slower than a hand picked block size");
+	}
+
+	// Small loops should run inline instead of paying for tasks
+	std::vector<uint64_t> small(smallLoopCount, 1);
+
+	const double smallFixedMS = BestOf(100,
+		[&]
+		{
+			frame.clear();
+			Parallel_For(ctx.threads, frame, small.begin(), small.end(), 1, [](uint64_t& value, iAllocator&) { value += 1; });
+		});
+
+	const double smallAdaptiveMS = BestOf(100,
+		[&]
+		{
+			frame.clear();
+			Parallel_For(ctx.threads, frame, small.begin(), small.end(), [](uint64_t& value, iAllocator&) { value += 1; });
+		});
+
+	fmt::print("    {} trivial items | block 1: {:.4f} ms | adaptive: {:.4f} ms\n", smallLoopCount, smallFixedMS, smallAdaptiveMS);
+
+	Expect(std::all_of(small.begin(), small.end(), [](uint64_t value) { return value == 201; }), "small Parallel_For skipped items");
+	Expect(smallAdaptiveMS <= smallFixedMS, "small adaptive loops still create tasks");
+
+	// Reduce and scan against serial results
+	std::vector<uint64_t> values(itemCount);
+	std::vector<uint64_t> scanned(itemCount);
+	std::iota(values.begin(), values.end(), 1);
+
+	frame.clear();
+
+	const uint64_t reduced = Parallel_Reduce(ctx.threads, frame, values.begin(), values.end(), uint64_t(0),
+		[](auto begin, auto end, iAllocator&) { return std::accumulate(begin, end, uint64_t(0)); },
+		[](uint64_t lhs, uint64_t rhs) { return lhs + rhs; });
+
+	frame.clear();
+
+	Parallel_InclusiveScan(ctx.threads, frame, values.begin(), values.end(), scanned.begin(), uint64_t(0),
+		[](uint64_t lhs, uint64_t rhs) { return lhs + rhs; });
+
+	size_t scanMismatches = 0;
+	for (size_t I = 0; I < itemCount; ++I)
+		scanMismatches += scanned[I] != uint64_t(I + 1) * (I + 2) / 2;
+
+	Expect(reduced == uint64_t(itemCount) * (itemCount + 1) / 2, "Parallel_Reduce does not match the serial sum");
+	Expect(scanMismatches == 0, "Parallel_InclusiveScan does not match the serial scan");
+
+	ctx.allocator._aligned_free(frame.buffer());
+}
@@ -0,0 +1,121 @@
+#include "Benchmarks.h"
+
+#include <Transforms.h>
+
+#include <random>
+#include <vector>
+
+using namespace FlexKit;
+
+
+/************************************************************************************************/
+
+
+// Nodes only carry translations, so a node's world position is the sum of its ancestors' offsets
+static float3 ExpectedPosition(NodeHandle node)
+{
+	float3 position{ 0, 0, 0 };
+
+	for (NodeHandle itr = node; itr != SceneNodeTable.root; itr = GetParentNode(itr))
+		position += GetPositionL(itr);
+
+	return position;
+}
+
+
+/************************************************************************************************/
+
+
+void TransformBenchmark(BenchmarkContext& ctx)
+{
+	constexpr size_t nodeCount			= 100000;
+	constexpr size_t frameCount			= 200;
+	constexpr size_t spawnsPerFrame		= 64;
+	constexpr size_t reparentsPerFrame	= 16;
+	constexpr size_t movesPerFrame		= 256;
+
+	std::minstd_rand		rng{ 1337 };
+	std::vector<NodeHandle>	nodes;
+
+	nodes.reserve(nodeCount + frameCount * spawnsPerFrame);
+
+	auto Spawn =
+		[&]
+		{
+			const NodeHandle node = GetZeroedNode();
+
+			if (nodes.size())
+				SetParentNode(nodes[rng() % nodes.size()], node);
+
+			SetPositionL(node, float3{ float(rng() % 16), 1.0f, 0.0f });
+			nodes.push_back(node);
+		};
+
+	for (size_t I = 0; I < nodeCount; ++I)
+		Spawn();
+
+	UpdateTransforms(ctx.threads, ctx.allocator);
+
+	// Steady state frames, spawning and reparenting patch the layout instead of rebuilding it
+	double	worstMS		= 0.0;
+	double	totalMS		= 0.0;
+	size_t	relayouts	= 0;
+
+	for (size_t frame = 0; frame < frameCount; ++frame)
+	{
+		for (size_t I = 0; I < spawnsPerFrame; ++I)
+			Spawn();
+
+		for (size_t I = 0; I < reparentsPerFrame; ++I)
+		{
+			const NodeHandle node	= nodes[1 + rng() % (nodes.size() - 1)];
+			const NodeHandle parent	= nodes[rng() % nodes.size()];
+
+			// Parenting to a descendant is rejected, only pick parents outside the subtree
+			bool descendant = false;
+			for (NodeHandle itr = parent; itr != SceneNodeTable.root && !descendant; itr = GetParentNode(itr))
+				descendant = itr == node;
+
+			if (!descendant)
+				SetParentNode(parent, node);
+		}
+
+		for (size_t I = 0; I < movesPerFrame; ++I)
+			SetPositionL(nodes[rng() % nodes.size()], float3{ float(rng() % 16), 1.0f, 0.0f });
+
+		relayouts += SceneNodeTable.layoutDirty;
+
+		const double ms = BestOf(1, [&] { UpdateTransforms(ctx.threads, ctx.allocator); });
+
+		worstMS = std::max(worstMS, ms);
+		totalMS += ms;
+	}
+
+	// Same frame with a forced relayout, which used to happen after every add or reparent
+	for (size_t I = 0; I < movesPerFrame; ++I)
+		SetPositionL(nodes[rng() % nodes.size()], float3{ float(rng() % 16), 1.0f, 0.0f });
+
+	SceneNodeTable.layoutDirty = true;
+	const double relayoutMS = BestOf(1, [&] { UpdateTransforms(ctx.threads, ctx.allocator); });
+
+	fmt::print("    {} nodes, {} spawns + {} reparents + {} moves per frame\n", nodeCount, spawnsPerFrame, reparentsPerFrame, movesPerFrame);
+	fmt::print("    incremental: {:.3f} ms avg | {:.3f} ms worst | {} relayouts in {} frames\n", totalMS / frameCount, worstMS, relayouts, frameCount);
+	fmt::print("    full relayout frame: {:.3f} ms\n", relayoutMS);
+
+	Expect(relayouts < frameCount / 4, "adding and reparenting nodes still relayouts the whole table");
+
+	size_t mismatches = 0;
+	for (size_t I = 0; I < nodes.size(); I += 97)
+	{
+		const float3 error = GetPositionW(nodes[I]) - ExpectedPosition(nodes[I]);
+		mismatches += error.magnitudeSq() > 1e-3f;
+	}
+
+	Expect(mismatches == 0, "world transforms do not match the node hierarchy");
+
+	for (auto node : nodes)
+		ReleaseNode(node);
+
+	UpdateTransforms(ctx.threads, ctx.allocator);
+	UpdateTransforms(ctx.threads, ctx.allocator);
+}
@@ -0,0 +1,17 @@
+#define  _SILENCE_CXX20_CISO646_REMOVED_WARNING
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <allSourceFiles.cpp>
+
+#include <angelscript/scriptbuilder/scriptbuilder.cpp>
+#include <angelscript/scriptany/scriptany.cpp>
+#include <angelscript/scriptarray/scriptarray.cpp>
+#include <angelscript/scriptstdstring/scriptstdstring.cpp>
+#include <angelscript/scriptstdstring/scriptstdstring_utils.cpp>
+#include <angelscript/scriptmath/scriptmath.cpp>
+#include <angelscript/scriptmath/scriptmathcomplex.cpp>
+
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
@@ -0,0 +1,66 @@
+#define  _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include "Benchmarks.h"
+
+#include <cstring>
+
+
+/************************************************************************************************/
+
+
+// Every benchmark runs by default, pass benchmark names on the command line to run a subset
+constexpr Benchmark benchmarks[] =
+{
+	{ "Allocator",	AllocatorBenchmark	},
+	{ "Transforms",	TransformBenchmark	},
+	{ "SceneNodes",	SceneNodeStressTest	},
+	{ "BVHRefit",	SceneBVHRefitBenchmark	},
+	{ "BVHBuild",	SceneBVHBuildBenchmark	},
+	{ "Archetype",	ArchetypeBenchmark	},
+	{ "IdlePolicy",	IdlePolicyBenchmark	},
+	{ "ThreadScaling",	ThreadScalingBenchmark	},
+	{ "NestedParallel",	NestedParallelForBenchmark	},
+	{ "ParallelFor",	ParallelForBenchmark	},
+	{ "ArchiveLoad",	ArchiveLoadBenchmark	},
+	{ "ResourceRead",	ResourceReadBenchmark	},
+	{ "AssetLookup",	AssetLookupBenchmark	},
+	{ "TraceOverhead",	TraceOverheadBenchmark	},
+	{ "AnimationSampling",	AnimationSamplingBenchmark	},
+	{ "AnimationCompression",	AnimationCompressionBenchmark	},
+	{ "PoseUpdate",	PoseUpdateBenchmark	},
+};
+
+
+/************************************************************************************************/
+
+
+int main(int argc, char** argv)
+{
+	auto* memory = FlexKit::CreateEngineMemory();
+	EXITSCOPE(ReleaseEngineMemory(memory));
+
+	{
+		FlexKit::ThreadManager threads{ FlexKit::ThreadManager::AutoThreadCount, memory->BlockAllocator };
+
+		BenchmarkContext context{ *memory, threads, memory->BlockAllocator };
+
+		fmt::print("{} worker threads\n\n", threads.GetThreadCount());
+
+		for (auto& benchmark : benchmarks)
+		{
+			bool selected = argc < 2;
+
+			for (int I = 1; I < argc; ++I)
+				selected |= strcmp(argv[I], benchmark.name) == 0;
+
+			if (!selected)
+				continue;
+
+			fmt::print("{}\n", benchmark.name);
+			benchmark.fn(context);
+			fmt::print("\n");
+		}
+	}
+
+	return benchmarkFailed ? -1 : 0;
+}
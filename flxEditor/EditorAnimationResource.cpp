@@ -76,31 +76,29 @@ namespace FlexKit
             .Type       = EResourceType::EResource_Animation,
             .GUID       = (uint64_t)guid,
             .trackCount = (uint32_t)tracks.size(),
+            .version    = AnimationResourceVersion,
         };
 
         strncpy_s(header.ID, ID.c_str(), ID.size());
 
-        Blob resourceBlob;
+        std::vector<AnimationTrackSource> sources;
+        size_t rawSize = 0;
 
         for (auto& track : tracks)
         {
-            Blob keyFrameBlob;
+            sources.push_back({
+                .keyFrames  = track.KeyFrames,
+                .trackName  = track.targetChannel.Channel.c_str(),
+                .target     = track.targetChannel.Target.c_str() });
 
-            for (auto& frame : track.KeyFrames)
-                keyFrameBlob += Blob{ frame };
-
-            AnimationTrackHeader trackHeader = {
-                .frameCount = (uint32_t)track.KeyFrames.size(),
-                .byteSize   = (uint32_t)(sizeof(trackHeader) + keyFrameBlob.size()),
-            };
+            rawSize += sizeof(AnimationTrackHeader) + track.KeyFrames.size() * sizeof(AnimationKeyFrame);
+        }
 
-            auto& target    = track.targetChannel.Target;
-            auto& trackName = track.targetChannel.Channel;
-            strncpy_s(trackHeader.target,       target.c_str(),     target.size());
-            strncpy_s(trackHeader.trackName,    trackName.c_str(),  trackName.size());
+        Blob resourceBlob = WriteAnimationTracks(sources, compression);
 
-            resourceBlob += Blob{ trackHeader } + keyFrameBlob;
-        }
+        if (compression.enabled)
+            FK_LOG_INFO("Animation %s compressed from %u to %u bytes",
+                ID.c_str(), (uint32_t)rawSize, (uint32_t)resourceBlob.size());
 
         header.ResourceSize = sizeof(header) + resourceBlob.size();
 
@@ -136,6 +136,8 @@ namespace FlexKit
 		std::string                 ID;
 		GUID_t                      guid = rand();
 		std::vector<Track>          tracks;
+
+		AnimationCompressionSettings compression;
 	};
 
 
@@ -28,16 +28,26 @@ bool EditorProject::LoadProject(const std::string& projectDir)
 {
 	std::filesystem::path projectPath(projectDir);
 	
-	auto f = fopen(projectDir.c_str(), "rb");
-	if (!f)
-		return false;
+	std::vector<ProjectResource_ptr>	loadedResources;
+	std::vector<EditorScene_ptr>		loadedScenes;
+
+	{	// Everything is copied out of the mapping, it is closed before returning so the project can be saved over
+		FlexKit::LoadMappedArchiveContext archive{ projectDir.c_str() };
+		if (!archive.IsOpen())
+			return false;
 
-	FlexKit::LoadFileArchiveContext archive{ f };
-	archive& resources;
-	archive& scenes;
+		archive& loadedResources;
+		archive& loadedScenes;
 
+		if (archive.Failed())
+		{
+			FK_LOG_ERROR("Failed to load project %s, the file is truncated or corrupt!", projectDir.c_str());
+			return false;
+		}
+	}
 
-	fclose(f);
+	resources.insert(resources.end(), loadedResources.begin(), loadedResources.end());
+	scenes.insert(scenes.end(), loadedScenes.begin(), loadedScenes.end());
 
 	const std::string fileName = projectPath.replace_extension().string();
 	FlexKit::SetProjectResourceDir(fileName + R"(.objects/)");
@@ -62,16 +72,39 @@ bool EditorProject::SaveProject(const std::string& projectDir)
 
 	try
 	{
-		FlexKit::SaveArchiveContext archive;
+		FlexKit::SaveArchiveContext archive{ FlexKit::StreamedArchive{} };
 		archive& resources;
 		archive& scenes;
 
-		auto blob = archive.GetBlob();
+		// Written next to the project and moved over it, a failed save leaves the previous project intact
+		const std::string tempPath = projectDir + ".tmp";
+
+		auto f = fopen(tempPath.c_str(), "wb");
+		if (!f)
+			return false;
 
-		auto f = fopen(projectDir.c_str(), "wb");
-		WriteBlob(blob, f);
+		const bool res = archive.WriteToFile(f);
 		fclose(f);
 
+		if (!res)
+		{
+			std::filesystem::remove(tempPath);
+			return false;
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, projectDir, ec);
+
+		if (ec)
+		{
+			FK_LOG_ERROR("Failed to replace project %s, %s", projectDir.c_str(), ec.message().c_str());
+
+			std::error_code removeError;
+			std::filesystem::remove(tempPath, removeError);
+
+			return false;
+		}
+
 		return true;
 	}
 	// swallow any exceptions
@@ -234,8 +234,7 @@ namespace FlexKit
 					FlexKit::SaveArchiveContext ctx{};
 
 					ctx&* resource.get();
-
-					FlexKit::WriteBlob(ctx.GetBlob(), F);
+					ctx.WriteToFile(F);
 				}
 
 				if (F) fclose(F);
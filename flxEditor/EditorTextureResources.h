@@ -134,6 +134,7 @@ namespace FlexKit
 
 			ar& exportedMIPCount;
 			ar& offsets;
+
 			ar& RawBuffer{ cachedBuffer, cachedBufferSize };
 		}
 
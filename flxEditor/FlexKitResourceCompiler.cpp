@@ -71,6 +71,7 @@ int main(int argc, char* argv[])
 	};
 
 	TOOL_MODE Mode = TOOL_MODE::ETOOLMODE_HELP;
+	bool Compress = false;
 
 	for (int I = 0; I < argc; ++I)
 	{
@@ -111,6 +112,10 @@ int main(int argc, char* argv[])
 		{
 			Mode = TOOL_MODE::ETOOLMODE_COMPILERESOURCE;
 		}
+		else if (!strcmp(argv[I], "compress") || !strcmp(argv[I], "-z"))
+		{
+			Compress = true;
+		}
 		else if (!strcmp(argv[I], "help") || !strcmp(argv[I], "-h"))
 		{
 			Mode = TOOL_MODE::ETOOLMODE_HELP;
@@ -278,7 +283,7 @@ int main(int argc, char* argv[])
 				return -1;
 			}
 
-            ExportGameRes(Out, resources);
+            ExportGameRes(Out, resources, Compress);
 	}	break;
 	case TOOL_MODE::ETOOLMODE_LISTCONTENTS:
 	{	if (FileChosen)
@@ -339,6 +344,7 @@ int main(int argc, char* argv[])
             "out or -o to set output file\n"
 			"target or -f Specifies a FBX file for inclusion\n"
 			"gltf or -tf Specifies a gltf file for inclusion\n"
+			"compress or -z block compresses resources in the output file\n"
 			"list or -ls will Print the Targeted Resource File\n";
 	}	break;
 	default:
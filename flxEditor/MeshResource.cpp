@@ -209,12 +209,15 @@ namespace FlexKit
 
 		dirtyFlag = false;
 
-		FlexKit::SaveArchiveContext ar;
+		FlexKit::SaveArchiveContext ar{ FlexKit::StreamedArchive{} };
 		ar& *data;
 
 		const auto dir	= GetProjectResourceDir() + objectPath;
 		auto F			= fopen(dir.c_str(), "wb");
-		FlexKit::WriteBlob(ar.GetBlob(), F);
+		if (!F)
+			return;
+
+		ar.WriteToFile(F);
 
 		fclose(F);
 	}
@@ -296,7 +296,7 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
-	bool ExportGameRes(const std::string& file, const ResourceList& resources)
+	bool ExportGameRes(const std::string& file, const ResourceList& resources, const bool compress)
 	{
 		std::vector<ResourceBlob> blobs;
 
@@ -317,12 +317,14 @@ namespace FlexKit
 		FK_ASSERT(&Table != nullptr, "Allocation Error!");
 
 		memset(&Table, 0, TableSize);
-		Table.MagicNumber   = 0xF4F3F2F1F4F3F2F1;
-		Table.Version       = 0x0000000000000002;
+		Table.MagicNumber   = ResourceTableMagicNumber;
+		Table.Version       = ResourceTableVersion;
 		Table.ResourceCount = blobs.size();
 
 		std::cout << "Resources Found: " << blobs.size() << "\n";
 
+		std::vector<std::vector<byte>> compressed(blobs.size());
+
 		size_t Position = TableSize;
 
 		for (size_t I = 0; I < blobs.size(); ++I)
@@ -330,10 +332,26 @@ namespace FlexKit
 			Table.Entries[I].ResourcePosition = Position;
 			Table.Entries[I].GUID = blobs[I].GUID;
 			Table.Entries[I].Type = blobs[I].resourceType;
+			Table.Entries[I].Encoding = EResourceEncoding_Raw;
 
 			memcpy(Table.Entries[I].ID, blobs[I].ID.c_str(), ID_LENGTH);
 
-			Position += blobs[I].bufferSize;
+			// Only keep the compressed encoding when it actually saves space
+			if (compress &&
+				CompressResource(blobs[I].buffer, blobs[I].bufferSize, compressed[I]) &&
+				compressed[I].size() < blobs[I].bufferSize)
+			{
+				Table.Entries[I].Encoding = EResourceEncoding_BlockCompressed;
+				Position += compressed[I].size();
+
+				std::cout << "Compressed: " << blobs[I].ID << " " << blobs[I].bufferSize << " -> " << compressed[I].size() << " bytes\n";
+			}
+			else
+			{
+				compressed[I].clear();
+				Position += blobs[I].bufferSize;
+			}
+
 			std::cout << "Resource Found: " << blobs[I].ID << " ID: " << Table.Entries[I].GUID << "\n";
 		}
 
@@ -347,8 +365,13 @@ namespace FlexKit
 
 		std::cout << "writing resource " << file << '\n';
 
-		for (auto& blob : blobs)
-			fwrite(blob.buffer, sizeof(char), blob.bufferSize, F);
+		for (size_t I = 0; I < blobs.size(); ++I)
+		{
+			if (Table.Entries[I].Encoding == EResourceEncoding_BlockCompressed)
+				fwrite(compressed[I].data(), sizeof(char), compressed[I].size(), F);
+			else
+				fwrite(blobs[I].buffer, sizeof(char), blobs[I].bufferSize, F);
+		}
 
 		return true;
 	}
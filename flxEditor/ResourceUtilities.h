@@ -83,7 +83,7 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
-	bool ExportGameRes(const std::string& file, const ResourceList& blobs);
+	bool ExportGameRes(const std::string& file, const ResourceList& blobs, const bool compress = false);
 
 
 	/************************************************************************************************/
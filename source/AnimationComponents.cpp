@@ -147,7 +147,12 @@ namespace FlexKit
 		float end = 0.0f;
 
 		for (auto& t : tracks)
-			end = Max(end, t.keyFrames.back().End);
+			if (t.keyFrames.size())
+				end = Max(end, t.keyFrames.back().End);
+
+		for (auto& t : compressedTracks)
+			if (t.keyCount)
+				end = Max(end, t.times[t.keyCount]);
 
 		return end;
 	}
@@ -163,17 +168,44 @@ namespace FlexKit
 		if (asset != -1)
 		{
 			auto animationBlob  = (AnimationResourceBlob*)GetAsset(asset);
+
+			if (animationBlob->header.version != AnimationResourceVersion)
+			{
+				FK_LOG_ERROR("Animation %s has resource version %u, expected %u. Re-export it from the editor.",
+					animationBlob->header.ID, animationBlob->header.version, AnimationResourceVersion);
+
+				FreeAsset(asset);
+				return nullptr;
+			}
+
 			auto& animation     = allocator.allocate<Animation>(allocator);
 
 			const size_t trackCount     = animationBlob->header.trackCount;
+			const size_t streamSize     = animationBlob->header.ResourceSize - AnimationResourceBlob::AnimationResourceHeader::size();
 			size_t currentFileOffset    = 0;
 
+			struct CompressedTrackEntry
+			{
+				size_t          offset;
+				TrackEncoding   encoding;
+			};
+
+			Vector<CompressedTrackEntry> compressedEntries{ &allocator };
+
 			for (size_t I = 0; I < trackCount; ++I)
 			{
 				const AnimationTrackHeader* header      = reinterpret_cast<AnimationTrackHeader*>(animationBlob->Buffer + currentFileOffset);
 				const AnimationKeyFrame*    keyFrames   = reinterpret_cast<AnimationKeyFrame*>(animationBlob->Buffer + currentFileOffset + sizeof(AnimationTrackHeader));
 				const uint32_t              frameCount  = header->frameCount;
 
+				if (header->encoding != TrackEncoding::Raw)
+				{
+					compressedEntries.push_back({ currentFileOffset, header->encoding });
+					currentFileOffset += header->byteSize;
+
+					continue;
+				}
+
 				Vector<AnimationKeyFrame> frames{ &allocator, frameCount };
 
 
@@ -196,6 +228,49 @@ namespace FlexKit
 				animation.tracks.emplace_back(std::move(track));
 			}
 
+			if (compressedEntries.size())
+			{
+				// Compressed tracks sample straight from a private copy of the stream
+				auto stream = (std::byte*)allocator.malloc(streamSize);
+				memcpy(stream, animationBlob->Buffer, streamSize);
+
+				animation.compressedStream = stream;
+
+				const auto tableHeader  = reinterpret_cast<const AnimationTimeTableHeader*>(stream + currentFileOffset);
+				size_t tableOffset      = currentFileOffset + sizeof(AnimationTimeTableHeader);
+
+				Vector<const float*> timeTables{ &allocator, tableHeader->tableCount };
+
+				for (uint32_t I = 0; I < tableHeader->tableCount; ++I)
+				{
+					const uint32_t timeCount = *reinterpret_cast<const uint32_t*>(stream + tableOffset);
+
+					timeTables.push_back(reinterpret_cast<const float*>(stream + tableOffset + sizeof(uint32_t)));
+					tableOffset += sizeof(uint32_t) + timeCount * sizeof(float);
+				}
+
+				for (auto& entry : compressedEntries)
+				{
+					const auto header           = reinterpret_cast<const AnimationTrackHeader*>(stream + entry.offset);
+					const auto compressedHeader = reinterpret_cast<const CompressedTrackHeader*>(stream + entry.offset + sizeof(AnimationTrackHeader));
+
+					CompressedAnimationTrack track{
+						.times      = timeTables[compressedHeader->timeTable],
+						.keys       = reinterpret_cast<const uint16_t*>(compressedHeader + 1),
+						.keyCount   = compressedHeader->keyCount,
+						.encoding   = entry.encoding,
+						.type       = header->type,
+						.trackName  = header->trackName,
+						.target     = header->target,
+					};
+
+					memcpy(track.rangeMin,      compressedHeader->rangeMin,     sizeof(track.rangeMin));
+					memcpy(track.rangeExtent,   compressedHeader->rangeExtent,  sizeof(track.rangeExtent));
+
+					animation.compressedTracks.push_back(track);
+				}
+			}
+
 			return &animation;
 		}
 
@@ -225,54 +300,48 @@ namespace FlexKit
 		const uint32_t  ID              = rand();
 
 		auto& allocator = GetComponent().allocator;
-		Vector<AnimationState::TrackState> tracks{ &allocator };
 
+		AnimationState animState{
+			.T              = 0.0f,
+			.ID             = ID,
+			.state          = loop ? AnimationState::State::Looping : AnimationState::State::Playing,
+			.trackGroups    = { &allocator, &allocator },
+			.resource       = &anim,
+			.duration       = anim.Duration(),
+		};
 
 		auto& gameObject    = *componentData.gameObject;
 		auto  skeleton      = GetSkeleton(gameObject);
 
-		for (auto& track : anim.tracks)
+		auto AddTrack = [&](auto& track, const TrackType type, const char* trackName, const char* target)
 		{
-			switch (track.type)
+			switch (type)
 			{
 			case TrackType::Skeletal:
 			{
-				auto joint = skeleton->FindJoint(track.target.c_str());
+				auto joint = skeleton->FindJoint(target);
 
 				if (joint == InvalidHandle)
-					continue;
-				if (track.trackName == "translation")
-				{
-					AnimationState::TrackState trackState;
-					trackState.target   = &allocator.allocate<AnimationState::JointTranslationTarget>(joint);
-					trackState.track    = &track;
-					tracks.push_back(trackState);
-				}
-				else if (track.trackName == "rotation")
-				{
-					AnimationState::TrackState trackState;
-					trackState.target   = &allocator.allocate<AnimationState::JointRotationTarget>(joint);
-					trackState.track    = &track;
-					tracks.push_back(trackState);
-				}
-				else if (track.trackName == "scale")
-				{
-					AnimationState::TrackState trackState;
-					trackState.target   = &allocator.allocate<AnimationState::JointScaleTarget>(joint);
-					trackState.track    = &track;
-					tracks.push_back(trackState);
-				}
+					return;
+				if (!strcmp(trackName, "rotation"))
+					animState.trackGroups[AnimationState::JointRotation].push_back(track, joint);
+				else if (!strcmp(trackName, "scale"))
+					animState.trackGroups[AnimationState::JointScale].push_back(track, joint);
 			}   break;
-			}  
+			}
+		};
+
+		for (auto& track : anim.tracks)
+		{
+			if (track.keyFrames.size())
+				AddTrack(track, track.type, track.trackName.c_str(), track.target.c_str());
 		}
 
-		AnimationState animState{
-			.T          = 0.0f,
-			.ID         = ID,
-			.state      = loop ? AnimationState::State::Looping : AnimationState::State::Playing,
-			.tracks     = std::move(tracks),
-			.resource   = &anim,
-		};
+		for (auto& track : anim.compressedTracks)
+		{
+			if (track.keyCount)
+				AddTrack(track, track.type, track.trackName, track.target);
+		}
 
 		componentData.animations.emplace_back(std::move(animState));
 
@@ -451,92 +520,153 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
-	void AnimatorComponent::AnimationState::JointRotationTarget::Apply(AnimatorComponent::AnimationState::FrameRange range, float t, AnimationStateContext& ctx)
+	AnimationKeyFrame* AnimatorComponent::AnimationState::TrackState::FindFrame(double T)
 	{
-		if (auto res = ctx.FindField<FlexKit::PoseState::Pose>(); res) {
-			auto beginKey   = range.begin->Value;
-			auto endKey     = range.end->Value;
+		auto& keyFrames         = track->keyFrames;
+		const uint32_t count    = (uint32_t)keyFrames.size();
 
-			auto interpolate =
-				[&]() -> Quaternion
+		// Forward playback lands on the cached key or one just after it
+		if (cursor < count && keyFrames[cursor].Begin <= T)
+		{
+			const uint32_t end = Min(cursor + 4, count);
+
+			for (uint32_t I = cursor; I < end; ++I)
+			{
+				if (keyFrames[I].End > T)
 				{
-					const auto timepointBegin   = range.begin->Begin;
-					const auto timepointEnd     = range.end->Begin;
-					const auto timeRange        = timepointEnd - timepointBegin;
+					if (keyFrames[I].Begin > T)
+						break;
+
+					cursor = I;
+					return &keyFrames[I];
+				}
+			}
+		}
+
+		// Seek, last key beginning at or before T
+		auto res = std::upper_bound(
+			keyFrames.begin(), keyFrames.end(), T,
+			[](const double t, const AnimationKeyFrame& frame)
+			{
+				return t < frame.Begin;
+			});
 
-					const auto I = clamp(0.0f, (t - range.begin->Begin) / timeRange, 1.0f);
+		if (res != keyFrames.begin() && (res - 1)->End > T)
+		{
+			cursor = uint32_t(res - 1 - keyFrames.begin());
+			return res - 1;
+		}
 
-					const auto& AValue = range.begin->Value;
-					const auto& BValue = range.end->Value;
+		cursor = count - 1;
 
-					const auto A = Quaternion{ AValue[0], AValue[1], AValue[2], AValue[3] };
-					const auto B = Quaternion{ BValue[0], BValue[1], BValue[2], BValue[3] };
+		return &keyFrames.back();
+	}
 
-					return Qlerp(A, B, I);
-				};
 
-			const auto value        = range.begin->Begin == range.end->Begin ? range.begin->Value : interpolate();
-			const auto defaultPose  = res->sk->JointPoses[joint];
+	/************************************************************************************************/
 
-			res->jointPose[joint].r *= Quaternion{ value[0], value[1], value[2], value[3] };
-		}
+
+	AnimationKeyFrame* AnimatorComponent::AnimationState::TrackState::FindNextFrame(AnimationKeyFrame* frame)
+	{
+		if (frame + 1 < track->keyFrames.end())
+			return frame + 1;
+		else
+			return frame;
 	}
 
 
 	/************************************************************************************************/
 
 
-	void AnimatorComponent::AnimationState::JointTranslationTarget::Apply(AnimatorComponent::AnimationState::FrameRange range, float t, AnimationStateContext& ctx)
+	uint32_t AnimatorComponent::AnimationState::TrackState::FindCompressedKey(double T)
 	{
-		if (auto res = ctx.FindField<FlexKit::PoseState::Pose>(); res)
-		{
-			const auto timepointBegin   = range.begin->Begin;
-			const auto timepointEnd     = range.end->Begin;
-			const auto timeRange        = timepointEnd - timepointBegin;
-			const auto u                = clamp(0.0f, (t - range.begin->Begin) / timeRange, 1.0f);
+		const float*    times = compressed->times;
+		const uint32_t  count = compressed->keyCount;
 
-			const auto defaultPose  = res->sk->JointPoses[joint];
-			const auto xyz          = lerp(range.begin->Value.xyz(), range.end->Value.xyz(), u);
+		// Key I covers [times[I], times[I + 1]), same cursor fast path as FindFrame
+		if (cursor < count && times[cursor] <= T)
+		{
+			const uint32_t end = Min(cursor + 4, count);
 
-			//res->jointPose[joint].ts += xyz - defaultPose.ts.xyz();
+			for (uint32_t I = cursor; I < end; ++I)
+			{
+				if (times[I + 1] > T)
+				{
+					cursor = I;
+					return I;
+				}
+			}
 		}
+
+		auto res = std::upper_bound(times, times + count, T,
+			[](const double t, const float time)
+			{
+				return t < time;
+			});
+
+		cursor = res == times ? 0 : uint32_t(res - times - 1);
+
+		return cursor;
 	}
 
 
 	/************************************************************************************************/
 
 
-	void AnimatorComponent::AnimationState::JointScaleTarget::Apply(AnimatorComponent::AnimationState::FrameRange range, float t, AnimationStateContext& ctx)
+	inline float KeyFrameInterpolant(const float begin, const float end, const float t)
 	{
-		if (auto res = ctx.FindField<PoseState::Pose>(); res)
-			res->jointPose[joint].ts.w = range.begin->Value.w;
+		const auto timeRange = end - begin;
+
+		return timeRange != 0.0f ? clamp(0.0f, (t - begin) / timeRange, 1.0f) : 0.0f;
 	}
 
 
 	/************************************************************************************************/
 
 
-	AnimationKeyFrame* AnimatorComponent::AnimationState::TrackState::FindFrame(double T)
+	AnimatorComponent::AnimationState::TrackSample AnimatorComponent::AnimationState::TrackState::Sample(double T)
 	{
-		for (auto& frame : track->keyFrames)
+		if (compressed)
 		{
-			if (frame.Begin <= T && frame.End > T)
-				return &frame;
-		}
-
-		return &track->keyFrames.back();
-	}
+			const uint32_t begin	= FindCompressedKey(T);
+			const uint32_t end		= Min(begin + 1, compressed->keyCount - 1);
 
+			if (begin != decodedKey)
+			{
+				decodedKey	= begin;
+				decoded[0]	= compressed->DecodeKey(begin);
+				decoded[1]	= compressed->DecodeKey(end);
 
-	/************************************************************************************************/
+				// Quantization picks either hemisphere, keep the interpolation on the short arc
+				if (compressed->encoding == TrackEncoding::QuantizedQuaternion)
+				{
+					float d = 0.0f;
+					for (size_t I = 0; I < 4; ++I)
+						d += decoded[0][I] * decoded[1][I];
 
+					if (d < 0.0f)
+						for (size_t I = 0; I < 4; ++I)
+							decoded[1][I] = -decoded[1][I];
+				}
+			}
 
-	AnimationKeyFrame* AnimatorComponent::AnimationState::TrackState::FindNextFrame(AnimationKeyFrame* frame)
-	{
-		if (frame + 1 < track->keyFrames.end())
-			return frame + 1;
+			return {
+				.begin	= decoded[0],
+				.end	= decoded[1],
+				.u		= begin != end ? KeyFrameInterpolant(compressed->times[begin], compressed->times[end], (float)T) : 0.0f,
+			};
+		}
 		else
-			return frame;
+		{
+			const auto begin	= FindFrame(T);
+			const auto end		= FindNextFrame(begin);
+
+			return {
+				.begin	= begin->Value,
+				.end	= end->Value,
+				.u		= KeyFrameInterpolant(begin->Begin, end->Begin, (float)T),
+			};
+		}
 	}
 
 
@@ -548,21 +678,44 @@ namespace FlexKit
 		if (state == State::Finished)
 			return state;
 
-		float endT = 0;
-		for (auto& track : tracks)
+		auto pose = ctx.FindField<PoseState::Pose>();
+
+		if (pose)
 		{
-			endT = Max(track.track->keyFrames.back().End, endT);
+			const float t = T;
 
-			if (auto frame = track.FindFrame(T); frame)
-				track.target->Apply({ frame, track.FindNextFrame(frame) }, T, ctx);
+			{	// Rotations
+				auto& group = trackGroups[JointRotation];
+
+				for (size_t I = 0; I < group.size(); ++I)
+				{
+					const auto sample = group.tracks[I].Sample(t);
+
+					const auto& A = sample.begin;
+					const auto& B = sample.end;
+
+					const auto value = sample.u == 0.0f ?
+						Quaternion{ A[0], A[1], A[2], A[3] } :
+						Qlerp(Quaternion{ A[0], A[1], A[2], A[3] }, Quaternion{ B[0], B[1], B[2], B[3] }, sample.u);
+
+					pose->jointPose[group.joints[I]].r *= value;
+				}
+			}
+
+			{	// Scales
+				auto& group = trackGroups[JointScale];
+
+				for (size_t I = 0; I < group.size(); ++I)
+					pose->jointPose[group.joints[I]].ts.w = group.tracks[I].Sample(t).begin.w;
+			}
 		}
 
 		if(state != State::Paused)
 			T += dT;
 
-		if (state == State::Looping && T >= endT)
+		if (state == State::Looping && T >= duration)
 			T = 0.0;
-		else if (state == State::Playing && T >= endT)
+		else if (state == State::Playing && T >= duration)
 			state = State::Finished;
 
 		return state;
@@ -585,7 +738,12 @@ namespace FlexKit
 	{
 		struct _ {};
 		return updateTask.Add<_>(
-			[](auto&, auto&) {},
+			[](auto& builder, auto&)
+			{
+				builder.SetDebugString("Update Animations");
+				builder.Writes(AnimatorComponentID);
+				builder.Writes(SkeletonComponentID);
+			},
 			[dT = dT](auto&, iAllocator& temporaryAllocator)
 			{
 				ProfileFunction();
@@ -711,7 +869,11 @@ namespace FlexKit
 				data.skinned        = PosedBrushList{ data.taskMemory };
 				data.camera			= C;
 
-				builder.SetDebugString("Gather Scene");
+				builder.SetDebugString("Gather Skinned");
+				builder.Reads(SceneVisibilityComponentID);
+				builder.Reads(BrushComponentID);
+				builder.Reads(CameraComponentID);
+				builder.Reads(SkeletonComponentID);
 			},
 			[](GatherSkinnedTaskData& data, iAllocator& threadAllocator)
 			{
@@ -731,6 +893,181 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	// Pose composition runs on blocks of 4 joints stored component-wise, one joint per lane
+	struct JointPoseBlock
+	{
+		__m128 qx, qy, qz, qw;
+		__m128 tx, ty, tz, s;
+	};
+
+
+	inline JointPoseBlock IdentityJointPoseBlock()
+	{
+		const __m128 zero	= _mm_setzero_ps();
+		const __m128 one	= _mm_set1_ps(1.0f);
+
+		return { zero, zero, zero, one, zero, zero, zero, one };
+	}
+
+
+	inline JointPoseBlock LoadJointPoseBlock(const JointPose* poses, const size_t count)
+	{
+		JointPose padded[4];
+
+		if (count < 4)
+		{
+			for (size_t I = 0; I < 4; ++I)
+				padded[I] = I < count ? poses[I] : JointPose{ { 0, 0, 0, 1 }, { 0, 0, 0, 1 } };
+
+			poses = padded;
+		}
+
+		__m128 q0 = poses[0].r, q1 = poses[1].r, q2 = poses[2].r, q3 = poses[3].r;
+		__m128 t0 = poses[0].ts, t1 = poses[1].ts, t2 = poses[2].ts, t3 = poses[3].ts;
+
+		_MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+		_MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+
+		return { q0, q1, q2, q3, t0, t1, t2, t3 };
+	}
+
+
+	inline void StoreJointPoseBlock(const JointPoseBlock& block, JointPose* out, const size_t count)
+	{
+		__m128 q[4] = { block.qx, block.qy, block.qz, block.qw };
+		__m128 t[4] = { block.tx, block.ty, block.tz, block.s };
+
+		_MM_TRANSPOSE4_PS(q[0], q[1], q[2], q[3]);
+		_MM_TRANSPOSE4_PS(t[0], t[1], t[2], t[3]);
+
+		for (size_t I = 0; I < count; ++I)
+			out[I] = JointPose{ Quaternion{ q[I] }, float4{ t[I] } };
+	}
+
+
+	// Same as lhs.r *= rhs.r, lhs.ts.w *= rhs.ts.w, lhs.ts.xyz += rhs.ts.xyz for each lane
+	inline void AccumulateJointPoseBlock(JointPoseBlock& lhs, const JointPoseBlock& rhs)
+	{
+		// v = Pv * Qw + Qv * Pw + Pv x Qv, w = Pw * Qw - Pv . Qv
+		const __m128 x = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(lhs.qx, rhs.qw), _mm_mul_ps(rhs.qx, lhs.qw)),
+			_mm_sub_ps(_mm_mul_ps(lhs.qy, rhs.qz), _mm_mul_ps(lhs.qz, rhs.qy)));
+
+		const __m128 y = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(lhs.qy, rhs.qw), _mm_mul_ps(rhs.qy, lhs.qw)),
+			_mm_sub_ps(_mm_mul_ps(lhs.qz, rhs.qx), _mm_mul_ps(lhs.qx, rhs.qz)));
+
+		const __m128 z = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(lhs.qz, rhs.qw), _mm_mul_ps(rhs.qz, lhs.qw)),
+			_mm_sub_ps(_mm_mul_ps(lhs.qx, rhs.qy), _mm_mul_ps(lhs.qy, rhs.qx)));
+
+		const __m128 w = _mm_sub_ps(
+			_mm_mul_ps(lhs.qw, rhs.qw),
+			_mm_add_ps(_mm_add_ps(_mm_mul_ps(lhs.qx, rhs.qx), _mm_mul_ps(lhs.qy, rhs.qy)), _mm_mul_ps(lhs.qz, rhs.qz)));
+
+		lhs.qx	= x;
+		lhs.qy	= y;
+		lhs.qz	= z;
+		lhs.qw	= w;
+		lhs.tx	= _mm_add_ps(lhs.tx, rhs.tx);
+		lhs.ty	= _mm_add_ps(lhs.ty, rhs.ty);
+		lhs.tz	= _mm_add_ps(lhs.tz, rhs.tz);
+		lhs.s	= _mm_mul_ps(lhs.s, rhs.s);
+	}
+
+
+	// Same as GetPoseTransform for each lane: Scale * Rotation(normalize(r)) * Translation
+	// Scaling the products by 2 / |q|^2 normalizes the rotation without a square root
+	inline void BuildPoseTransformBlock(const JointPoseBlock& block, float4x4 (&out)[4])
+	{
+		const __m128 zero	= _mm_setzero_ps();
+		const __m128 one	= _mm_set1_ps(1.0f);
+
+		const __m128 n = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(block.qx, block.qx), _mm_mul_ps(block.qy, block.qy)),
+			_mm_add_ps(_mm_mul_ps(block.qz, block.qz), _mm_mul_ps(block.qw, block.qw)));
+
+		const __m128 s2 = _mm_and_ps(_mm_div_ps(_mm_set1_ps(2.0f), n), _mm_cmpgt_ps(n, zero));
+
+		const __m128 xs = _mm_mul_ps(block.qx, s2);
+		const __m128 ys = _mm_mul_ps(block.qy, s2);
+		const __m128 zs = _mm_mul_ps(block.qz, s2);
+
+		const __m128 wx = _mm_mul_ps(block.qw, xs);
+		const __m128 wy = _mm_mul_ps(block.qw, ys);
+		const __m128 wz = _mm_mul_ps(block.qw, zs);
+		const __m128 xx = _mm_mul_ps(block.qx, xs);
+		const __m128 xy = _mm_mul_ps(block.qx, ys);
+		const __m128 xz = _mm_mul_ps(block.qx, zs);
+		const __m128 yy = _mm_mul_ps(block.qy, ys);
+		const __m128 yz = _mm_mul_ps(block.qy, zs);
+		const __m128 zz = _mm_mul_ps(block.qz, zs);
+
+		__m128 r0[4] = {
+			_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), block.s),
+			_mm_mul_ps(_mm_add_ps(xy, wz), block.s),
+			_mm_mul_ps(_mm_sub_ps(xz, wy), block.s),
+			zero };
+
+		__m128 r1[4] = {
+			_mm_mul_ps(_mm_sub_ps(xy, wz), block.s),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), block.s),
+			_mm_mul_ps(_mm_add_ps(yz, wx), block.s),
+			zero };
+
+		__m128 r2[4] = {
+			_mm_mul_ps(_mm_add_ps(xz, wy), block.s),
+			_mm_mul_ps(_mm_sub_ps(yz, wx), block.s),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), block.s),
+			zero };
+
+		__m128 r3[4] = { block.tx, block.ty, block.tz, one };
+
+		_MM_TRANSPOSE4_PS(r0[0], r0[1], r0[2], r0[3]);
+		_MM_TRANSPOSE4_PS(r1[0], r1[1], r1[2], r1[3]);
+		_MM_TRANSPOSE4_PS(r2[0], r2[1], r2[2], r2[3]);
+		_MM_TRANSPOSE4_PS(r3[0], r3[1], r3[2], r3[3]);
+
+		for (size_t I = 0; I < 4; ++I)
+		{
+			float* m = out[I];
+			_mm_storeu_ps(m + 0,  r0[I]);
+			_mm_storeu_ps(m + 4,  r1[I]);
+			_mm_storeu_ps(m + 8,  r2[I]);
+			_mm_storeu_ps(m + 12, r3[I]);
+		}
+	}
+
+
+	// out = lhs * rhs, out may alias lhs
+	inline void MultiplyPoseTransform(const float4x4& lhs, const float4x4& rhs, float4x4& out)
+	{
+		const float* a = lhs;
+		const float* b = rhs;
+
+		const __m128 b0 = _mm_loadu_ps(b + 0);
+		const __m128 b1 = _mm_loadu_ps(b + 4);
+		const __m128 b2 = _mm_loadu_ps(b + 8);
+		const __m128 b3 = _mm_loadu_ps(b + 12);
+
+		float* m = out;
+
+		for (size_t I = 0; I < 4; ++I)
+		{
+			const float* row = a + 4 * I;
+
+			const __m128 r = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(row[0]), b0), _mm_mul_ps(_mm_set1_ps(row[1]), b1)),
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(row[2]), b2), _mm_mul_ps(_mm_set1_ps(row[3]), b3)));
+
+			_mm_storeu_ps(m + 4 * I, r);
+		}
+	}
+
+
+	/************************************************************************************************/
+
+
 	void UpdatePose(PoseState& pose, iAllocator& tempMemory)
 	{
 		ProfileFunction();
@@ -738,33 +1075,42 @@ namespace FlexKit
 		Skeleton* skeleton      = pose.Sk;
 		const size_t jointCount = skeleton->JointCount;
 
-		auto temp = (JointPose*)tempMemory._aligned_malloc(sizeof(PoseState) * pose.JointCount);
-		for (size_t I = 0; I < pose.JointCount; ++I)
-			temp[I] = JointPose{ { 0, 0, 0, 1 }, { 0, 0, 0 , 1 } };
+		FK_ASSERT(jointCount <= pose.JointCount);
 
-		// Add all poses up
-		for (auto& subPose : pose.poses)
+		for (size_t begin = 0; begin < pose.JointCount; begin += 4)
 		{
-			for (size_t I = 0; I < pose.JointCount; ++I)
-			{
-				temp[I].r       *= subPose.jointPose[I].r;
-				temp[I].ts.w    *= subPose.jointPose[I].ts.w;
-				temp[I].ts      += subPose.jointPose[I].ts.xyz();
-			}
-		}
+			const size_t count = Min(pose.JointCount - begin, 4);
 
-		for (size_t I = 0; I < pose.JointCount; ++I)
-			pose.Joints[I] = temp[I];
+			// Add all poses up
+			JointPoseBlock block = IdentityJointPoseBlock();
 
-		for (size_t I = 0; I < jointCount; ++I)
-		{
-			const auto poseT        = GetPoseTransform(pose.Joints[I]);
-			const auto skeletonT    = GetPoseTransform(skeleton->JointPoses[I]);
+			for (auto& subPose : pose.poses)
+				AccumulateJointPoseBlock(block, LoadJointPoseBlock(subPose.jointPose + begin, count));
 
-			const auto parent       = skeleton->Joints[I].mParent;
-			const auto P            = (parent != 0xFFFF) ? pose.CurrentPose[parent] : float4x4::Identity();
+			StoreJointPoseBlock(block, pose.Joints + begin, count);
 
-			pose.CurrentPose[I]     = poseT * skeletonT * P;
+			if (begin >= jointCount)
+				continue;
+
+			float4x4 poseT[4];
+			float4x4 skeletonT[4];
+
+			const size_t skeletonCount = Min(jointCount - begin, 4);
+
+			BuildPoseTransformBlock(block, poseT);
+			BuildPoseTransformBlock(LoadJointPoseBlock(skeleton->JointPoses + begin, skeletonCount), skeletonT);
+
+			// Parents always precede their children, so any parent is already in model space here
+			for (size_t I = 0; I < skeletonCount; ++I)
+			{
+				const auto joint	= begin + I;
+				const auto parent	= skeleton->Joints[joint].mParent;
+
+				MultiplyPoseTransform(poseT[I], skeletonT[I], pose.CurrentPose[joint]);
+
+				if (parent != 0xFFFF)
+					MultiplyPoseTransform(pose.CurrentPose[joint], pose.CurrentPose[parent], pose.CurrentPose[joint]);
+			}
 		}
 	}
 
@@ -778,8 +1124,11 @@ namespace FlexKit
 			[&](auto& builder, UpdatePosesTaskData& data)
 			{
 				data.skinned        = &skinnedObjects.GetData().skinned;
+				data.threads        = dispatcher.threads;
 
 				builder.SetDebugString("Update Poses");
+				builder.Reads(TransformComponentID);
+				builder.Writes(SkeletonComponentID);
 			},
 			[](UpdatePosesTaskData& data, iAllocator& threadAllocator)
 			{
@@ -787,8 +1136,16 @@ namespace FlexKit
 
 				FK_LOG_9("Start Pose Updates.\n");
 
-				for (auto& skinnedObject : *data.skinned)
-					UpdatePose(*skinnedObject.pose, threadAllocator);
+				// Each skinned object owns its pose, objects can update independently
+				Parallel_For(
+					*data.threads,
+					threadAllocator,
+					data.skinned->begin(),
+					data.skinned->end(),
+					[](const PosedBrush& skinnedObject, iAllocator& allocator)
+					{
+						UpdatePose(*skinnedObject.pose, allocator);
+					});
 
 				FK_LOG_9("End Pose Updates.\n");
 			});
@@ -861,8 +1218,7 @@ namespace FlexKit
 					*dispatcher.threads,
 					allocator,
 					IKControllers.instances.begin(),
-					IKControllers.instances.end(), 
-					1,
+					IKControllers.instances.end(),
 					[&](IKInstance& IKController, iAllocator& allocator)
 					{
 						ProfileFunction();
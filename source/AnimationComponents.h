@@ -24,14 +24,49 @@ namespace FlexKit
 		std::string                 target;
 	};
 
+	// View into a clip's compressed stream, see CompressedTrackHeader
+	struct CompressedAnimationTrack
+	{
+		float4 DecodeKey(const size_t idx) const noexcept
+		{
+			return encoding == TrackEncoding::QuantizedQuaternion ?
+				DequantizeQuaternion(keys + idx * 3) :
+				DequantizeVector(keys + idx * 4, rangeMin, rangeExtent);
+		}
+
+		const float*    times;      // keyCount begin times then the end of the last key, shared between tracks
+		const uint16_t* keys;
+		float           rangeMin[4];
+		float           rangeExtent[4];
+		uint32_t        keyCount;
+		TrackEncoding   encoding;
+		TrackType       type;
+		const char*     trackName;
+		const char*     target;
+	};
+
 	struct Animation
 	{
 		Animation(iAllocator& IN_allocator) :
-			tracks{ &IN_allocator } {}
+			tracks				{ &IN_allocator },
+			compressedTracks	{ &IN_allocator },
+			allocator			{ &IN_allocator } {}
+
+		~Animation()
+		{
+			if (compressedStream)
+				allocator->free(compressedStream);
+		}
+
+		Animation(const Animation&)				= delete;
+		Animation& operator = (const Animation&)	= delete;
 
 		float Duration();
 
-		Vector<AnimationTrack> tracks;
+		Vector<AnimationTrack>				tracks;
+		Vector<CompressedAnimationTrack>	compressedTracks;
+		std::byte*							compressedStream = nullptr; // Backs compressedTracks, allocated from allocator
+		iAllocator*							allocator;
 	};
 
 
@@ -236,6 +271,7 @@ namespace FlexKit
 	struct UpdatePosesTaskData
 	{
 		const PosedBrushList*	skinned;
+		ThreadManager*			threads;
 
 		UpdateTask*         task;
 		operator UpdateTask* () { return task; }
@@ -368,58 +404,68 @@ namespace FlexKit
 				Looping
 			}   state = State::Playing;
 
-			struct FrameRange
+			struct TrackSample
 			{
-				AnimationKeyFrame* begin;
-				AnimationKeyFrame* end;
+				float4  begin;
+				float4  end;
+				float   u;
 			};
 
-			struct ITrackTarget
+			struct TrackState
 			{
-				virtual void Apply(FrameRange range, float t, AnimationStateContext& ctx) = 0;
-			};
+				AnimationKeyFrame* FindFrame(double T);
+				AnimationKeyFrame* FindNextFrame(AnimationKeyFrame* frame);
+				uint32_t           FindCompressedKey(double T);
 
-			struct JointRotationTarget : public ITrackTarget
-			{
-				JointRotationTarget(JointHandle in_Joint) : joint { in_Joint }{}
+				TrackSample Sample(double T);
 
-				void Apply(FrameRange range, float t, AnimationStateContext& ctx) final override;
+				AnimationTrack*                 track       = nullptr;
+				const CompressedAnimationTrack* compressed  = nullptr;
+				uint32_t                        cursor      = 0; // Last sampled key, forward playback only ever steps it ahead
 
-				JointHandle joint;
+				uint32_t                        decodedKey  = uint32_t(-1); // Compressed keys of the current segment, decoded once per key change
+				float4                          decoded[2];
 			};
 
-			struct JointTranslationTarget : public ITrackTarget
+			// Translation tracks are not applied to poses yet, Play drops them instead of bucketing them
+			enum TrackTarget : uint32_t
 			{
-				JointTranslationTarget(JointHandle in_Joint) : joint{ in_Joint } {}
-
-				void Apply(FrameRange range, float t, AnimationStateContext& ctx) final override;
-
-				JointHandle joint;
+				JointRotation,
+				JointScale,
+				TrackTargetCount
 			};
 
-			struct JointScaleTarget : public ITrackTarget
+			// Tracks are bucketed by target at Play so Update evaluates each bucket in a single non-virtual loop
+			struct TrackGroup
 			{
-				JointScaleTarget(JointHandle in_Joint) : joint{ in_Joint } {}
+				TrackGroup(iAllocator* allocator = nullptr) :
+					tracks	{ allocator },
+					joints	{ allocator } {}
 
-				void Apply(FrameRange range, float t, AnimationStateContext& ctx) final override;
+				void push_back(AnimationTrack& track, JointHandle joint)
+				{
+					tracks.push_back({ .track = &track });
+					joints.push_back(joint);
+				}
 
-				JointHandle joint;
-			};
+				void push_back(const CompressedAnimationTrack& track, JointHandle joint)
+				{
+					tracks.push_back({ .compressed = &track });
+					joints.push_back(joint);
+				}
 
-			struct TrackState
-			{
-				AnimationKeyFrame* FindFrame(double T);
-				AnimationKeyFrame* FindNextFrame(AnimationKeyFrame* frame);
+				size_t size() const noexcept { return tracks.size(); }
 
-				AnimationTrack* track;
-				ITrackTarget*   target;
+				Vector<TrackState>	tracks;
+				Vector<JointHandle>	joints;
 			};
 
 
 			State Update(AnimationStateContext& ctx, double dT);
 
-			Vector<TrackState>  tracks;
+			TrackGroup          trackGroups[TrackTargetCount];
 			Animation*          resource;
+			float               duration = 0.0f;
 		};
 
 		struct InputID
@@ -1,7 +1,11 @@
 #include "AnimationUtilities.h"
 #include "graphics.h"
+#include "Serialization.hpp"
 #include "XMMathConversion.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace FlexKit
 {   /************************************************************************************************/
 
@@ -244,6 +248,320 @@ namespace FlexKit
 	}
 
 
+	/************************************************************************************************/
+
+
+	struct QuantizedTrack
+	{
+		TrackEncoding			encoding;
+		CompressedTrackHeader	header		= {};
+		float					tolerance	= 0.0f;
+		bool					rotation	= false;
+		bool					constant	= false;
+
+		std::vector<float4>		source;		// Normalized source keys, errors are measured against these
+		std::vector<float4>		decoded;	// What sampling reconstructs from the quantized keys
+		std::vector<uint16_t>	quantized;
+	};
+
+
+	// Error of the interpolation between a and b against a source key, angle in radians for rotations
+	static float InterpolationError(const bool rotation, const float4 value, const float4 a, const float4 b, const float u)
+	{
+		if (rotation)
+		{
+			float d = 0.0f;
+			for (size_t J = 0; J < 4; ++J)
+				d += a[J] * b[J];
+
+			const float bSign = d < 0.0f ? -1.0f : 1.0f;
+
+			// Double precision, acos in float can't resolve angles this small
+			double q[4];
+			double lengthSq = 0.0;
+			for (size_t J = 0; J < 4; ++J)
+			{
+				q[J] = double(a[J]) * (1.0 - u) + double(b[J]) * bSign * u;
+				lengthSq += q[J] * q[J];
+			}
+
+			double cosHalfAngle = 0.0;
+			for (size_t J = 0; J < 4; ++J)
+				cosHalfAngle += q[J] * double(value[J]);
+
+			cosHalfAngle = Min(fabs(cosHalfAngle) / sqrt(lengthSq), 1.0);
+
+			return float(2.0 * acos(cosHalfAngle));
+		}
+		else
+		{
+			float error = 0.0f;
+			for (size_t J = 0; J < 4; ++J)
+				error = Max(error, fabsf(a[J] * (1.0f - u) + b[J] * u - value[J]));
+
+			return error;
+		}
+	}
+
+
+	static QuantizedTrack QuantizeTrack(const AnimationTrackSource& track, const AnimationCompressionSettings& settings)
+	{
+		const auto& keyFrames	= track.keyFrames;
+		const size_t keyCount	= keyFrames.size();
+
+		QuantizedTrack out;
+		out.rotation	= !strcmp(track.trackName, "rotation");
+		out.encoding	= out.rotation ? TrackEncoding::QuantizedQuaternion : TrackEncoding::QuantizedVector;
+		out.tolerance	= out.rotation ? settings.rotationTolerance : settings.vectorTolerance;
+
+		const size_t stride = CompressedKeyStride(out.encoding);
+
+		out.source.resize(keyCount);
+		out.decoded.resize(keyCount);
+		out.quantized.resize(keyCount * stride);
+
+		for (size_t I = 0; I < keyCount; ++I)
+			out.source[I] = keyFrames[I].Value;
+
+		if (out.rotation)
+		{
+			for (size_t I = 0; I < keyCount; ++I)
+			{
+				float4 q		= out.source[I];
+				float lengthSq	= 0.0f;
+
+				for (size_t J = 0; J < 4; ++J)
+					lengthSq += q[J] * q[J];
+
+				const float length = sqrtf(lengthSq);
+
+				for (size_t J = 0; J < 4; ++J)
+					q[J] = length > 0.0f ? q[J] / length : (J == 3 ? 1.0f : 0.0f);
+
+				out.source[I] = q;
+
+				QuantizeQuaternion(q, &out.quantized[I * stride]);
+				out.decoded[I] = DequantizeQuaternion(&out.quantized[I * stride]);
+			}
+		}
+		else
+		{
+			for (size_t J = 0; J < 4; ++J)
+			{
+				float minimum = keyCount ? out.source[0][J] : 0.0f;
+				float maximum = minimum;
+
+				for (auto& value : out.source)
+				{
+					minimum = Min(minimum, value[J]);
+					maximum = Max(maximum, value[J]);
+				}
+
+				out.header.rangeMin[J]		= minimum;
+				out.header.rangeExtent[J]	= maximum - minimum;
+			}
+
+			for (size_t I = 0; I < keyCount; ++I)
+			{
+				QuantizeVector(out.source[I], out.header.rangeMin, out.header.rangeExtent, &out.quantized[I * stride]);
+				out.decoded[I] = DequantizeVector(&out.quantized[I * stride], out.header.rangeMin, out.header.rangeExtent);
+			}
+		}
+
+		out.constant = keyCount > 0;
+
+		for (size_t K = 0; K < keyCount && out.constant; ++K)
+			out.constant = InterpolationError(out.rotation, out.source[K], out.decoded[0], out.decoded[0], 0.0f) <= out.tolerance;
+
+		return out;
+	}
+
+
+	static Blob WriteTrack(const AnimationTrackSource& source, AnimationTrackHeader header, const Blob& keyFrameBlob)
+	{
+		header.type		= source.type;
+		header.byteSize	= (uint32_t)(sizeof(header) + keyFrameBlob.size());
+
+		strncpy_s(header.trackName,	source.trackName,	_TRUNCATE);
+		strncpy_s(header.target,	source.target,		_TRUNCATE);
+
+		Blob out{ header };
+		out += keyFrameBlob;
+
+		return out;
+	}
+
+
+	/************************************************************************************************/
+
+
+	Blob WriteAnimationTracks(std::span<const AnimationTrackSource> tracks, const AnimationCompressionSettings& settings)
+	{
+		const size_t trackCount = tracks.size();
+
+		std::vector<QuantizedTrack>	quantized(trackCount);
+		std::vector<size_t>			trackGroup(trackCount, (size_t)-1);
+
+		// Tracks keyed at the same source times are reduced together, so they keep the same keys
+		// and end up sharing one time table
+		std::vector<std::vector<float>> groupTimes;
+
+		if (settings.enabled)
+		{
+			for (size_t I = 0; I < trackCount; ++I)
+			{
+				const auto& keyFrames = tracks[I].keyFrames;
+
+				if (keyFrames.empty())
+					continue;
+
+				quantized[I] = QuantizeTrack(tracks[I], settings);
+
+				if (quantized[I].constant)
+					continue;
+
+				std::vector<float> times;
+				for (auto& keyFrame : keyFrames)
+					times.push_back(keyFrame.Begin);
+
+				times.push_back(keyFrames.back().End);
+
+				auto res = std::find(groupTimes.begin(), groupTimes.end(), times);
+				trackGroup[I] = (size_t)(res - groupTimes.begin());
+
+				if (res == groupTimes.end())
+					groupTimes.emplace_back(std::move(times));
+			}
+		}
+
+		// Greedily drops keys the linear interpolation of their kept neighbours reproduces within tolerance,
+		// for every track in the group. Errors are measured against the source keys, so they include quantization.
+		std::vector<std::vector<size_t>> groupKept(groupTimes.size());
+
+		for (size_t group = 0; group < groupTimes.size(); ++group)
+		{
+			const auto&		times		= groupTimes[group];
+			const size_t	keyCount	= times.size() - 1;
+
+			std::vector<const QuantizedTrack*> members;
+			for (size_t I = 0; I < trackCount; ++I)
+				if (trackGroup[I] == group)
+					members.push_back(&quantized[I]);
+
+			auto SegmentWithinTolerance = [&](const size_t a, const size_t b) -> bool
+			{
+				const float timeRange = times[b] - times[a];
+
+				for (size_t K = a + 1; K < b; ++K)
+				{
+					const float u = timeRange > 0.0f ? (times[K] - times[a]) / timeRange : 0.0f;
+
+					for (auto member : members)
+						if (InterpolationError(member->rotation, member->source[K], member->decoded[a], member->decoded[b], u) > member->tolerance)
+							return false;
+				}
+
+				return true;
+			};
+
+			auto& kept = groupKept[group];
+			kept.push_back(0);
+
+			size_t a = 0;
+			while (a + 1 < keyCount)
+			{
+				size_t b = a + 1;
+
+				while (b + 1 < keyCount && SegmentWithinTolerance(a, b + 1))
+					b++;
+
+				kept.push_back(b);
+				a = b;
+			}
+		}
+
+		Blob stream;
+
+		std::vector<std::vector<float>> timeTables;
+		const std::vector<size_t>		constantKept = { 0 };
+
+		for (size_t I = 0; I < trackCount; ++I)
+		{
+			const auto& source		= tracks[I];
+			const auto& keyFrames	= source.keyFrames;
+
+			AnimationTrackHeader trackHeader = {};
+			Blob keyFrameBlob;
+
+			if (!settings.enabled || keyFrames.empty())
+			{
+				for (auto& frame : keyFrames)
+					keyFrameBlob += Blob{ frame };
+
+				trackHeader.frameCount	= (uint32_t)keyFrames.size();
+				trackHeader.encoding	= TrackEncoding::Raw;
+
+				stream += WriteTrack(source, trackHeader, keyFrameBlob);
+				continue;
+			}
+
+			auto& track			= quantized[I];
+			const auto& kept	= track.constant ? constantKept : groupKept[trackGroup[I]];
+			const size_t stride	= CompressedKeyStride(track.encoding);
+
+			std::vector<float>		times;
+			std::vector<uint16_t>	keys;
+
+			for (auto idx : kept)
+			{
+				times.push_back(keyFrames[idx].Begin);
+
+				for (size_t J = 0; J < stride; ++J)
+					keys.push_back(track.quantized[idx * stride + J]);
+			}
+
+			times.push_back(keyFrames.back().End);
+
+			auto res = std::find(timeTables.begin(), timeTables.end(), times);
+			track.header.timeTable	= (uint32_t)(res - timeTables.begin());
+			track.header.keyCount	= (uint32_t)kept.size();
+
+			if (res == timeTables.end())
+				timeTables.emplace_back(std::move(times));
+
+			keyFrameBlob += Blob{ track.header };
+			keyFrameBlob += Blob{ (const char*)keys.data(), keys.size() * sizeof(uint16_t) };
+			keyFrameBlob.resize(sizeof(CompressedTrackHeader) + CompressedKeysByteSize(track.encoding, kept.size()));
+
+			trackHeader.frameCount	= track.header.keyCount;
+			trackHeader.encoding	= track.encoding;
+
+			stream += WriteTrack(source, trackHeader, keyFrameBlob);
+		}
+
+		if (timeTables.size())
+		{
+			Blob tableBlob;
+
+			for (auto& table : timeTables)
+			{
+				tableBlob += Blob{ (uint32_t)table.size() };
+				tableBlob += Blob{ (const char*)table.data(), table.size() * sizeof(float) };
+			}
+
+			const AnimationTimeTableHeader tableHeader = {
+				.tableCount	= (uint32_t)timeTables.size(),
+				.byteSize	= (uint32_t)(sizeof(AnimationTimeTableHeader) + tableBlob.size()),
+			};
+
+			stream += Blob{ tableHeader };
+			stream += tableBlob;
+		}
+
+		return stream;
+	}
+
+
 }	/************************************************************************************************/
 
 
@@ -29,6 +29,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Handle.h"
 #include "Assets.h"
 #include <DirectXMath/DirectXMath.h>
+#include <span>
+#include <vector>
 
 
 namespace FlexKit
@@ -46,6 +48,7 @@ namespace FlexKit
 	// PreDeclarations
 	struct	Brush;
 	struct	Skeleton;
+	class	Blob;
 
 	struct Joint
 	{
@@ -162,6 +165,13 @@ namespace FlexKit
         Skeletal
     };
 
+    enum class TrackEncoding : uint32_t
+    {
+        Raw,                    // AnimationKeyFrame[frameCount]
+        QuantizedQuaternion,    // CompressedTrackHeader, then uint16_t[3] per key
+        QuantizedVector,        // CompressedTrackHeader, then uint16_t[4] per key
+    };
+
     struct AnimationTrackHeader
     {
         char        trackName[64];
@@ -171,12 +181,148 @@ namespace FlexKit
 
         uint32_t    frameCount;
         uint32_t    byteSize;
+
+        TrackEncoding encoding = TrackEncoding::Raw;
+    };
+
+
+    /************************************************************************************************/
+
+
+    // Compressed tracks hold only the keys kept by the offline error bounded reduction,
+    // key times live in time tables shared by every track of the clip with the same reduced times.
+    struct CompressedTrackHeader
+    {
+        uint32_t    timeTable;      // Index into the clip's time tables
+        uint32_t    keyCount;
+        float       rangeMin[4];    // Dequantization range of vector tracks
+        float       rangeExtent[4];
+    };
+
+    // Follows the last track when any track of the clip is compressed.
+    // Each table is a uint32_t count followed by count times, keyCount key begin times then the end of the last key.
+    struct AnimationTimeTableHeader
+    {
+        uint32_t    tableCount;
+        uint32_t    byteSize;
+    };
+
+    inline size_t CompressedKeyStride(const TrackEncoding encoding) noexcept
+    {
+        return encoding == TrackEncoding::QuantizedQuaternion ? 3 : 4;
+    }
+
+    // Key payload is padded to keep the following track 4 byte aligned
+    inline size_t CompressedKeysByteSize(const TrackEncoding encoding, const size_t keyCount) noexcept
+    {
+        return (CompressedKeyStride(encoding) * keyCount * sizeof(uint16_t) + 3) & ~size_t(3);
+    }
+
+
+    /************************************************************************************************/
+
+
+    // Smallest three, the largest component is dropped and rebuilt from unit length. The three remaining
+    // components get 15 bits each and the dropped index goes in the spare top bits of the first two words.
+    // Expects a normalized quaternion, the result may be negated which is the same rotation.
+    inline void QuantizeQuaternion(const float4 q, uint16_t out[3]) noexcept
+    {
+        constexpr float range = 0.707106781f;
+
+        size_t largest = 0;
+        for (size_t I = 1; I < 4; ++I)
+            if (fabsf(q[I]) > fabsf(q[largest]))
+                largest = I;
+
+        const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+        for (size_t I = 0, J = 0; I < 4; ++I)
+        {
+            if (I == largest)
+                continue;
+
+            const float n = clamp(0.0f, q[I] * sign / range * 0.5f + 0.5f, 1.0f);
+            out[J++] = uint16_t(n * 32767.0f + 0.5f);
+        }
+
+        out[0] |= uint16_t((largest & 0x01) << 15);
+        out[1] |= uint16_t((largest >> 1)   << 15);
+    }
+
+
+    inline float4 DequantizeQuaternion(const uint16_t in[3]) noexcept
+    {
+        constexpr float range = 0.707106781f;
+
+        const size_t largest = (in[0] >> 15) | ((in[1] >> 15) << 1);
+
+        float components[3];
+        float sum = 0.0f;
+
+        for (size_t J = 0; J < 3; ++J)
+        {
+            components[J] = (float(in[J] & 0x7fff) / 32767.0f * 2.0f - 1.0f) * range;
+            sum += components[J] * components[J];
+        }
+
+        float4 out;
+        for (size_t I = 0, J = 0; I < 4; ++I)
+            out[I] = I == largest ? sqrtf(Max(0.0f, 1.0f - sum)) : components[J++];
+
+        return out;
+    }
+
+
+    inline void QuantizeVector(const float4 v, const float rangeMin[4], const float rangeExtent[4], uint16_t out[4]) noexcept
+    {
+        for (size_t I = 0; I < 4; ++I)
+        {
+            const float n = rangeExtent[I] > 0.0f ? clamp(0.0f, (v[I] - rangeMin[I]) / rangeExtent[I], 1.0f) : 0.0f;
+            out[I] = uint16_t(n * 65535.0f + 0.5f);
+        }
+    }
+
+
+    inline float4 DequantizeVector(const uint16_t in[4], const float rangeMin[4], const float rangeExtent[4]) noexcept
+    {
+        float4 out;
+        for (size_t I = 0; I < 4; ++I)
+            out[I] = rangeMin[I] + float(in[I]) / 65535.0f * rangeExtent[I];
+
+        return out;
+    }
+
+
+    /************************************************************************************************/
+
+
+    struct AnimationCompressionSettings
+    {
+        bool	enabled				= true;
+        float	rotationTolerance	= 0.001f;	// Max angular error in radians
+        float	vectorTolerance		= 0.0005f;	// Max per component error of translation and scale keys
     };
 
+    // One track of a clip as authored
+    struct AnimationTrackSource
+    {
+        std::span<const AnimationKeyFrame>  keyFrames;
+        const char*                         trackName;
+        const char*                         target;
+        TrackType                           type = TrackType::Skeletal;
+    };
+
+    // Writes the track stream that follows an AnimationResourceHeader. When compressing, tracks sampled at the same
+    // source times are reduced against one key set that satisfies all of them, so they share a single time table.
+    FLEXKITAPI Blob WriteAnimationTracks(std::span<const AnimationTrackSource> tracks, const AnimationCompressionSettings& settings);
+
 
     /************************************************************************************************/
 
 
+    // Bumped whenever the track stream layout changes, older resources are rejected at load and need a re-export
+    constexpr uint32_t AnimationResourceVersion = 2;
+
     struct AnimationResourceBlob
 	{
         struct AnimationResourceHeader
@@ -191,6 +337,7 @@ namespace FlexKit
             char   ID[FlexKit::ID_LENGTH];
 
             uint32_t trackCount;
+            uint32_t version;
 
             static size_t size() noexcept { return sizeof(AnimationResourceHeader); }
         }   header;
@@ -0,0 +1,661 @@
+#pragma once
+
+#include "buildsettings.h"
+#include "Components.h"
+#include "containers.h"
+#include "MemoryUtilities.h"
+
+#include <algorithm>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+namespace FlexKit
+{	/************************************************************************************************/
+
+
+	// Chunked storage for components. Objects with the same set of chunked components (an archetype)
+	// share 16KB chunks, each component is a contiguous column inside the chunk. Queries walk the
+	// columns directly instead of going GameObject -> view -> handle table -> component vector.
+
+
+	/************************************************************************************************/
+
+
+	using ArchetypeEntity = uint32_t;
+
+	constexpr ArchetypeEntity	InvalidArchetypeEntity	= 0xffffffff;
+	constexpr uint32_t			InvalidArchetype		= 0xffffffff;
+	constexpr uint32_t			InvalidColumn			= 0xffffffff;
+
+
+	struct ArchetypeColumnType
+	{
+		ComponentID	ID;
+		uint32_t	size;
+		uint32_t	alignment;
+
+		void (*MoveConstruct)(void* dest, void* src);
+		void (*Destruct)(void* ptr);
+
+		template<typename TY>
+		static ArchetypeColumnType Create(const ComponentID ID)
+		{
+			return {
+				.ID				= ID,
+				.size			= (uint32_t)sizeof(TY),
+				.alignment		= (uint32_t)alignof(TY),
+				.MoveConstruct	= [](void* dest, void* src) { new(dest) TY(std::move(*static_cast<TY*>(src))); },
+				.Destruct		= [](void* ptr) { static_cast<TY*>(ptr)->~TY(); }
+			};
+		}
+	};
+
+
+	/************************************************************************************************/
+
+
+	class Archetype
+	{
+	public:
+		static constexpr size_t ChunkSize = 16 * 1024;
+
+		struct Chunk
+		{
+			std::byte*	buffer;
+			uint32_t	count;
+		};
+
+
+		Archetype(std::span<const ArchetypeColumnType> IN_columns, iAllocator* IN_allocator) :
+			columns		{ IN_allocator },
+			offsets		{ IN_allocator },
+			chunks		{ IN_allocator },
+			allocator	{ IN_allocator }
+		{
+			for (auto& column : IN_columns)
+				columns.push_back(column);
+
+			std::sort(columns.begin(), columns.end(), [](auto& lhs, auto& rhs) { return lhs.ID < rhs.ID; });
+
+			// Each row also stores its entity and GameObject
+			size_t rowSize	= sizeof(ArchetypeEntity) + sizeof(GameObject*);
+			size_t padding	= alignof(GameObject*);
+
+			for (auto& column : columns)
+			{
+				rowSize += column.size;
+				padding += column.alignment;
+			}
+
+			chunkSize	= Max(ChunkSize, rowSize + padding);
+			capacity	= uint32_t((chunkSize - padding) / rowSize);
+
+			size_t offset = sizeof(ArchetypeEntity) * capacity;
+
+			offset				= AlignedSize(offset, alignof(GameObject*));
+			gameObjectOffset	= offset;
+			offset				+= sizeof(GameObject*) * capacity;
+
+			for (auto& column : columns)
+			{
+				offset = AlignedSize(offset, column.alignment);
+				offsets.push_back(offset);
+				offset += column.size * capacity;
+			}
+
+			FK_ASSERT(offset <= chunkSize);
+		}
+
+
+		~Archetype()
+		{
+			for (auto& chunk : chunks)
+			{
+				for (uint32_t row = 0; row < chunk.count; ++row)
+					for (uint32_t column = 0; column < columns.size(); ++column)
+						columns[column].Destruct(GetValue(chunk, column, row));
+
+				allocator->_aligned_free(chunk.buffer);
+			}
+		}
+
+		Archetype(const Archetype&)					= delete;
+		Archetype& operator = (const Archetype&)	= delete;
+
+
+		bool Matches(std::span<const ComponentID> sortedIDs) const
+		{
+			if (sortedIDs.size() != columns.size())
+				return false;
+
+			for (size_t I = 0; I < columns.size(); ++I)
+				if (columns[I].ID != sortedIDs[I])
+					return false;
+
+			return true;
+		}
+
+
+		uint32_t GetColumnIndex(const ComponentID ID) const noexcept
+		{
+			for (uint32_t I = 0; I < columns.size(); ++I)
+				if (columns[I].ID == ID)
+					return I;
+
+			return InvalidColumn;
+		}
+
+
+		// Appends a row to the last chunk, the component values are left unconstructed
+		std::pair<uint32_t, uint32_t> AllocateRow(const ArchetypeEntity entity, GameObject* gameObject)
+		{
+			if (!chunks.size() || chunks.back().count == capacity)
+			{
+				auto buffer = (std::byte*)allocator->_aligned_malloc(chunkSize, 64);
+
+				if (!buffer)
+					throw std::bad_alloc{};
+
+				chunks.push_back({ buffer, 0 });
+			}
+
+			const uint32_t chunkIdx	= uint32_t(chunks.size() - 1);
+			auto& chunk				= chunks.back();
+			const uint32_t row		= chunk.count++;
+
+			GetEntities(chunk)[row]		= entity;
+			GetGameObjects(chunk)[row]	= gameObject;
+
+			return { chunkIdx, row };
+		}
+
+
+		// Removes a row whose values have already been destroyed or moved out, by moving the very last row into it
+		// so that every chunk but the last stays full. Returns the entity that was moved, if any.
+		ArchetypeEntity RemoveRow(const uint32_t chunkIdx, const uint32_t row)
+		{
+			auto& last			= chunks.back();
+			auto& chunk			= chunks[chunkIdx];
+			const auto lastRow	= last.count - 1;
+
+			ArchetypeEntity moved = InvalidArchetypeEntity;
+
+			if (&chunk != &last || row != lastRow)
+			{
+				for (uint32_t column = 0; column < columns.size(); ++column)
+				{
+					columns[column].MoveConstruct(GetValue(chunk, column, row), GetValue(last, column, lastRow));
+					columns[column].Destruct(GetValue(last, column, lastRow));
+				}
+
+				moved							= GetEntities(last)[lastRow];
+				GetEntities(chunk)[row]			= moved;
+				GetGameObjects(chunk)[row]		= GetGameObjects(last)[lastRow];
+			}
+
+			if (--last.count == 0)
+			{
+				allocator->_aligned_free(last.buffer);
+				chunks.pop_back();
+			}
+
+			return moved;
+		}
+
+
+		ArchetypeEntity*	GetEntities		(const Chunk& chunk) const noexcept { return reinterpret_cast<ArchetypeEntity*>(chunk.buffer); }
+		GameObject**		GetGameObjects	(const Chunk& chunk) const noexcept { return reinterpret_cast<GameObject**>(chunk.buffer + gameObjectOffset); }
+
+		void* GetColumn(const Chunk& chunk, const uint32_t column) const noexcept
+		{
+			return chunk.buffer + offsets[column];
+		}
+
+		void* GetValue(const Chunk& chunk, const uint32_t column, const uint32_t row) const noexcept
+		{
+			return chunk.buffer + offsets[column] + size_t(columns[column].size) * row;
+		}
+
+		template<typename TY>
+		TY* GetColumn(const Chunk& chunk, const uint32_t column) const noexcept
+		{
+			return static_cast<TY*>(GetColumn(chunk, column));
+		}
+
+		static size_t AlignedSize(const size_t offset, const size_t alignment) noexcept
+		{
+			return (offset + alignment - 1) & ~(alignment - 1);
+		}
+
+
+		Vector<ArchetypeColumnType>	columns;	// Sorted by component ID
+		Vector<size_t>				offsets;
+		Vector<Chunk>				chunks;
+		size_t						gameObjectOffset	= 0;
+		size_t						chunkSize			= ChunkSize;
+		uint32_t					capacity			= 0;
+		iAllocator*					allocator;
+	};
+
+
+	/************************************************************************************************/
+
+
+	// Maps a ReadOnly<View> or Mut<View> query onto the column type of an ArchetypeComponent_t
+	template<typename TY_Query>
+	using ArchetypeQueryValue_t	= typename std::remove_cvref_t<decltype(TY_Query::ValueType::GetComponent())>::ValueType;
+
+	template<typename TY_Query>
+	using ArchetypeQueryColumn_t = std::conditional_t<TY_Query::IsConst(), const ArchetypeQueryValue_t<TY_Query>, ArchetypeQueryValue_t<TY_Query>>;
+
+
+	class ArchetypeStorage
+	{
+	public:
+		ArchetypeStorage(iAllocator* IN_allocator) :
+			entities	{ IN_allocator },
+			freeList	{ IN_allocator },
+			archetypes	{ IN_allocator },
+			allocator	{ IN_allocator } {}
+
+		~ArchetypeStorage()
+		{
+			for (auto archetype : archetypes)
+				allocator->release(archetype);
+		}
+
+		ArchetypeStorage(const ArchetypeStorage&)				= delete;
+		ArchetypeStorage& operator = (const ArchetypeStorage&)	= delete;
+
+
+		template<typename TY>
+		TY& Add(GameObject& gameObject, const ComponentID ID, TY&& value)
+		{
+			using Value_TY = std::remove_cvref_t<TY>;
+
+			if (gameObject.archetypeEntity == InvalidArchetypeEntity)
+			{
+				gameObject.archetypeEntity	= CreateEntity(gameObject);
+				gameObject.archetypeStorage	= this;
+			}
+
+			FK_ASSERT(gameObject.archetypeStorage == this, "GameObject already has archetype components in another ArchetypeStorage!");
+
+			const auto entity	= gameObject.archetypeEntity;
+			const auto location	= entities[entity];
+
+			static_vector<ArchetypeColumnType, 32>	columnTypes;
+			static_vector<ComponentID, 32>			IDs;
+
+			if (location.archetype != InvalidArchetype)
+			{
+				for (auto& column : archetypes[location.archetype]->columns)
+				{
+					FK_ASSERT(column.ID != ID, "Component already added!");
+
+					columnTypes.push_back(column);
+					IDs.push_back(column.ID);
+				}
+			}
+
+			columnTypes.push_back(ArchetypeColumnType::Create<Value_TY>(ID));
+			IDs.push_back(ID);
+			std::sort(IDs.begin(), IDs.end());
+
+			const auto archetypeIdx = FindArchetype({ IDs.begin(), IDs.end() }, { columnTypes.begin(), columnTypes.end() });
+			MoveEntity(entity, archetypeIdx);
+
+			const auto& newLocation = entities[entity];
+			auto&		archetype	= *archetypes[archetypeIdx];
+			auto		ptr			= archetype.GetValue(archetype.chunks[newLocation.chunk], archetype.GetColumnIndex(ID), newLocation.row);
+
+			return *new(ptr) Value_TY(std::forward<TY>(value));
+		}
+
+
+		void Remove(GameObject& gameObject, const ComponentID ID)
+		{
+			const auto entity = gameObject.archetypeEntity;
+
+			if (entity == InvalidArchetypeEntity)
+				return;
+
+			FK_ASSERT(gameObject.archetypeStorage == this, "GameObject's archetype components are in another ArchetypeStorage!");
+
+			const auto location = entities[entity];
+			static_vector<ArchetypeColumnType, 32>	columnTypes;
+			static_vector<ComponentID, 32>			IDs;
+
+			for (auto& column : archetypes[location.archetype]->columns)
+			{
+				if (column.ID == ID)
+					continue;
+
+				columnTypes.push_back(column);
+				IDs.push_back(column.ID);
+			}
+
+			if (IDs.size())
+				MoveEntity(entity, FindArchetype({ IDs.begin(), IDs.end() }, { columnTypes.begin(), columnTypes.end() }));
+			else
+			{
+				MoveEntity(entity, InvalidArchetype);
+				ReleaseEntity(entity);
+
+				gameObject.archetypeEntity	= InvalidArchetypeEntity;
+				gameObject.archetypeStorage	= nullptr;
+			}
+		}
+
+
+		void* Get(const ArchetypeEntity entity, const ComponentID ID) const noexcept
+		{
+			FK_ASSERT(Owns(entity), "Archetype entity belongs to another ArchetypeStorage!");
+
+			const auto& location	= entities[entity];
+			const auto& archetype	= *archetypes[location.archetype];
+
+			return archetype.GetValue(archetype.chunks[location.chunk], archetype.GetColumnIndex(ID), location.row);
+		}
+
+
+		// Calls FN(GameObject&, values ...) for every object with all the queried components, ReadOnly queries receive const references
+		template<typename ... TY_Queries, typename FN>
+		void QueryFor(FN fn, const TY_Queries& ... queries)
+		{
+			QueryChunks(
+				[&](std::span<GameObject*> gameObjects, auto ... columns)
+				{
+					for (size_t row = 0; row < gameObjects.size(); ++row)
+						fn(*gameObjects[row], columns[row]...);
+				},
+				queries...);
+		}
+
+
+		// Calls FN(std::span<GameObject*>, std::span<Column> ...) once per chunk, for loops over whole columns
+		template<typename ... TY_Queries, typename FN>
+		void QueryChunks(FN fn, const TY_Queries& ...)
+		{
+			ComponentID IDs[] = { TY_Queries::ValueType::GetComponentID()... };
+
+			for (auto archetype : archetypes)
+			{
+				uint32_t	columnIdxs[sizeof...(TY_Queries)];
+				bool		match = true;
+
+				for (size_t I = 0; I < sizeof...(TY_Queries); ++I)
+				{
+					columnIdxs[I]	= archetype->GetColumnIndex(IDs[I]);
+					match			&= columnIdxs[I] != InvalidColumn;
+				}
+
+				if (!match)
+					continue;
+
+				for (auto& chunk : archetype->chunks)
+				{
+					[&]<size_t ... N>(std::index_sequence<N...>)
+					{
+						fn(
+							std::span<GameObject*>{ archetype->GetGameObjects(chunk), chunk.count },
+							std::span<ArchetypeQueryColumn_t<TY_Queries>>{ archetype->GetColumn<ArchetypeQueryValue_t<TY_Queries>>(chunk, columnIdxs[N]), chunk.count }...);
+					}(std::make_index_sequence<sizeof...(TY_Queries)>{});
+				}
+			}
+		}
+
+
+		size_t GetArchetypeCount() const noexcept { return archetypes.size(); }
+
+
+		// Entity indices are only meaningful in the storage that created them
+		bool Owns(const ArchetypeEntity entity) const noexcept
+		{
+			if (entity >= entities.size())
+				return false;
+
+			const auto gameObject = entities[entity].gameObject;
+
+			return gameObject && gameObject->archetypeEntity == entity && gameObject->archetypeStorage == this;
+		}
+
+	private:
+
+		struct EntityLocation
+		{
+			uint32_t	archetype	= InvalidArchetype;
+			uint32_t	chunk		= 0;
+			uint32_t	row			= 0;
+			GameObject*	gameObject	= nullptr;
+		};
+
+
+		ArchetypeEntity CreateEntity(GameObject& gameObject)
+		{
+			if (freeList.size())
+			{
+				const auto entity = freeList.pop_back();
+				entities[entity] = { .gameObject = &gameObject };
+
+				return entity;
+			}
+
+			return (ArchetypeEntity)entities.push_back({ .gameObject = &gameObject });
+		}
+
+
+		void ReleaseEntity(const ArchetypeEntity entity)
+		{
+			entities[entity] = {};
+			freeList.push_back(entity);
+		}
+
+
+		uint32_t FindArchetype(std::span<const ComponentID> sortedIDs, std::span<const ArchetypeColumnType> columnTypes)
+		{
+			for (uint32_t I = 0; I < archetypes.size(); ++I)
+				if (archetypes[I]->Matches(sortedIDs))
+					return I;
+
+			auto& archetype = allocator->allocate<Archetype>(columnTypes, allocator);
+
+			return (uint32_t)archetypes.push_back(&archetype);
+		}
+
+
+		// Moves the values an entity shares with the destination archetype, destroys the rest.
+		// Newly added columns are left for the caller to construct.
+		void MoveEntity(const ArchetypeEntity entity, const uint32_t destIdx)
+		{
+			FK_ASSERT(Owns(entity), "Archetype entity belongs to another ArchetypeStorage!");
+
+			auto& location = entities[entity];
+
+			if (location.archetype == destIdx)
+				return;
+
+			uint32_t chunkIdx	= 0;
+			uint32_t row		= 0;
+
+			if (destIdx != InvalidArchetype)
+				std::tie(chunkIdx, row) = archetypes[destIdx]->AllocateRow(entity, location.gameObject);
+
+			if (location.archetype != InvalidArchetype)
+			{
+				auto& source		= *archetypes[location.archetype];
+				auto& sourceChunk	= source.chunks[location.chunk];
+
+				for (uint32_t column = 0; column < source.columns.size(); ++column)
+				{
+					auto src = source.GetValue(sourceChunk, column, location.row);
+
+					if (destIdx != InvalidArchetype)
+					{
+						auto& dest = *archetypes[destIdx];
+
+						if (const auto destColumn = dest.GetColumnIndex(source.columns[column].ID); destColumn != InvalidColumn)
+							source.columns[column].MoveConstruct(dest.GetValue(dest.chunks[chunkIdx], destColumn, row), src);
+					}
+
+					source.columns[column].Destruct(src);
+				}
+
+				if (const auto moved = source.RemoveRow(location.chunk, location.row); moved != InvalidArchetypeEntity)
+				{
+					entities[moved].chunk	= location.chunk;
+					entities[moved].row		= location.row;
+				}
+			}
+
+			location.archetype	= destIdx;
+			location.chunk		= chunkIdx;
+			location.row		= row;
+		}
+
+
+		Vector<EntityLocation>	entities;
+		Vector<ArchetypeEntity>	freeList;
+		Vector<Archetype*>		archetypes;
+		iAllocator*				allocator;
+	};
+
+
+	/************************************************************************************************/
+
+
+	// Drop-in alternative to BasicComponent_t that keeps its values in an ArchetypeStorage.
+	// Works with the same views and FlexKit::Query, ArchetypeStorage::QueryFor/QueryChunks iterate the columns directly.
+	template<typename TY, typename TY_Handle, ComponentID ID, typename TY_EventHandler = BasicComponentEventHandler>
+	class ArchetypeComponent_t : public Component<ArchetypeComponent_t<TY, TY_Handle, ID, TY_EventHandler>, ID>
+	{
+	public:
+		using ThisType		= ArchetypeComponent_t<TY, TY_Handle, ID, TY_EventHandler>;
+		using EventHandler	= TY_EventHandler;
+		using ValueType		= TY;
+		using View			= BasicComponentView_t<ThisType>;
+
+		template<typename ... TY_args>
+		ArchetypeComponent_t(ArchetypeStorage& IN_storage, iAllocator* allocator, TY_args&&... args) :
+			eventHandler	{ std::forward<TY_args>(args)... },
+			storage			{ IN_storage },
+			handles			{ allocator },
+			gameObjects		{ allocator } {}
+
+		ArchetypeComponent_t(ArchetypeStorage& IN_storage, iAllocator* allocator) :
+			storage			{ IN_storage },
+			handles			{ allocator },
+			gameObjects		{ allocator } {}
+
+
+		TY_Handle Create(GameObject& gameObject, const TY& initial)
+		{
+			return _Create(gameObject, TY{ eventHandler.OnCreate(gameObject, initial) });
+		}
+
+
+		TY_Handle Create(GameObject& gameObject, TY&& initial)
+		{
+			return _Create(gameObject, TY{ std::move(eventHandler.OnCreate(gameObject, initial)) });
+		}
+
+
+		TY_Handle Create(GameObject& gameObject) requires ComponentVoidCreator<TY_EventHandler>
+		{
+			return _Create(gameObject, TY{ std::move(eventHandler.OnCreate(gameObject)) });
+		}
+
+
+		TY_Handle Create(GameObject& gameObject) requires (!ComponentVoidCreator<TY_EventHandler>)
+		{
+			return _Create(gameObject, TY{});
+		}
+
+
+		void AddComponentView(GameObject& gameObject, ValueMap values, const std::byte* buffer, const size_t bufferSize, iAllocator* allocator) override
+		{
+			eventHandler.OnCreateView(gameObject, values, buffer, bufferSize, allocator);
+		}
+
+
+		void FreeComponentView(void* _ptr) override
+		{
+			reinterpret_cast<View*>(_ptr)->Release();
+		}
+
+
+		void Remove(TY_Handle handle)
+		{
+			auto& gameObject = *gameObjects[handles[handle]];
+
+			storage.Remove(gameObject, ID);
+
+			gameObjects[handles[handle]] = nullptr;
+			handles.RemoveHandle(handle);
+		}
+
+
+		TY& operator[] (TY_Handle handle)
+		{
+			return *static_cast<TY*>(storage.Get(gameObjects[handles[handle]]->archetypeEntity, ID));
+		}
+
+		TY operator[] (TY_Handle handle) const
+		{
+			return *static_cast<const TY*>(storage.Get(gameObjects[handles[handle]]->archetypeEntity, ID));
+		}
+
+		ArchetypeStorage& GetStorage() noexcept { return storage; }
+
+	private:
+
+		TY_Handle _Create(GameObject& gameObject, TY&& value)
+		{
+			storage.Add(gameObject, ID, std::move(value));
+
+			const auto handle = handles.GetNewHandle();
+
+			if (handle.INDEX < gameObjects.size())
+				gameObjects[handle.INDEX] = &gameObject;
+			else
+				gameObjects.push_back(&gameObject);
+
+			handles[handle] = handle.INDEX;
+
+			return handle;
+		}
+
+		TY_EventHandler							eventHandler;
+		ArchetypeStorage&						storage;
+		HandleUtilities::HandleTable<TY_Handle>	handles;
+		Vector<GameObject*>						gameObjects;
+	};
+
+
+}	/************************************************************************************************/
+
+
+/**********************************************************************
+
+Copyright (c) 2015 - 2023 Robert May
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+**********************************************************************/
@@ -1,5 +1,7 @@
 #include "Assets.h"
 #include "graphics.h"
+#include "Serialization.hpp"
+#include "ThreadUtilities.h"
 
 namespace FlexKit
 {	/************************************************************************************************/
@@ -94,12 +96,25 @@ namespace FlexKit
 
 	struct BufferContext : public ReadContextInterface
 	{
-		BufferContext(byte* IN_buffer, size_t IN_bufferSize, size_t IN_offset) :
+		// With an owner the buffer is freed when the context closes, otherwise it belongs to a loaded resource
+		BufferContext(byte* IN_buffer, size_t IN_bufferSize, size_t IN_offset, iAllocator* IN_owner = nullptr) :
 			buffer      { IN_buffer },
 			bufferSize  { IN_bufferSize },
-			offset      { IN_offset } {}
+			offset      { IN_offset },
+			owner       { IN_owner } {}
 
-		void Close() final {}
+		~BufferContext() { Close(); }
+
+		void Close() final
+		{
+			if (owner && buffer)
+			{
+				owner->_aligned_free(buffer);
+
+				buffer		= nullptr;
+				bufferSize	= 0;
+			}
+		}
 
 		void Read(void* dst_ptr, size_t readSize, size_t readOffset) final
 		{
@@ -117,9 +132,10 @@ namespace FlexKit
 			return (buffer != nullptr && bufferSize > 0);
 		}
 
-		byte*   buffer      = nullptr;
-		size_t  bufferSize  = 0;
-		size_t  offset      = 0;
+		byte*		buffer      = nullptr;
+		size_t		bufferSize  = 0;
+		size_t		offset      = 0;
+		iAllocator*	owner       = nullptr;
 	};
 
 
@@ -128,6 +144,115 @@ namespace FlexKit
 		char str[256];
 	};
 
+
+	/************************************************************************************************/
+
+
+	// Open addressed multimap from a 64 bit key, linear probing over a power of two table.
+	// Entries are only ever added, Release drops the whole index.
+	template<typename TY_Value>
+	struct AssetIndex
+	{
+		struct Slot
+		{
+			uint64_t	key			= 0;
+			TY_Value	value		= {};
+			bool		occupied	= false;
+		};
+
+		void Initiate(iAllocator* allocator)
+		{
+			slots	= Vector<Slot>(allocator);
+			count	= 0;
+			shift	= 64;
+		}
+
+		void Release()
+		{
+			slots.Release();
+			count = 0;
+		}
+
+		template<typename FN_Match>
+		TY_Value* Find(const uint64_t key, FN_Match match)
+		{
+			if (!count)
+				return nullptr;
+
+			const size_t mask = slots.size() - 1;
+
+			for (size_t I = SlotIdx(key); slots[I].occupied; I = (I + 1) & mask)
+			{
+				if (slots[I].key == key && match(slots[I].value))
+					return &slots[I].value;
+			}
+
+			return nullptr;
+		}
+
+		TY_Value* Find(const uint64_t key)
+		{
+			return Find(key, [](auto&) { return true; });
+		}
+
+		void Insert(const uint64_t key, const TY_Value& value)
+		{
+			if ((count + 1) * 4 > slots.size() * 3)
+				Grow();
+
+			const size_t mask = slots.size() - 1;
+
+			size_t I = SlotIdx(key);
+			while (slots[I].occupied)
+				I = (I + 1) & mask;
+
+			slots[I] = Slot{ key, value, true };
+			count++;
+		}
+
+		// Fibonacci hashing, GUIDs are not guaranteed to be well distributed in the low bits
+		size_t SlotIdx(const uint64_t key) const noexcept
+		{
+			return (key * 0x9E3779B97F4A7C15ull) >> shift;
+		}
+
+		void Grow()
+		{
+			const size_t newSize = Max(slots.size() * 2, size_t(64));
+
+			Vector<Slot> previous = std::move(slots);
+
+			slots	= Vector<Slot>{ previous.Allocator, newSize, Slot{} };
+			shift	= 64 - (size_t)std::countr_zero(newSize);
+			count	= 0;
+
+			for (auto& slot : previous)
+			{
+				if (slot.occupied)
+					Insert(slot.key, slot.value);
+			}
+
+			previous.Release();
+		}
+
+		Vector<Slot>	slots;
+		size_t			count = 0;
+		size_t			shift = 64;
+	};
+
+
+	struct AssetLocation
+	{
+		uint32_t table;
+		uint32_t entry;
+	};
+
+
+	inline uint64_t HashAssetID(const char* ID) noexcept
+	{
+		return std::hash<std::string_view>{}({ ID, strnlen(ID, ID_LENGTH) });
+	}
+
 	struct GlobalResourceTable
 	{
 		~GlobalResourceTable()
@@ -141,6 +266,157 @@ namespace FlexKit
 			ResourceFiles.Allocator		= nullptr;
 			ResourcesLoaded.Allocator	= nullptr;
 			ResourceGUIDs.Allocator		= nullptr;
+
+			GUIDIndex.slots.A			= nullptr;
+			IDIndex.slots.A				= nullptr;
+			loadedGUIDs.slots.A			= nullptr;
+			loadedIDs.slots.A			= nullptr;
+
+			GUIDIndex.slots.Allocator	= nullptr;
+			IDIndex.slots.Allocator		= nullptr;
+			loadedGUIDs.slots.Allocator	= nullptr;
+			loadedIDs.slots.Allocator	= nullptr;
+		}
+
+
+		ResourceEntry* FindEntry(const GUID_t guid, size_t* tableIdx = nullptr)
+		{
+			if (auto location = GUIDIndex.Find(guid); location)
+			{
+				if (tableIdx)
+					*tableIdx = location->table;
+
+				return &Tables[location->table]->Entries[location->entry];
+			}
+
+			return nullptr;
+		}
+
+
+		ResourceEntry* FindEntry(const char* ID, size_t* tableIdx = nullptr)
+		{
+			auto location = IDIndex.Find(HashAssetID(ID),
+				[&](const AssetLocation& location)
+				{
+					return !strncmp(Tables[location.table]->Entries[location.entry].ID, ID, ID_LENGTH);
+				});
+
+			if (location)
+			{
+				if (tableIdx)
+					*tableIdx = location->table;
+
+				return &Tables[location->table]->Entries[location->entry];
+			}
+
+			return nullptr;
+		}
+
+
+		// Loaded resources are added from the asset IO workers, everything touching them goes through loadedLock
+
+		std::optional<AssetHandle> FindLoaded(const GUID_t guid)
+		{
+			std::scoped_lock lock{ loadedLock };
+
+			return _FindLoaded(guid);
+		}
+
+
+		std::optional<AssetHandle> FindLoaded(const char* ID)
+		{
+			std::scoped_lock lock{ loadedLock };
+
+			return _FindLoaded(ID);
+		}
+
+
+		Resource* GetLoaded(const AssetHandle handle)
+		{
+			std::scoped_lock lock{ loadedLock };
+
+			return ResourcesLoaded[handle];
+		}
+
+
+		// Takes ownership of resource, pack loads are allocated from ResourceMemory, AddAssetBuffer hands over malloc'd blobs
+		AssetHandle AddLoaded(Resource* resource, const bool fromResourceMemory = true)
+		{
+			std::scoped_lock lock{ loadedLock };
+
+			// Another load of the same GUID can finish between a caller's FindLoaded and here, keep the
+			// resident copy and drop this one
+			if (auto existing = _FindLoaded(resource->GUID); existing)
+			{
+				Resource* resident = ResourcesLoaded[*existing];
+
+				if (resident != resource)
+				{
+					// Pack loads come in unreferenced, buffers added through AddAssetBuffer carry their reference over
+					resident->RefCount += resource->RefCount;
+
+					if (fromResourceMemory)
+						ResourceMemory->_aligned_free(resource);
+					else
+						free(resource);
+				}
+
+				return *existing;
+			}
+
+			const AssetHandle handle = ResourcesLoaded.size();
+			ResourcesLoaded.push_back(resource);
+			ResourceGUIDs.push_back(resource->GUID);
+
+			loadedGUIDs.Insert(resource->GUID, handle);
+
+			// First resource loaded under an ID wins, same as the old linear scans
+			if (!_FindLoaded(resource->ID))
+				loadedIDs.Insert(HashAssetID(resource->ID), handle);
+
+			return handle;
+		}
+
+
+		std::optional<AssetHandle> _FindLoaded(const GUID_t guid)
+		{
+			if (auto handle = loadedGUIDs.Find(guid); handle)
+				return *handle;
+
+			return {};
+		}
+
+
+		std::optional<AssetHandle> _FindLoaded(const char* ID)
+		{
+			auto handle = loadedIDs.Find(HashAssetID(ID),
+				[&](const AssetHandle handle)
+				{
+					return !strncmp(ResourcesLoaded[handle]->ID, ID, ID_LENGTH);
+				});
+
+			if (handle)
+				return *handle;
+
+			return {};
+		}
+
+
+		void AddTable(ResourceTable* table)
+		{
+			const uint32_t tableIdx = (uint32_t)Tables.size();
+			Tables.push_back(table);
+
+			for (uint32_t I = 0; I < table->ResourceCount; ++I)
+			{
+				const auto& entry = table->Entries[I];
+
+				if (!FindEntry(entry.GUID))
+					GUIDIndex.Insert(entry.GUID, { tableIdx, I });
+
+				if (!FindEntry(entry.ID))
+					IDIndex.Insert(HashAssetID(entry.ID), { tableIdx, I });
+			}
 		}
 
 
@@ -148,7 +424,15 @@ namespace FlexKit
 		Vector<ResourceDirectory>	ResourceFiles;
 		Vector<Resource*>			ResourcesLoaded;
 		Vector<GUID_t>				ResourceGUIDs;
+
+		AssetIndex<AssetLocation>	GUIDIndex;
+		AssetIndex<AssetLocation>	IDIndex;
+		AssetIndex<AssetHandle>		loadedGUIDs;
+		AssetIndex<AssetHandle>		loadedIDs;
+		std::mutex					loadedLock;
+
 		iAllocator*					ResourceMemory;
+		ThreadManager*				threads = nullptr;
 		AssetFailureHandler			failureHandler = [](AssetIdentifier) -> AssetHandle { return INVALIDHANDLE; };
 	}inline Resources;
 
@@ -156,13 +440,57 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
-	void InitiateAssetTable(iAllocator* Memory)
+	struct PendingAssetLoad
+	{
+		AssetLoadFuture	request;
+		ResourceTable*	table;
+		uint32_t		tableIdx;
+		uint32_t		entry;
+		uint64_t		position;
+		uint64_t		extent;	// Upper bound of the resource size, from the next resource in the pack
+	};
+
+
+	// Pack files are kept open for the queue, only the worker draining the queue reads from them
+	class AssetIOQueue
+	{
+	public:
+		static constexpr size_t MaxCoalesceGap = 64 * KILOBYTE;
+
+		void AddFile	(FILE* file);
+		void Enqueue	(PendingAssetLoad&& load);
+		void Wait		();
+		void Release	();
+
+	private:
+		void Process		();
+		void ProcessBatch	(std::vector<PendingAssetLoad>& batch);
+
+		std::mutex						m;
+		std::vector<PendingAssetLoad>	pending;
+		std::vector<FILE*>				files;
+		std::vector<size_t>				fileSizes;
+		std::vector<byte>				staging;
+		bool							scheduled = false;
+	}inline AssetIO;
+
+
+	/************************************************************************************************/
+
+
+	void InitiateAssetTable(iAllocator* Memory, ThreadManager* threads)
 	{
 		Resources.Tables			= Vector<ResourceTable*>(Memory);
 		Resources.ResourceFiles		= Vector<ResourceDirectory>(Memory);
 		Resources.ResourcesLoaded	= Vector<Resource*>(Memory);
 		Resources.ResourceGUIDs		= Vector<GUID_t>(Memory);
 		Resources.ResourceMemory	= Memory;
+
+		Resources.GUIDIndex.Initiate(Memory);
+		Resources.IDIndex.Initiate(Memory);
+		Resources.loadedGUIDs.Initiate(Memory);
+		Resources.loadedIDs.Initiate(Memory);
+		Resources.threads			= threads;
 	}
 
 	
@@ -171,6 +499,8 @@ namespace FlexKit
 
 	void ReleaseAssetTable()
 	{
+		AssetIO.Release();
+
 		for (auto* Table : Resources.Tables)
 			Resources.ResourceMemory->free(Table);
 
@@ -181,6 +511,11 @@ namespace FlexKit
 		Resources.ResourceFiles.Release();
 		Resources.ResourcesLoaded.Release();
 		Resources.ResourceGUIDs.Release();
+
+		Resources.GUIDIndex.Release();
+		Resources.IDIndex.Release();
+		Resources.loadedGUIDs.Release();
+		Resources.loadedIDs.Release();
 	}
 
 
@@ -207,10 +542,14 @@ namespace FlexKit
 		if (ReadAssetTable(F, table, tableSize))
 		{
 			Resources.ResourceFiles.push_back(Dir);
-			Resources.Tables.push_back(table);
+			Resources.AddTable(table);
+			AssetIO.AddFile(F);
 		}
 		else
+		{
 			Resources.ResourceMemory->_aligned_free(table);
+			fclose(F);
+		}
 	}
 
 	/************************************************************************************************/
@@ -221,7 +560,7 @@ namespace FlexKit
 		buffer->RefCount    = 1;
 		buffer->State       = Resource::EResourceState_LOADED;
 
-		return Resources.ResourcesLoaded.push_back((Resource*)buffer);
+		return Resources.AddLoaded(buffer, false);
 	}
 
 
@@ -230,22 +569,8 @@ namespace FlexKit
 
 	std::optional<GUID_t> FindAssetGUID(const char* Str)
 	{
-		bool Found = false;
-		GUID_t Guid = INVALIDHANDLE;
-
-		for (auto T : Resources.Tables)
-		{
-			auto end = T->ResourceCount;
-			for (size_t I = 0; I < end; ++I)
-			{
-				if (!strncmp(T->Entries[I].ID, Str, 64))
-				{
-					Found = true;
-					Guid = T->Entries[I].GUID;
-					return { Guid };
-				}
-			}
-		}
+		if (auto entry = Resources.FindEntry(Str); entry)
+			return { entry->GUID };
 
 		return {};
 	}
@@ -259,8 +584,10 @@ namespace FlexKit
 		if (RHandle == INVALIDHANDLE)
 			return nullptr;
 
-		Resources.ResourcesLoaded[RHandle]->RefCount++;
-		return Resources.ResourcesLoaded[RHandle];
+		auto resource = Resources.GetLoaded(RHandle);
+		resource->RefCount++;
+
+		return resource;
 	}
 
 
@@ -269,8 +596,18 @@ namespace FlexKit
 
 	void FreeAllAssets()
 	{
+		// In flight loads would add into the table while it's being freed
+		AssetIO.Wait();
+
+		std::scoped_lock lock{ Resources.loadedLock };
+
 		for (auto R : Resources.ResourcesLoaded)
 			if(Resources.ResourceMemory) Resources.ResourceMemory->_aligned_free(R);
+
+		Resources.ResourcesLoaded.clear();
+		Resources.ResourceGUIDs.clear();
+		Resources.loadedGUIDs.Release();
+		Resources.loadedIDs.Release();
 	}
 
 
@@ -279,6 +616,8 @@ namespace FlexKit
 
 	void FreeAllAssetFiles()
 	{
+		AssetIO.Wait();
+
 		for (auto T : Resources.Tables)
 			Resources.ResourceMemory->_aligned_free(T);
 	}
@@ -289,8 +628,10 @@ namespace FlexKit
 
 	void FreeAsset(AssetHandle RHandle)
 	{
-		Resources.ResourcesLoaded[RHandle]->RefCount--;
-		if (Resources.ResourcesLoaded[RHandle]->RefCount == 0)
+		auto resource = Resources.GetLoaded(RHandle);
+		resource->RefCount--;
+
+		if (resource->RefCount == 0)
 		{
 			// Evict
 			// TODO: Resource Eviction
@@ -301,30 +642,42 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	Resource* _ReadEntry(FILE* F, ResourceTable* t, const size_t I);
+
 	ReadContext OpenReadContext(GUID_t guid)
 	{
-		AssetHandle RHandle = INVALIDHANDLE;
-
-		for (auto resource : Resources.ResourcesLoaded)
+		if (auto handle = Resources.FindLoaded(guid); handle)
 		{
-			if (resource->GUID == guid)
-			{
-				auto& bufferCtx = Resources.ResourceMemory->allocate<BufferContext>((byte*)resource, resource->ResourceSize, 0);
-				return ReadContext{ guid, &bufferCtx, Resources.ResourceMemory };
-			}
+			auto resource	= Resources.GetLoaded(*handle);
+			auto& bufferCtx	= Resources.ResourceMemory->allocate<BufferContext>((byte*)resource, resource->ResourceSize, 0);
+			return ReadContext{ guid, &bufferCtx, Resources.ResourceMemory };
 		}
 
-		for (size_t TI = 0; TI < Resources.Tables.size(); ++TI)
+		size_t TI = 0;
+		if (auto entry = Resources.FindEntry(guid, &TI); entry)
 		{
-			auto& t = Resources.Tables[TI];
-			for (size_t I = 0; I < t->ResourceCount; ++I)
-			{
-				if (t->Entries[I].GUID == guid)
-				{
-					auto& fileCtx = Resources.ResourceMemory->allocate<FileContext>(Resources.ResourceFiles[TI].str, t->Entries[I].ResourcePosition);
-					return ReadContext{ guid, &fileCtx, Resources.ResourceMemory };
-				}
+			if (entry->Encoding == EResourceEncoding_BlockCompressed)
+			{	// Compressed resources can't be read at an offset, decompress the whole thing and read from memory.
+				// The copy isn't added to the loaded resources, it's freed once the context closes
+				auto& table = Resources.Tables[TI];
+
+				FILE* F = nullptr;
+				fopen_s(&F, Resources.ResourceFiles[TI].str, "rb");
+
+				auto resource = _ReadEntry(F, table, entry - table->Entries);
+
+				if (F)
+					::fclose(F);
+
+				if (!resource)
+					return {};
+
+				auto& bufferCtx	= Resources.ResourceMemory->allocate<BufferContext>((byte*)resource, resource->ResourceSize, 0, Resources.ResourceMemory);
+				return ReadContext{ guid, &bufferCtx, Resources.ResourceMemory };
 			}
+
+			auto& fileCtx = Resources.ResourceMemory->allocate<FileContext>(Resources.ResourceFiles[TI].str, entry->ResourcePosition);
+			return ReadContext{ guid, &fileCtx, Resources.ResourceMemory };
 		}
 
 		return {};
@@ -336,40 +689,38 @@ namespace FlexKit
 
 	ReadAsset_RC ReadAsset(ReadContext& readContext, GUID_t guid, void* _ptr, size_t readSize, size_t readOffset)
 	{
-		for (auto resource : Resources.ResourcesLoaded)
+		if (auto handle = Resources.FindLoaded(guid); handle)
+		{
+			auto resource	= Resources.GetLoaded(*handle);
+			auto& bufferCtx	= Resources.ResourceMemory->allocate<BufferContext>((byte*)resource, resource->ResourceSize, 0);
+			readContext		= ReadContext{ guid, &bufferCtx, Resources.ResourceMemory };
+
+			readContext.Read(_ptr, readSize, readOffset);
+
+			return RAC_OK;
+		}
+
+		if (auto entry = Resources.FindEntry(guid); entry)
 		{
-			if (resource->GUID == guid)
+			if (entry->Encoding == EResourceEncoding_BlockCompressed)
 			{
-				auto& bufferCtx = Resources.ResourceMemory->allocate<BufferContext>((byte*)resource, resource->ResourceSize, 0);
-				readContext = ReadContext{ guid, &bufferCtx, Resources.ResourceMemory };
+				if (readContext.guid != guid)
+					readContext = OpenReadContext(guid);
 
 				readContext.Read(_ptr, readSize, readOffset);
 
 				return RAC_OK;
 			}
-		}
-
 
-		AssetHandle RHandle = INVALIDHANDLE;
-		for (size_t TI = 0; TI < Resources.Tables.size(); ++TI)
-		{
-			auto& t = Resources.Tables[TI];
-			for (size_t I = 0; I < t->ResourceCount; ++I)
-			{
-				if (t->Entries[I].GUID == guid)
-				{
-					size_t resourceOffset = t->Entries[I].ResourcePosition;
+			size_t resourceOffset = entry->ResourcePosition;
 
-					//if (readContext.fileDir != Resources.ResourceFiles[TI].str)
-					if (readContext.guid != guid)
-						readContext = OpenReadContext(guid);// ReadContext{ Resources.ResourceFiles[TI].str, resourceOffset };
+			if (readContext.guid != guid)
+				readContext = OpenReadContext(guid);
 
-					readContext.SetOffset(resourceOffset);
-					readContext.Read(_ptr, readSize, readOffset);
+			readContext.SetOffset(resourceOffset);
+			readContext.Read(_ptr, readSize, readOffset);
 
-					return RAC_OK;
-				}
-			}
+			return RAC_OK;
 		}
 
 		return RAC_ERROR;
@@ -381,128 +732,402 @@ namespace FlexKit
 
 	const char* GetResourceStringID(GUID_t guid)
 	{
-		AssetHandle RHandle = INVALIDHANDLE;
-		for (size_t TI = 0; TI < Resources.Tables.size(); ++TI)
+		if (auto entry = Resources.FindEntry(guid); entry)
+			return entry->ID;
+
+		return nullptr;
+	}
+
+
+	/************************************************************************************************/
+
+
+	Resource* _ReadEntry(FILE* F, ResourceTable* t, const size_t I)
+	{
+		if (!F)
+			return nullptr;
+
+		size_t ResourceSize = ReadAssetSize(F, t, I);
+
+		Resource* NewResource = (Resource*)Resources.ResourceMemory->_aligned_malloc(ResourceSize);
+		if (!NewResource)
 		{
-			auto& t = Resources.Tables[TI];
-			for (size_t I = 0; I < t->ResourceCount; ++I)
-			{
-				if (t->Entries[I].GUID == guid)
-					return t->Entries[I].ID;
-			}
+			// Memory Full
+			// Evict A Unused Resource
+			// TODO: Handle running out of memory
+			return nullptr;
 		}
 
-		return nullptr;
+		if (!ReadResource(F, t, I, NewResource))
+		{
+			Resources.ResourceMemory->_aligned_free(NewResource);
+			return nullptr;
+		}
+
+		NewResource->State		= Resource::EResourceState_LOADED;
+		NewResource->RefCount	= 0;
+
+		return NewResource;
 	}
 
 
+	/************************************************************************************************/
+
+
+	AssetHandle _LoadGameAsset(const size_t TI, const ResourceEntry* entry)
+	{
+		auto& t			= Resources.Tables[TI];
+		const size_t I	= entry - t->Entries;
+
+		FILE* F             = 0;
+		int S               = fopen_s(&F, Resources.ResourceFiles[TI].str, "rb");
+
+		auto NewResource = _ReadEntry(F, t, I);
+
+		if (F)
+			::fclose(F);
+
+		if (!NewResource)
+		{
+			FK_ASSERT(false, "FAILED TO LOAD RESOURCE!");
+			return INVALIDHANDLE;
+		}
+
+		return Resources.AddLoaded(NewResource);
+	}
+
 
 	/************************************************************************************************/
 
 
 	AssetHandle LoadGameAsset(GUID_t guid)
 	{
-		for (size_t I = 0; I < Resources.ResourcesLoaded.size(); ++I)
-			if (Resources.ResourcesLoaded[I]->GUID == guid)
-				return I;
+		if (auto handle = Resources.FindLoaded(guid); handle)
+			return *handle;
+
+		size_t TI = 0;
+		if (auto entry = Resources.FindEntry(guid, &TI); entry)
+			return _LoadGameAsset(TI, entry);
+
+		return Resources.failureHandler(guid);
+	}
+
+
+	/************************************************************************************************/
+
+
+	AssetHandle LoadGameAsset(const char* ID)
+	{
+		if (auto handle = Resources.FindLoaded(ID); handle)
+			return *handle;
+
+		size_t TI = 0;
+		if (auto entry = Resources.FindEntry(ID, &TI); entry)
+			return _LoadGameAsset(TI, entry);
+
+		return INVALIDHANDLE;
+	}
+
+
+	/************************************************************************************************/
+
+
+	void AssetIOQueue::AddFile(FILE* file)
+	{
+		fseek(file, 0, SEEK_END);
+		const size_t size = ftell(file);
 
-		AssetHandle RHandle = INVALIDHANDLE;
-		for (size_t TI = 0; TI < Resources.Tables.size(); ++TI)
+		std::scoped_lock lock{ m };
+
+		files.push_back(file);
+		fileSizes.push_back(size);
+	}
+
+
+	/************************************************************************************************/
+
+
+	void AssetIOQueue::Enqueue(PendingAssetLoad&& load)
+	{
+		std::scoped_lock lock{ m };
+
+		const auto& entries	= load.table->Entries;
+		const auto next		= load.entry + 1;
+
+		// Resources are packed back to back in table order, anything else falls back to reading the entry on its own
+		if (next < load.table->ResourceCount && entries[next].ResourcePosition > load.position)
+			load.extent = entries[next].ResourcePosition - load.position;
+		else if (next == load.table->ResourceCount && fileSizes[load.tableIdx] > load.position)
+			load.extent = fileSizes[load.tableIdx] - load.position;
+		else
+			load.extent = 0;
+
+		pending.emplace_back(std::move(load));
+
+		if (!scheduled)
 		{
-			auto& t = Resources.Tables[TI];
-			for (size_t I = 0; I < t->ResourceCount; ++I)
-			{
-				if (t->Entries[I].GUID == guid)
+			scheduled = true;
+
+			auto& work = CreateWorkItem(
+				[this](iAllocator&)
 				{
+					Process();
+				}, SystemAllocator);
+
+			work.SetPriority(WorkPriority::Background);
+			Resources.threads->AddBackgroundWork(work);
+		}
+	}
 
-					FILE* F             = 0;
-					int S               = fopen_s(&F, Resources.ResourceFiles[TI].str, "rb");
-					size_t ResourceSize = ReadAssetSize(F, t, I);
 
-					Resource* NewResource = (Resource*)Resources.ResourceMemory->_aligned_malloc(ResourceSize);
-					if (!NewResource)
-					{
-						// Memory Full
-						// Evict A Unused Resource
-						// TODO: Handle running out of memory
-						FK_ASSERT(false, "OUT OF MEMORY!");
-					}
+	/************************************************************************************************/
 
-					if (!ReadResource(F, t, I, NewResource))
-					{
-						Resources.ResourceMemory->_aligned_free(NewResource);
 
-						FK_ASSERT(false, "FAILED TO LOAD RESOURCE!");
-					}
-					else
-					{
-						NewResource->State		= Resource::EResourceState_LOADED;
-						NewResource->RefCount	= 0;
-						RHandle					= Resources.ResourcesLoaded.size();
-						Resources.ResourcesLoaded.push_back(NewResource);
-						Resources.ResourceGUIDs.push_back(NewResource->GUID);
-					}
+	void AssetIOQueue::Process()
+	{
+		ProfileFunction();
 
-					::fclose(F);
-					return RHandle;
+		// Requests that come in while a batch is being read are picked up by the next pass
+		while (true)
+		{
+			std::vector<PendingAssetLoad> batch;
+
+			{
+				std::scoped_lock lock{ m };
+
+				if (pending.empty())
+				{
+					scheduled = false;
+					return;
 				}
+
+				batch.swap(pending);
 			}
-		}
 
-		return Resources.failureHandler(guid);
+			ProcessBatch(batch);
+		}
 	}
 
 
 	/************************************************************************************************/
 
 
-	AssetHandle LoadGameAsset(const char* ID)
+	void AssetIOQueue::ProcessBatch(std::vector<PendingAssetLoad>& batch)
 	{
-		for (size_t I = 0; I < Resources.ResourcesLoaded.size(); ++I)
-			if (!strcmp(Resources.ResourcesLoaded[I]->ID, ID))
-				return I;
+		std::sort(batch.begin(), batch.end(),
+			[](const PendingAssetLoad& lhs, const PendingAssetLoad& rhs)
+			{
+				return lhs.tableIdx != rhs.tableIdx ? lhs.tableIdx < rhs.tableIdx : lhs.position < rhs.position;
+			});
+
+		auto Coalescable = [](const PendingAssetLoad& load)
+			{
+				return load.extent && load.table->Entries[load.entry].Encoding == EResourceEncoding_Raw;
+			};
 
-		AssetHandle RHandle = 0xFFFFFFFFFFFFFFFF;
-		for (size_t TI = 0; TI < Resources.Tables.size(); ++TI)
+		size_t I = 0;
+		while (I < batch.size())
 		{
-			auto& t = Resources.Tables[TI];
-			for (size_t I = 0; I < t->ResourceCount; ++I)
+			auto& first = batch[I];
+
+			if (auto handle = Resources.FindLoaded(first.request->guid); handle)
+			{
+				first.request->Complete(*handle);
+				I++;
+				continue;
+			}
+
+			FILE* F = nullptr;
+			{
+				std::scoped_lock lock{ m };
+				F = files[first.tableIdx];
+			}
+
+			if (!Coalescable(first))
 			{
-				if (!strcmp(t->Entries[I].ID, ID))
+				auto resource = _ReadEntry(F, first.table, first.entry);
+				first.request->Complete(resource ? Resources.AddLoaded(resource) : INVALIDHANDLE);
+
+				I++;
+				continue;
+			}
+
+			// Pull following loads from the same pack into a single read while they're close enough together
+			size_t		end		= I + 1;
+			uint64_t	readEnd	= first.position + first.extent;
+
+			while (	end < batch.size() &&
+					batch[end].tableIdx == first.tableIdx &&
+					Coalescable(batch[end]) &&
+					batch[end].position <= readEnd + MaxCoalesceGap &&
+					Max(readEnd, batch[end].position + batch[end].extent) - first.position <= ResourceReadBatchSize)
+			{
+				readEnd = Max(readEnd, batch[end].position + batch[end].extent);
+				end++;
+			}
+
+			const uint64_t readBegin = first.position;
+
+			staging.resize(readEnd - readBegin);
+
+			fseek(F, (long)readBegin, SEEK_SET);
+			const size_t bytesRead = fread(staging.data(), 1, staging.size(), F);
+
+			for (; I < end; I++)
+			{
+				auto& load = batch[I];
+
+				if (auto handle = Resources.FindLoaded(load.request->guid); handle)
 				{
-					FILE* F             = 0;
-					int S               = fopen_s(&F, Resources.ResourceFiles[TI].str, "rb");
-					size_t ResourceSize = FlexKit::ReadAssetSize(F, t, I);
+					load.request->Complete(*handle);
+					continue;
+				}
 
-					Resource* NewResource = (Resource*)Resources.ResourceMemory->_aligned_malloc(ResourceSize);
-					if (!NewResource)
-					{
-						// Memory Full
-						// Evict A Unused Resource
-						// TODO: THIS
-						FK_ASSERT(false, "OUT OF MEMORY!");
-					}
+				const size_t	offset		= load.position - readBegin;
+				const Resource*	header		= (const Resource*)(staging.data() + offset);
 
-					if (!FlexKit::ReadResource(F, t, I, NewResource))
-					{
-						FK_ASSERT(false, "FAILED TO LOAD RESOURCE!");
-					}
-					else
-					{
-						NewResource->State		= Resource::EResourceState_LOADED;
-						NewResource->RefCount	= 0;
-						RHandle					= Resources.ResourcesLoaded.size();
-						Resources.ResourcesLoaded.push_back(NewResource);
-						Resources.ResourceGUIDs.push_back(NewResource->GUID);
-					}
+				if (offset + sizeof(Resource) > bytesRead ||
+					header->ResourceSize > load.extent ||
+					offset + header->ResourceSize > bytesRead)
+				{
+					load.request->Complete(INVALIDHANDLE);
+					continue;
+				}
 
-					::fclose(F);
-					return RHandle;
+				auto resource = (Resource*)Resources.ResourceMemory->_aligned_malloc(header->ResourceSize);
+				if (!resource)
+				{
+					load.request->Complete(INVALIDHANDLE);
+					continue;
 				}
+
+				memcpy(resource, header, header->ResourceSize);
+
+				resource->State		= Resource::EResourceState_LOADED;
+				resource->RefCount	= 0;
+
+				load.request->Complete(Resources.AddLoaded(resource));
 			}
 		}
+	}
+
+
+	/************************************************************************************************/
+
 
-		return RHandle;
+	void AssetIOQueue::Wait()
+	{
+		while (true)
+		{
+			{
+				std::scoped_lock lock{ m };
+
+				if (pending.empty() && !scheduled)
+					return;
+			}
+
+			if (auto work = Resources.threads ? Resources.threads->FindWork(true) : nullptr; work)
+				RunTask(*work);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+
+	/************************************************************************************************/
+
+
+	void AssetIOQueue::Release()
+	{
+		Wait();
+
+		std::scoped_lock lock{ m };
+
+		for (auto file : files)
+			fclose(file);
+
+		files.clear();
+		fileSizes.clear();
+		staging = {};
+	}
+
+
+	/************************************************************************************************/
+
+
+	AssetHandle AssetLoadRequest::Wait()
+	{
+		while (!IsComplete())
+		{
+			if (auto work = Resources.threads ? Resources.threads->FindWork(true) : nullptr; work)
+				RunTask(*work);
+			else
+				std::this_thread::yield();
+		}
+
+		return GetHandle();
+	}
+
+
+	/************************************************************************************************/
+
+
+	AssetLoadFuture _LoadGameAssetAsync(const std::optional<AssetHandle> loaded, ResourceEntry* entry, const size_t TI, auto&& loadSync)
+	{
+		auto request = std::make_shared<AssetLoadRequest>();
+
+		if (loaded)
+		{
+			request->guid = Resources.GetLoaded(*loaded)->GUID;
+			request->Complete(*loaded);
+		}
+		else if (!entry || !Resources.threads)
+		{
+			request->guid = entry ? entry->GUID : INVALIDHANDLE;
+			request->Complete(loadSync());
+		}
+		else
+		{
+			request->guid = entry->GUID;
+
+			AssetIO.Enqueue(
+				PendingAssetLoad{
+					.request	= request,
+					.table		= Resources.Tables[TI],
+					.tableIdx	= (uint32_t)TI,
+					.entry		= (uint32_t)(entry - Resources.Tables[TI]->Entries),
+					.position	= entry->ResourcePosition,
+					.extent		= 0 });
+		}
+
+		return request;
+	}
+
+
+	AssetLoadFuture LoadGameAssetAsync(GUID_t guid)
+	{
+		size_t TI = 0;
+		auto entry = Resources.FindEntry(guid, &TI);
+
+		return _LoadGameAssetAsync(Resources.FindLoaded(guid), entry, TI, [&] { return LoadGameAsset(guid); });
+	}
+
+
+	AssetLoadFuture LoadGameAssetAsync(const char* ID)
+	{
+		size_t TI = 0;
+		auto entry = Resources.FindEntry(ID, &TI);
+
+		return _LoadGameAssetAsync(Resources.FindLoaded(ID), entry, TI, [&] { return LoadGameAsset(ID); });
+	}
+
+
+	/************************************************************************************************/
+
+
+	void WaitForAssetLoads()
+	{
+		AssetIO.Wait();
 	}
 
 
@@ -529,7 +1154,22 @@ namespace FlexKit
 		const int seek_res    = fseek(F, 0, SEEK_SET);
 		const size_t read_res = fread(Out, 1, TableSize, F);
 
-		return (read_res == TableSize);
+		if (read_res != TableSize || Out->MagicNumber != ResourceTableMagicNumber)
+			return false;
+
+		switch (Out->Version)
+		{
+		case 2: // Encoding was an unused pointer, only raw resources
+			for (size_t I = 0; I < Out->ResourceCount; ++I)
+				Out->Entries[I].Encoding = EResourceEncoding_Raw;
+
+			return true;
+		case ResourceTableVersion:
+			return true;
+		default:
+			FK_LOG_ERROR("Unknown resource table version %u!", (uint32_t)Out->Version);
+			return false;
+		}
 	}
 
 
@@ -543,6 +1183,9 @@ namespace FlexKit
 		const int seek_res      = fseek(F, (long)Table->Entries[Index].ResourcePosition, SEEK_SET);
 		const size_t read_res   = fread(Buffer, 1, 64, F);
 
+		if (Table->Entries[Index].Encoding == EResourceEncoding_BlockCompressed)
+			return ((CompressedResourceHeader*)Buffer)->ResourceSize;
+
 		Resource* resource = (Resource*)Buffer;
 		return resource->ResourceSize;
 	}
@@ -551,6 +1194,200 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	bool ReadCompressedResource(FILE* F, const size_t position, const size_t resourceFileSize, Resource* out)
+	{
+		CompressedResourceHeader header;
+
+		fseek(F, (long)position, SEEK_SET);
+		if (fread(&header, 1, sizeof(header), F) != sizeof(header))
+			return false;
+
+		// Blocks decompress straight into out, sized from ResourceSize. The block table has to tile exactly that.
+		if (!header.ResourceSize || !header.BlockSize ||
+			header.BlockCount != header.ResourceSize / header.BlockSize + (header.ResourceSize % header.BlockSize != 0))
+		{
+			FK_LOG_ERROR("Corrupt compressed resource at %u, %u blocks of %u bytes can't hold %u bytes!",
+				(uint32_t)position, header.BlockCount, header.BlockSize, (uint32_t)header.ResourceSize);
+			return false;
+		}
+
+		const size_t tableEnd	= sizeof(CompressedResourceHeader) + header.BlockCount * sizeof(CompressedResourceBlock);
+		const size_t fileEnd	= resourceFileSize - 1 > position ? resourceFileSize - 1 - position : 0;
+
+		if (tableEnd > fileEnd)
+		{
+			FK_LOG_ERROR("Corrupt compressed resource at %u, block table runs past the end of the file!", (uint32_t)position);
+			return false;
+		}
+
+		auto& allocator = *Resources.ResourceMemory;
+
+		Vector<CompressedResourceBlock> blocks{ &allocator, header.BlockCount, CompressedResourceBlock{} };
+		if (fread(blocks.data(), sizeof(CompressedResourceBlock), header.BlockCount, F) != header.BlockCount)
+			return false;
+
+		// Every block has to sit after the table, in order without overlapping, and inside the file.
+		// Batched reads and the scratch buffer offsets below rely on it.
+		size_t blockBegin = tableEnd;
+		for (auto& block : blocks)
+		{
+			if (block.Offset < blockBegin || !block.CompressedSize ||
+				block.Offset > fileEnd || block.CompressedSize > fileEnd - block.Offset)
+			{
+				FK_LOG_ERROR("Corrupt compressed resource at %u, block table is out of range!", (uint32_t)position);
+				return false;
+			}
+
+			blockBegin = block.Offset + block.CompressedSize;
+		}
+
+		const size_t dataBegin	= blocks.front().Offset;
+		const size_t dataEnd	= blocks.back().Offset + blocks.back().CompressedSize;
+
+		byte* compressed = (byte*)allocator.malloc(dataEnd - dataBegin);
+		if (!compressed)
+			return false;
+
+		EXITSCOPE(allocator.free(compressed));
+
+		std::atomic_bool failed = false;
+
+		auto DecompressBlockRange =
+			[&, compressed](const size_t begin, const size_t end)
+			{
+				for (size_t I = begin; I < end; I++)
+				{
+					const size_t outOffset	= I * header.BlockSize;
+					const size_t outSize	= Min(size_t(header.BlockSize), header.ResourceSize - outOffset);
+
+					if (!DecompressBlock(compressed + blocks[I].Offset - dataBegin, blocks[I].CompressedSize, (byte*)out + outOffset, outSize))
+						failed.store(true, std::memory_order_relaxed);
+				}
+			};
+
+		auto threads = header.BlockCount > 1 ? Resources.threads : nullptr;
+
+		// Blocks are handed to the workers as each batch of reads lands, the next batch is read while they decompress
+		std::optional<WorkBarrier> barrier;
+		if (threads)
+			barrier.emplace(*threads, SystemAllocator);
+
+		size_t batchBegin = 0;
+		while (batchBegin < header.BlockCount)
+		{
+			size_t batchEnd = batchBegin + 1;
+			while (batchEnd < header.BlockCount && blocks[batchEnd].Offset - blocks[batchBegin].Offset < ResourceReadBatchSize)
+				batchEnd++;
+
+			const size_t readBegin	= blocks[batchBegin].Offset;
+			const size_t readEnd	= blocks[batchEnd - 1].Offset + blocks[batchEnd - 1].CompressedSize;
+
+			fseek(F, (long)(position + readBegin), SEEK_SET);
+			if (fread(compressed + readBegin - dataBegin, 1, readEnd - readBegin, F) != readEnd - readBegin)
+			{
+				failed = true;
+				break;
+			}
+
+			if (threads)
+			{
+				for (size_t I = batchBegin; I < batchEnd; I++)
+				{
+					auto& workItem = CreateWorkItem(
+						[&, I](iAllocator&)
+						{
+							DecompressBlockRange(I, I + 1);
+						}, SystemAllocator);
+
+					barrier->AddWork(workItem);
+					threads->AddWork(&workItem);
+				}
+			}
+			else
+				DecompressBlockRange(batchBegin, batchEnd);
+
+			batchBegin = batchEnd;
+		}
+
+		if (barrier)
+			barrier->Join();
+
+		return !failed && out->ResourceSize == header.ResourceSize;
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool CompressResource(const void* resource, const size_t resourceSize, std::vector<byte>& out, ThreadManager* threads, const size_t blockSize)
+	{
+		if (!resourceSize || !blockSize || blockSize > std::numeric_limits<uint32_t>::max())
+			return false;
+
+		const size_t blockCount = (resourceSize + blockSize - 1) / blockSize;
+		const size_t blockBound = CompressBlockBound(blockSize);
+
+		std::vector<byte>		scratch(blockCount * blockBound);
+		std::vector<size_t>		compressedSizes(blockCount);
+		std::atomic_bool		failed = false;
+
+		auto CompressBlockRange =
+			[&](const size_t begin, const size_t end)
+			{
+				for (size_t I = begin; I < end; I++)
+				{
+					const size_t inOffset	= I * blockSize;
+					const size_t inSize		= Min(blockSize, resourceSize - inOffset);
+
+					if (auto res = CompressBlock((const byte*)resource + inOffset, inSize, scratch.data() + I * blockBound, blockBound); res)
+						compressedSizes[I] = res.value();
+					else
+						failed.store(true, std::memory_order_relaxed);
+				}
+			};
+
+		if (threads && blockCount > 1)
+		{
+			Parallel_ForRange(*threads, *SystemAllocator, compressedSizes.begin(), compressedSizes.end(),
+				[&](auto begin, auto end, iAllocator&)
+				{
+					CompressBlockRange(begin - compressedSizes.begin(), end - compressedSizes.begin());
+				});
+		}
+		else
+			CompressBlockRange(0, blockCount);
+
+		if (failed)
+			return false;
+
+		const size_t tableSize = sizeof(CompressedResourceHeader) + sizeof(CompressedResourceBlock) * blockCount;
+
+		size_t totalSize = tableSize;
+		for (auto size : compressedSizes)
+			totalSize += size;
+
+		out.resize(totalSize);
+
+		CompressedResourceHeader header{ resourceSize, uint32_t(blockSize), uint32_t(blockCount) };
+		memcpy(out.data(), &header, sizeof(header));
+
+		size_t offset = tableSize;
+		for (size_t I = 0; I < blockCount; I++)
+		{
+			CompressedResourceBlock block{ offset, compressedSizes[I] };
+			memcpy(out.data() + sizeof(header) + I * sizeof(block), &block, sizeof(block));
+			memcpy(out.data() + offset, scratch.data() + I * blockBound, compressedSizes[I]);
+
+			offset += compressedSizes[I];
+		}
+
+		return true;
+	}
+
+
+	/************************************************************************************************/
+
+
 	bool ReadResource(FILE* F, ResourceTable* Table, size_t Index, Resource* out)
 	{
 		FK_LOG_INFO( "Loading Resource: %s : ResourceID: %u", Table->Entries[Index].ID, Table->Entries[Index].GUID);
@@ -574,6 +1411,9 @@ namespace FlexKit
 		const size_t position   = Table->Entries[Index].ResourcePosition;
 		int seek_res            = fseek(F, (long)position, SEEK_SET);
 
+		if (Table->Entries[Index].Encoding == EResourceEncoding_BlockCompressed)
+			return ReadCompressedResource(F, position, resourceFileSize, out);
+
 		size_t resourceSize = 0;
 		size_t read_res     = fread(&resourceSize, 1, 8, F);
 
@@ -592,20 +1432,8 @@ namespace FlexKit
 
 	bool isAssetAvailable(GUID_t ID)
 	{
-		for (size_t I = 0; I < Resources.ResourcesLoaded.size(); ++I)
-			if (Resources.ResourcesLoaded[I]->GUID == ID)
-				return true;
-
-		AssetHandle RHandle = 0xFFFFFFFFFFFFFFFF;
-		for (size_t TI = 0; TI < Resources.Tables.size(); ++TI)
-		{
-			auto& t = Resources.Tables[TI];
-			for (size_t I = 0; I < t->ResourceCount; ++I)
-			{
-				if (t->Entries[I].GUID == ID)
-					return true;
-			}
-		}
+		if (Resources.FindLoaded(ID) || Resources.FindEntry(ID))
+			return true;
 
 		auto res = Resources.failureHandler(ID);
 		if (res != INVALIDHANDLE)
@@ -620,20 +1448,8 @@ namespace FlexKit
 
 	bool isAssetAvailable(const char* ID)
 	{
-			for (size_t I = 0; I < Resources.ResourcesLoaded.size(); ++I)
-			if (!strcmp(Resources.ResourcesLoaded[I]->ID, ID))
-				return true;
-
-		AssetHandle RHandle = 0xFFFFFFFFFFFFFFFF;
-		for (size_t TI = 0; TI < Resources.Tables.size(); ++TI)
-		{
-			auto& t = Resources.Tables[TI];
-			for (size_t I = 0; I < t->ResourceCount; ++I)
-			{
-				if (!strcmp(t->Entries[I].ID, ID))
-					return true;
-			}
-		}
+		if (Resources.FindLoaded(ID) || Resources.FindEntry(ID))
+			return true;
 
 		auto res = Resources.failureHandler(ID);
 		if (res != INVALIDHANDLE)
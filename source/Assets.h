@@ -11,6 +11,8 @@
 
 #define WINDOW_LEAN_AND_MEAN
 
+#include <atomic>
+#include <memory>
 #include <variant>
 #include <iostream>
 #include <Windows.h>
@@ -24,6 +26,7 @@ namespace FlexKit
 	static const size_t ID_LENGTH = 64;
 
 	class RenderSystem;
+	class ThreadManager;
 	struct TriMesh;
 	struct TriMesh;
 	struct TextureSet;
@@ -75,11 +78,18 @@ namespace FlexKit
 	/************************************************************************************************/
 
 	
+	enum EResourceEncoding : uint32_t
+	{
+		EResourceEncoding_Raw,
+		EResourceEncoding_BlockCompressed,
+	};
+
 	struct ResourceEntry
 	{
 		GUID_t					GUID;
 		size_t					ResourcePosition;
-		char*					ResouceLOC; // Not Used in File
+		EResourceEncoding		Encoding;	// Zero in older files, used to be an unused pointer
+		uint32_t				Reserved;
 		EResourceType			Type;
 		char					ID[ID_LENGTH];
 	};
@@ -92,6 +102,38 @@ namespace FlexKit
 		ResourceEntry	Entries[];
 	};
 
+	constexpr size_t ResourceTableMagicNumber	= 0xF4F3F2F1F4F3F2F1;
+	constexpr size_t ResourceTableVersion		= 3; // 3: entries record an EResourceEncoding, 2: raw entries only
+
+
+	/************************************************************************************************/
+
+
+	/*
+	* Block compressed resource layout:
+	* { CompressedResourceHeader }
+	*   [CompressedResourceBlock] * BlockCount
+	* { Blocks }
+	*
+	* Block I decompresses on its own into bytes [I * BlockSize, (I + 1) * BlockSize) of the resource.
+	*/
+
+	struct CompressedResourceHeader
+	{
+		uint64_t	ResourceSize;
+		uint32_t	BlockSize;
+		uint32_t	BlockCount;
+	};
+
+	struct CompressedResourceBlock
+	{
+		uint64_t	Offset;			// From the start of the CompressedResourceHeader
+		uint64_t	CompressedSize;
+	};
+
+	constexpr size_t DefaultResourceBlockSize	= 256 * KILOBYTE;
+	constexpr size_t ResourceReadBatchSize		= 4 * MEGABYTE;
+
 
 	/************************************************************************************************/
 
@@ -99,23 +141,67 @@ namespace FlexKit
 	using AssetFailureHandler	= TypeErasedCallable<AssetHandle (AssetIdentifier)>;
 	struct ResourceTable;
 
-	FLEXKITAPI void			InitiateAssetTable	(iAllocator* Memory);
+	FLEXKITAPI void			InitiateAssetTable	(iAllocator* Memory, ThreadManager* threads = nullptr);
 	FLEXKITAPI void			ReleaseAssetTable	();
 
 	FLEXKITAPI size_t		ReadAssetTableSize	    (FILE* F);
 	FLEXKITAPI size_t		ReadAssetSize		    (FILE* F, ResourceTable* Table, size_t Index);
 
 	FLEXKITAPI void					    AddAssetFile	(const char* FILELOC);
-	FLEXKITAPI AssetHandle			    AddAssetBuffer	(Resource*);            // Will increment resource refcount
+	FLEXKITAPI AssetHandle			    AddAssetBuffer	(Resource*);            // Will increment resource refcount, takes ownership of a malloc'd buffer
 	FLEXKITAPI Resource*			    GetAsset		(AssetHandle RHandle);
 	FLEXKITAPI std::optional<GUID_t>    FindAssetGUID	(const char* Str);
 
 	FLEXKITAPI bool			ReadAssetTable	(FILE* F, ResourceTable* Out, size_t TableSize);
 	FLEXKITAPI bool			ReadResource	(FILE* F, ResourceTable* Table, size_t Index, Resource* out);
 
+	// Packs a resource into the block compressed layout, blocks are compressed on threads when given
+	FLEXKITAPI bool			CompressResource	(const void* resource, const size_t resourceSize, std::vector<byte>& out, ThreadManager* threads = nullptr, const size_t blockSize = DefaultResourceBlockSize);
+
 	FLEXKITAPI AssetHandle LoadGameAsset (const char* ID);  // Asset refcount starts at 1
 	FLEXKITAPI AssetHandle LoadGameAsset (GUID_t GUID);     // Asset refcount starts at 1
 
+
+	/************************************************************************************************/
+
+
+	enum class AssetLoadStatus : uint32_t
+	{
+		Pending,
+		Loaded,
+		Failed,
+	};
+
+
+	struct AssetLoadRequest
+	{
+		AssetLoadStatus	GetStatus()		const noexcept { return status.load(std::memory_order_acquire); }
+		bool			IsComplete()	const noexcept { return GetStatus() != AssetLoadStatus::Pending; }
+		AssetHandle		GetHandle()		const noexcept { return GetStatus() == AssetLoadStatus::Loaded ? handle : INVALIDHANDLE; }
+
+		// Runs queued work on the calling thread until the load completes
+		FLEXKITAPI AssetHandle Wait();
+
+		void Complete(const AssetHandle IN_handle) noexcept
+		{
+			handle = IN_handle;
+			status.store(IN_handle != INVALIDHANDLE ? AssetLoadStatus::Loaded : AssetLoadStatus::Failed, std::memory_order_release);
+		}
+
+		GUID_t							guid	= INVALIDHANDLE;
+		AssetHandle						handle	= INVALIDHANDLE;
+		std::atomic<AssetLoadStatus>	status	= AssetLoadStatus::Pending;
+	};
+
+	using AssetLoadFuture = std::shared_ptr<AssetLoadRequest>;
+
+
+	// Queued loads are sorted by pack file and offset and adjacent resources are read together.
+	// Loads complete on a background worker of the ThreadManager given to InitiateAssetTable, without one they complete immediately.
+	FLEXKITAPI AssetLoadFuture	LoadGameAssetAsync	(GUID_t GUID);
+	FLEXKITAPI AssetLoadFuture	LoadGameAssetAsync	(const char* ID);
+	FLEXKITAPI void				WaitForAssetLoads	();
+
 	FLEXKITAPI void FreeAsset			    (AssetHandle RHandle);
 	FLEXKITAPI void FreeAllAssets		();
 	FLEXKITAPI void FreeAllAssetFiles	();
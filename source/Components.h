@@ -10,7 +10,10 @@
 #include "ThreadUtilities.h"
 #include "type.h"
 
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <type_traits>
 #include <tuple>
 #include <span>
@@ -23,6 +26,7 @@ namespace FlexKit
 	constexpr ComponentID InvalidComponentID = -1;
 
 	class GameObject;
+	class ArchetypeStorage;
 
 	using KeyValuePair	= std::pair<uint32_t, void*>;
 	using ValueMap		= std::span<KeyValuePair>;
@@ -415,6 +419,11 @@ namespace FlexKit
 		auto begin()	const { return views.begin(); }
 		auto end()		const { return views.end(); }
 
+		// Row in archetypeStorage, only set while the object has archetype components.
+		// Every archetype component on one object has to use the same storage.
+		uint32_t			archetypeEntity		= 0xffffffff;
+		ArchetypeStorage*	archetypeStorage	= nullptr;
+
 	private:
 		Vector<uint32_t, 8, uint8_t>					ids;	// component + Code
 		Vector<ComponentViewContainer, 8, uint8_t>		views;	// component + Code
@@ -608,6 +617,154 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	// Components a query or task reads and writes, used to catch concurrent queries that would race
+	struct ComponentAccess
+	{
+		static_vector<ComponentID, 16>	reads;
+		static_vector<ComponentID, 16>	writes;
+		bool							exclusive = false; // Mutable access without a component ID, ex. GameObjectReq
+
+		void Read(const ComponentID ID)
+		{
+			if (std::find(reads.begin(), reads.end(), ID) == reads.end())
+				reads.push_back(ID);
+		}
+
+		void Write(const ComponentID ID)
+		{
+			if (std::find(writes.begin(), writes.end(), ID) == writes.end())
+				writes.push_back(ID);
+		}
+
+		bool Conflicts(const ComponentAccess& rhs) const noexcept
+		{
+			if (exclusive || rhs.exclusive)
+				return true;
+
+			for (auto ID : writes)
+			{
+				if (std::find(rhs.reads.begin(), rhs.reads.end(), ID) != rhs.reads.end() ||
+					std::find(rhs.writes.begin(), rhs.writes.end(), ID) != rhs.writes.end())
+					return true;
+			}
+
+			for (auto ID : rhs.writes)
+			{
+				if (std::find(reads.begin(), reads.end(), ID) != reads.end())
+					return true;
+			}
+
+			return false;
+		}
+	};
+
+
+	template<typename TY_Query>
+	void DeclareAccess(ComponentAccess& access)
+	{
+		using View_TY = std::remove_reference_t<typename TY_Query::ValueType>;
+
+		if constexpr (requires { View_TY::GetComponentID(); })
+		{
+			if constexpr (TY_Query::IsConst())
+				access.Read(View_TY::GetComponentID());
+			else
+				access.Write(View_TY::GetComponentID());
+		}
+		else if constexpr (!TY_Query::IsConst())
+			access.exclusive = true;
+	}
+
+
+	template<typename ... TY_Queries>
+	ComponentAccess GetComponentAccess()
+	{
+		ComponentAccess access;
+		(DeclareAccess<TY_Queries>(access), ...);
+
+		return access;
+	}
+
+
+	// Tracks the access of running queries, Acquire fails if the new query would conflict with one of them
+	class ComponentAccessTracker
+	{
+	public:
+		ComponentAccessTracker(iAllocator* allocator) :
+			active{ allocator } {}
+
+		uint64_t Acquire(const ComponentAccess& access)
+		{
+			std::scoped_lock lock{ m };
+
+			for (auto& entry : active)
+			{
+				if (entry.access.Conflicts(access))
+					return InvalidTicket;
+			}
+
+			const auto ticket = ++ticketCounter;
+			active.push_back({ ticket, access });
+
+			return ticket;
+		}
+
+		void Release(const uint64_t ticket)
+		{
+			std::scoped_lock lock{ m };
+
+			for (size_t I = 0; I < active.size(); ++I)
+			{
+				if (active[I].ticket == ticket)
+				{
+					active.remove_unstable(active.begin() + I);
+					return;
+				}
+			}
+		}
+
+		static constexpr uint64_t InvalidTicket = 0;
+
+		// Holds a ticket for its scope, so it is released even if the query's callback throws
+		class ScopedTicket
+		{
+		public:
+			ScopedTicket(ComponentAccessTracker& IN_tracker, const ComponentAccess& access) :
+				tracker	{ IN_tracker },
+				ticket	{ IN_tracker.Acquire(access) } {}
+
+			~ScopedTicket()
+			{
+				if (ticket != InvalidTicket)
+					tracker.Release(ticket);
+			}
+
+			ScopedTicket(const ScopedTicket&)				= delete;
+			ScopedTicket& operator = (const ScopedTicket&)	= delete;
+
+			explicit operator bool() const noexcept { return ticket != InvalidTicket; }
+
+		private:
+			ComponentAccessTracker&	tracker;
+			const uint64_t			ticket;
+		};
+
+	private:
+		struct Entry
+		{
+			uint64_t		ticket;
+			ComponentAccess	access;
+		};
+
+		std::mutex		m;
+		Vector<Entry>	active;
+		uint64_t		ticketCounter = 0;
+	};
+
+
+	/************************************************************************************************/
+
+
 	template<typename TY_Component>
 	class BasicComponentView_t : public ComponentView_t<TY_Component>
 	{
@@ -1276,7 +1433,8 @@ namespace FlexKit
 
 		UpdateTask(ThreadManager* IN_manager, iUpdateFN& IN_updateFn, iAllocator* IN_allocator) :
 			Update		{ IN_updateFn						},
-			threadTask	{ this, IN_manager, IN_allocator	} {}
+			threadTask	{ this, IN_manager, IN_allocator	},
+			inputs		{ IN_allocator						} {}
 
 		// No Copy
 		UpdateTask				(const UpdateTask&)	= delete;
@@ -1300,10 +1458,15 @@ namespace FlexKit
 			{
 				ProfileFunction();
 
+				task->beginTime = std::chrono::high_resolution_clock::now();
 				task->Run(threadAllocator);
 			}
 
-			void Release() override {}
+			// Called once the task is complete, after Run returns or once a suspended WorkCoroutine finishes
+			void Release() override
+			{
+				task->endTime = std::chrono::high_resolution_clock::now();
+			}
 		}threadTask;
 
 
@@ -1319,10 +1482,20 @@ namespace FlexKit
 		}
 
 
+		bool HasInput(const UpdateTask& input) const noexcept
+		{
+			return std::find(inputs.begin(), inputs.end(), &input) != inputs.end();
+		}
+
+
 		void AddInput(UpdateTask& input) 
 		{
+			if (HasInput(input))
+				return;
+
 			counter++;
 			leaf = false;
+			inputs.push_back(&input);
 
 			input.AddContinuationTask(
 				[&]
@@ -1372,6 +1545,13 @@ namespace FlexKit
 		UpdateID_t			ID			= (uint32_t)-1;
 		iUpdateFN&			Update;
 		char*				Data;
+
+		Vector<UpdateTask*>	inputs;
+		ComponentAccess		access;
+		bool				accessDeclared	= false;
+
+		std::chrono::high_resolution_clock::time_point	beginTime;
+		std::chrono::high_resolution_clock::time_point	endTime;
 	};
 
 
@@ -1395,10 +1575,12 @@ namespace FlexKit
 
 
 		UpdateDispatcher(ThreadManager* IN_threads, iAllocator* IN_allocator) :
-			nodes		{ IN_allocator	},
-			allocator	{ IN_allocator	},
-			threads		{ IN_threads	},
-			taskMap		{ IN_allocator  } {}
+			nodes			{ IN_allocator	},
+			allocator		{ IN_allocator	},
+			threads			{ IN_threads	},
+			taskMap			{ IN_allocator  },
+			accessTable		{ IN_allocator  },
+			sinceExclusive	{ IN_allocator  } {}
 
 
 		// No Copy
@@ -1409,6 +1591,11 @@ namespace FlexKit
 		void Execute()
 		{
 			ProfileFunction();
+
+			const auto executeBegin = std::chrono::high_resolution_clock::now();
+
+			MarkCriticalPath();
+
 			WorkBarrier barrier{ *threads, allocator };
 
 			for (auto& node : nodes)
@@ -1420,8 +1607,97 @@ namespace FlexKit
 
 			barrier.JoinLocal();
 
+			lastStats = ExecuteStats{};
+			lastStats.taskCount		= nodes.size();
+			lastStats.executeTime	= std::chrono::duration_cast<nanoseconds>(std::chrono::high_resolution_clock::now() - executeBegin);
+
+			for (auto node : nodes)
+			{
+				if (node->threadTask.GetPriority() == WorkPriority::Critical)
+				{
+					lastStats.criticalPathLength++;
+					lastStats.criticalPathTime += std::chrono::duration_cast<nanoseconds>(node->endTime - node->beginTime);
+				}
+			}
+
+			threads->_RecordGraph({
+				.taskCount			= lastStats.taskCount,
+				.criticalPathLength	= lastStats.criticalPathLength,
+				.criticalPathTime	= lastStats.criticalPathTime,
+				.executeTime		= lastStats.executeTime });
+
+			if (graphDumpPath)
+			{
+				std::ofstream dumpFile{ graphDumpPath, std::ios::out };
+				DumpGraph(dumpFile);
+
+				graphDumpPath = nullptr;
+			}
+
 			nodes.clear();
 			taskMap.clear();
+			accessTable.clear();
+			sinceExclusive.clear();
+			lastExclusive = nullptr;
+		}
+
+
+		// Writes the task graph in graphviz dot format, after Execute nodes are labeled with their run times
+		void DumpGraph(std::ostream& out) const
+		{
+			auto frameBegin = std::chrono::high_resolution_clock::time_point::max();
+			for (auto node : nodes)
+				if (node->beginTime.time_since_epoch().count())
+					frameBegin = std::min(frameBegin, node->beginTime);
+
+			out << "digraph UpdateGraph {\n";
+			out << "\tnode [shape=box];\n";
+
+			for (auto node : nodes)
+			{
+				out << "\tn" << (const void*)node << " [label=\"" << node->threadTask._debugID;
+
+				if (node->beginTime.time_since_epoch().count())
+				{
+					using fms = std::chrono::duration<double, std::milli>;
+					const auto start	= std::chrono::duration_cast<fms>(node->beginTime - frameBegin).count();
+					const auto duration	= std::chrono::duration_cast<fms>(node->endTime - node->beginTime).count();
+
+					out << "\\nstart: " << start << "ms\\nduration: " << duration << "ms";
+				}
+
+				out << "\"";
+
+				if (node->threadTask.GetPriority() == WorkPriority::Critical)
+					out << " color=red";
+
+				out << "];\n";
+			}
+
+			for (auto node : nodes)
+				for (auto input : node->inputs)
+					out << "\tn" << (const void*)input << " -> n" << (const void*)node << ";\n";
+
+			out << "}\n";
+		}
+
+
+		struct ExecuteStats
+		{
+			size_t		taskCount			= 0;
+			size_t		criticalPathLength	= 0;
+			nanoseconds	criticalPathTime	= {};	// Sum of the run times of the critical tasks
+			nanoseconds	executeTime			= {};
+		};
+
+		// Stats of the last Execute, the gap between executeTime and criticalPathTime is the time spent waiting on scheduling
+		const ExecuteStats& GetLastExecuteStats() const noexcept { return lastStats; }
+
+
+		// Dumps the graph to file at the end of the next Execute
+		void DumpGraphOnNextExecute(const char* path) noexcept
+		{
+			graphDumpPath = path;
 		}
 
 
@@ -1439,6 +1715,41 @@ namespace FlexKit
 			}
 
 
+			// Declared access is used to order this task after earlier tasks that it conflicts with
+			void Reads(const ComponentID ID)
+			{
+				newNode.access.Read(ID);
+				newNode.accessDeclared = true;
+			}
+
+
+			void Writes(const ComponentID ID)
+			{
+				newNode.access.Write(ID);
+				newNode.accessDeclared = true;
+			}
+
+
+			void Exclusive()
+			{
+				newNode.access.exclusive	= true;
+				newNode.accessDeclared		= true;
+			}
+
+
+			template<typename ... TY_Queries>
+			void DeclareAccess()
+			{
+				const auto access = GetComponentAccess<TY_Queries...>();
+
+				for (auto ID : access.reads)	Reads(ID);
+				for (auto ID : access.writes)	Writes(ID);
+
+				if (access.exclusive)
+					Exclusive();
+			}
+
+
 			void AddOutput(UpdateTask& node)
 			{
 				node.AddInput(newNode);
@@ -1515,6 +1826,11 @@ namespace FlexKit
 			typename FN_UPDATE>
 		Task<TY_NODEDATA>&	Add(FN_LINKAGE LinkageSetup, FN_UPDATE&& UpdateFN)
 		{
+			using Result_TY = std::invoke_result_t<FN_UPDATE&, TY_NODEDATA&, iAllocator&>;
+
+			static_assert(std::is_void_v<Result_TY> || std::is_same_v<Result_TY, WorkCoroutine>,
+				"Update functions return void, or WorkCoroutine to co_await WorkBarriers without blocking their worker");
+
 			struct data_BoilderPlate : UpdateTask::iUpdateFN
 			{
 				data_BoilderPlate(FN_UPDATE&& IN_fn) : 
@@ -1522,7 +1838,14 @@ namespace FlexKit
 
 				virtual void operator() (UpdateTask& task, iAllocator& threadAllocator) override
 				{
-					function(locals, threadAllocator);
+					if constexpr (std::is_same_v<Result_TY, WorkCoroutine>)
+					{	// A suspended coroutine is adopted by task's threadTask, the task and its continuations
+						// only complete once it finishes. The update function is kept alive by the dispatcher,
+						// its captures stay valid across co_awaits
+						WorkCoroutine coroutine = function(locals, threadAllocator);
+					}
+					else
+						function(locals, threadAllocator);
 				}
 
 				TY_NODEDATA locals;
@@ -1536,15 +1859,181 @@ namespace FlexKit
 			UpdateBuilder Builder{ newNode, *this };
 			LinkageSetup(Builder, functor.locals);
 
+			if (newNode.accessDeclared)
+				InferDependencies(newNode);
+
 			nodes.push_back(&newNode);
 
 			return newNode;
 		}
 
+
 		ThreadManager*								threads;
 		Vector<UpdateTask*>							nodes;
 		Vector<std::pair<uint32_t, UpdateTask*>>	taskMap;
 		iAllocator*									allocator;
+
+	private:
+
+		struct AccessRecord
+		{
+			ComponentID			ID;
+			UpdateTask*			lastWriter;
+			Vector<UpdateTask*>	readers; // Readers since the last write
+		};
+
+
+		AccessRecord& GetAccessRecord(const ComponentID ID)
+		{
+			for (auto& record : accessTable)
+				if (record.ID == ID)
+					return record;
+
+			accessTable.push_back(AccessRecord{ ID, nullptr, Vector<UpdateTask*>{ allocator } });
+
+			return accessTable.back();
+		}
+
+
+		// Marks the tasks on the longest dependency chain as critical, so the scheduler picks them before other work
+		void MarkCriticalPath()
+		{
+			ProfileFunction();
+
+			const size_t nodeCount = nodes.size();
+
+			Vector<uint32_t> depth	{ allocator, nodeCount, 1u };	// Longest chain ending at the node
+			Vector<uint32_t> height	{ allocator, nodeCount, 1u };	// Longest chain starting at the node
+
+			// Map tasks to their node index once, the relaxation below only walks index pairs
+			Vector<std::pair<const UpdateTask*, uint32_t>> indexMap{ allocator, nodeCount };
+
+			for (size_t I = 0; I < nodeCount; ++I)
+				indexMap.emplace_back(nodes[I], uint32_t(I));
+
+			std::sort(indexMap.begin(), indexMap.end());
+
+			struct Edge
+			{
+				uint32_t input;
+				uint32_t output;
+			};
+
+			Vector<Edge> edges{ allocator, nodeCount };
+
+			for (size_t I = 0; I < nodeCount; ++I)
+			{
+				for (auto input : nodes[I]->inputs)
+				{
+					auto res = std::lower_bound(
+						indexMap.begin(), indexMap.end(), input,
+						[](const auto& lhs, const UpdateTask* rhs) { return lhs.first < rhs; });
+
+					if (res != indexMap.end() && res->first == input)
+						edges.push_back({ res->second, uint32_t(I) });
+				}
+			}
+
+			// Inputs aren't guaranteed to be added before their outputs, relax until stable
+			bool changed = true;
+			for (size_t itr = 0; changed && itr < nodeCount; ++itr)
+			{
+				changed = false;
+
+				for (const auto [inputIdx, I] : edges)
+				{
+					if (depth[I] < depth[inputIdx] + 1)
+					{
+						depth[I]	= depth[inputIdx] + 1;
+						changed		= true;
+					}
+
+					if (height[inputIdx] < height[I] + 1)
+					{
+						height[inputIdx]	= height[I] + 1;
+						changed				= true;
+					}
+				}
+			}
+
+			uint32_t longestChain = 0;
+			for (size_t I = 0; I < nodeCount; ++I)
+				longestChain = Max(longestChain, depth[I]);
+
+			for (size_t I = 0; I < nodeCount; ++I)
+			{
+				const bool critical = longestChain > 1 && depth[I] + height[I] - 1 == longestChain;
+				nodes[I]->threadTask.SetPriority(critical ? WorkPriority::Critical : WorkPriority::Normal);
+			}
+		}
+
+
+		// Orders tasks with declared access in submission order: reads wait on the last writer,
+		// writes wait on the readers since the last writer (or the last writer), exclusive tasks wait on everything.
+		void InferDependencies(UpdateTask& task)
+		{
+			if (task.access.exclusive)
+			{
+				if (lastExclusive)
+					task.AddInput(*lastExclusive);
+
+				for (auto previous : sinceExclusive)
+					task.AddInput(*previous);
+
+				accessTable.clear();
+				sinceExclusive.clear();
+				lastExclusive = &task;
+
+				return;
+			}
+
+			if (lastExclusive)
+				task.AddInput(*lastExclusive);
+
+			for (auto ID : task.access.writes)
+			{
+				auto& record = GetAccessRecord(ID);
+
+				if (record.readers.size())
+				{
+					for (auto reader : record.readers)
+						if (reader != &task)
+							task.AddInput(*reader);
+				}
+				else if (record.lastWriter)
+					task.AddInput(*record.lastWriter);
+			}
+
+			for (auto ID : task.access.reads)
+			{
+				if (std::find(task.access.writes.begin(), task.access.writes.end(), ID) != task.access.writes.end())
+					continue;
+
+				auto& record = GetAccessRecord(ID);
+
+				if (record.lastWriter)
+					task.AddInput(*record.lastWriter);
+
+				record.readers.push_back(&task);
+			}
+
+			for (auto ID : task.access.writes)
+			{
+				auto& record = GetAccessRecord(ID);
+
+				record.lastWriter = &task;
+				record.readers.clear();
+			}
+
+			sinceExclusive.push_back(&task);
+		}
+
+
+		Vector<AccessRecord>	accessTable;
+		Vector<UpdateTask*>		sinceExclusive;
+		UpdateTask*				lastExclusive	= nullptr;
+		const char*				graphDumpPath	= nullptr;
+		ExecuteStats			lastStats;
 	};
 
 
@@ -40,7 +40,7 @@ namespace FlexKit
 		Memory			{ memory										},
 		CmdArguments	{ memory->BlockAllocator						},
 		Time			{ memory->BlockAllocator						},
-		Threads			{ options.threadCount, memory->BlockAllocator	},
+		Threads			{ options.threadCount, memory->BlockAllocator, options.pinWorkerThreads	},
 		RenderSystem	{ *(new FlexKit::RenderSystem{ memory->BlockAllocator, &Threads }) }
 	{
 		InitiateSceneNodeBuffer(memory->BlockAllocator);
@@ -113,6 +113,7 @@ namespace FlexKit
 	void ReleaseEngineMemory(EngineMemory* Memory)
 	{
 		DEBUGBLOCK(PrintBlockStatus(&Memory->GetBlockMemory()));
+		Memory->BlockAllocator.Release();
 		_aligned_free(Memory);
 	}
 
@@ -136,7 +137,7 @@ namespace FlexKit
 			return false;
 		}
 
-		InitiateAssetTable(GetBlockMemory());
+		InitiateAssetTable(GetBlockMemory(), &Threads);
 
 		return true;
 	}
@@ -123,10 +123,11 @@ namespace FlexKit
 
 	struct CoreOptions
 	{
-		uint32_t	threadCount		= 4;
-		bool		GPUdebugMode	= false;
-		bool		GPUValidation	= false;
-		bool		GPUSyncQueues	= false;
+		uint32_t	threadCount			= ThreadManager::AutoThreadCount;
+		bool		pinWorkerThreads	= false;
+		bool		GPUdebugMode		= false;
+		bool		GPUValidation		= false;
+		bool		GPUSyncQueues		= false;
 	};
 
 	class EngineCore
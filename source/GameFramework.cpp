@@ -98,6 +98,8 @@ namespace FlexKit
 
 
 	bool SetDebugRenderMode	(Console* C, ConsoleVariable* Arguments, size_t ArguementCount, void* USR);
+	bool PrintSchedulerStats(Console* C, ConsoleVariable* Arguments, size_t ArguementCount, void* USR);
+	bool ResetSchedulerStats(Console* C, ConsoleVariable* Arguments, size_t ArguementCount, void* USR);
 	void EventsWrapper		(const Event& evt, void* _ptr);
 
 
@@ -183,7 +185,7 @@ namespace FlexKit
 
 	void GameFramework::Initiate()
 	{
-		InitiateAssetTable		(core.GetBlockMemory());
+		InitiateAssetTable		(core.GetBlockMemory(), &core.Threads);
 		InitiateGeometryTable	(&core.RenderSystem, core.GetBlockMemory());
 
 		quit						= false;
@@ -208,6 +210,8 @@ namespace FlexKit
 		console.BindBoolVar("FrameLock",    &core.FrameLock);
 
 		console.AddFunction({ "SetRenderMode", &SetDebugRenderMode, this, 1, { ConsoleVariableType::CONSOLE_UINT }});
+		console.AddFunction({ "SchedulerStats",			&PrintSchedulerStats, &core.Threads, 0, {} });
+		console.AddFunction({ "ResetSchedulerStats",	&ResetSchedulerStats, &core.Threads, 0, {} });
 
 		AddLogCallback(&logMessagePipe, Verbosity_INFO);
 	}
@@ -287,15 +291,24 @@ namespace FlexKit
 		}
 
 		UpdateDispatcher dispatcher{ &core.Threads, core.GetTempMemoryMT() };
-		auto updateTask = Update(dispatcher, dT);
-		auto drawTask   = Draw(updateTask, dispatcher, core.GetTempMemoryMT(), dT);
+
+		{
+			TraceScope(BuildGraph);
+
+			auto updateTask = Update(dispatcher, dT);
+			auto drawTask   = Draw(updateTask, dispatcher, core.GetTempMemoryMT(), dT);
+		}
 
 		typedef std::chrono::seconds sec;
 		typedef std::chrono::microseconds mms;
 		typedef std::chrono::duration<float> fsec;
 
-		const fsec duration = std::chrono::duration_cast<mms>(TimeFunction([&] { dispatcher.Execute(); }));
-		stats.dispatchTime  = duration.count() * 1000;
+		{
+			TraceScope(Dispatch);
+
+			const fsec duration = std::chrono::duration_cast<mms>(TimeFunction([&] { dispatcher.Execute(); }));
+			stats.dispatchTime  = duration.count() * 1000;
+		}
 
 		PostDraw(core.GetTempMemoryMT(), dT);
 
@@ -631,4 +644,69 @@ namespace FlexKit
 	}
 
 
+	/************************************************************************************************/
+
+
+	bool PrintSchedulerStats(Console* C, ConsoleVariable* Arguments, size_t ArguementCount, void* USR)
+	{
+		auto& threads		= *(ThreadManager*)USR;
+		const auto stats	= threads.GetSchedulerStats();
+
+		auto Print = [&](const std::string& str)
+		{
+			char* line = (char*)C->allocator->malloc(str.size() + 1);
+			memcpy(line, str.c_str(), str.size() + 1);
+
+			C->PrintLine(line, C->allocator);
+		};
+
+		using fms = std::chrono::duration<double, std::milli>;
+
+		Print("Scheduler Stats:");
+
+		for (size_t I = 0; I < stats.workers.size(); ++I)
+		{
+			const auto& worker = stats.workers[I];
+
+			Print(fmt::format(
+				"{} {}: tasks {} | steals {}/{} | max depth {} | spin {:.2f}ms idle {:.2f}ms parked {:.2f}ms",
+				I ? "Worker" : "Main", I,
+				worker.tasksExecuted,
+				worker.stealsSucceeded, worker.stealsAttempted,
+				worker.maxQueueDepth,
+				fms(worker.spinTime).count(), fms(worker.idleTime).count(), fms(worker.parkedTime).count()));
+		}
+
+		static const char* priorityNames[] = { "Critical", "Normal", "Background" };
+
+		for (size_t I = 0; I < (size_t)WorkPriority::Count; ++I)
+			Print(fmt::format("{}: tasks {} | {:.2f}ms", priorityNames[I], stats.priorities.taskCount[I], fms(stats.priorities.taskTime[I]).count()));
+
+		auto PrintGraph = [&](const char* name, const ThreadManager::GraphStats& graph)
+		{
+			Print(fmt::format(
+				"{} graph: tasks {} | critical path {} tasks {:.2f}ms | execute {:.2f}ms",
+				name, graph.taskCount, graph.criticalPathLength,
+				fms(graph.criticalPathTime).count(), fms(graph.executeTime).count()));
+		};
+
+		PrintGraph("Last", stats.lastGraph);
+		PrintGraph("Slowest", stats.slowestGraph);
+
+		return true;
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool ResetSchedulerStats(Console* C, ConsoleVariable* Arguments, size_t ArguementCount, void* USR)
+	{
+		((ThreadManager*)USR)->ResetSchedulerStats();
+		C->PrintLine("Scheduler stats reset");
+
+		return true;
+	}
+
+
 }	/************************************************************************************************/
@@ -63,6 +63,8 @@ namespace FlexKit
 				[&](UpdateDispatcher::UpdateBuilder& Builder, auto& Data)
 				{
 					Builder.SetDebugString("QueueCameraUpdate");
+					Builder.Reads(TransformComponentID);
+					Builder.Writes(CameraComponentID);
 				},
 				[this](auto& Data, iAllocator& threadAllocator)
 				{
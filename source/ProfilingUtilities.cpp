@@ -10,6 +10,270 @@ namespace FlexKit
 {   /************************************************************************************************/
 
 
+	void TraceRecorder::Start(size_t maxEventsPerThread)
+	{
+		if (running)
+			return;
+
+		{
+			std::scoped_lock lock{ m };
+
+			for (auto& thread : threads)
+			{
+				thread->buffer.Drain([](auto&) {});
+				thread->captured.clear();
+			}
+
+			maxEvents   = maxEventsPerThread;
+			tscBegin    = ReadTraceTimestamp();
+			clockBegin  = std::chrono::steady_clock::now();
+		}
+
+		running     = true;
+		recording   = true;
+
+		drainThread = std::thread{
+			[&]
+			{
+				std::unique_lock lock{ m };
+
+				while (running)
+				{
+					cv.wait_for(lock, std::chrono::milliseconds(1));
+					DrainBuffers();
+				}
+
+				BlockAllocator::ReleaseThreadCaches();
+			} };
+	}
+
+
+	/************************************************************************************************/
+
+
+	void TraceRecorder::Stop()
+	{
+		recording = false;
+
+		{
+			std::scoped_lock lock{ m };
+			running = false;
+		}
+
+		cv.notify_all();
+
+		if (drainThread.joinable())
+			drainThread.join();
+
+		std::scoped_lock lock{ m };
+		DrainBuffers();
+	}
+
+
+	/************************************************************************************************/
+
+
+	void TraceRecorder::Clear()
+	{
+		std::scoped_lock lock{ m };
+
+		for (auto& thread : threads)
+		{
+			thread->buffer.Drain([](auto&) {});
+			thread->captured.clear();
+		}
+	}
+
+
+	/************************************************************************************************/
+
+
+	void TraceRecorder::SetThreadName(const char* name)
+	{
+		auto& threadTrace = GetThreadTrace();
+
+		std::scoped_lock lock{ m };
+		threadTrace.name = name;
+	}
+
+
+	/************************************************************************************************/
+
+
+	TraceRecorder::ThreadTrace* TraceRecorder::RegisterThread()
+	{
+		std::scoped_lock lock{ m };
+
+		auto threadTrace        = std::make_unique<ThreadTrace>();
+		threadTrace->threadID   = (uint32_t)threads.size();
+		threadTrace->name       = fmt::format("Thread {}", threads.size());
+
+		threads.emplace_back(std::move(threadTrace));
+
+		return threads.back().get();
+	}
+
+
+	/************************************************************************************************/
+
+
+	// Caller must hold m
+	void TraceRecorder::DrainBuffers()
+	{
+		for (auto& thread : threads)
+		{
+			auto& captured = thread->captured;
+
+			thread->buffer.Drain(
+				[&](const TraceEvent& evt)
+				{
+					captured.push_back(evt);
+				});
+
+			// Continuous recording, keep a sliding window of the most recent events
+			while (captured.size() > maxEvents)
+				captured.pop_front();
+		}
+	}
+
+
+	/************************************************************************************************/
+
+
+	// Labels are function names and thread names, escaped so templates or user names can't break the JSON
+	static void WriteJSONString(fmt::memory_buffer& out, const char* str)
+	{
+		for (; *str; str++)
+		{
+			const char c = *str;
+
+			if (c == '"' || c == '\\')
+			{
+				out.push_back('\\');
+				out.push_back(c);
+			}
+			else if ((unsigned char)c < 0x20)
+				fmt::format_to(std::back_inserter(out), "\\u{:04x}", (unsigned char)c);
+			else
+				out.push_back(c);
+		}
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool TraceRecorder::ExportChromeTrace(const char* fileName)
+	{
+		FILE* file = fopen(fileName, "wb");
+
+		if (!file)
+		{
+			FK_LOG_ERROR("Failed to open %s for trace export!", fileName);
+			return false;
+		}
+
+		std::scoped_lock lock{ m };
+		DrainBuffers();
+
+		// Calibrate timestamp frequency against the steady clock over the capture window
+		const uint64_t  tscNow      = ReadTraceTimestamp();
+		const auto      clockNow    = std::chrono::steady_clock::now();
+		const double    elapsedUS   = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(clockNow - clockBegin).count() / 1000.0;
+		const double    ticksPerUS  = elapsedUS > 0.0 ? double(tscNow - tscBegin) / elapsedUS : 1.0;
+
+		auto ToUS = [&](uint64_t timestamp) { return double(int64_t(timestamp - tscBegin)) / ticksPerUS; };
+
+		fmt::memory_buffer out;
+		fmt::format_to(std::back_inserter(out), "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+		bool first = true;
+		auto Separator = [&]
+		{
+			if (!first)
+				fmt::format_to(std::back_inserter(out), ",\n");
+
+			first = false;
+		};
+
+		uint64_t droppedEvents = 0;
+
+		for (auto& thread : threads)
+		{
+			droppedEvents += thread->buffer.GetDropCount();
+
+			if (thread->captured.empty())
+				continue;
+
+			Separator();
+			fmt::format_to(std::back_inserter(out),
+				"{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"",
+				thread->threadID);
+			WriteJSONString(out, thread->name.c_str());
+			fmt::format_to(std::back_inserter(out), "\"}}}}");
+
+			// Dropped events and the sliding window can leave scopes unbalanced, discard orphaned ends and close open begins
+			uint32_t depth          = 0;
+			uint64_t lastTimestamp  = 0;
+
+			for (const auto& evt : thread->captured)
+			{
+				lastTimestamp = evt.timestamp;
+
+				if (evt.label == nullptr)
+				{
+					if (!depth)
+						continue;
+
+					depth--;
+					Separator();
+					fmt::format_to(std::back_inserter(out),
+						"{{\"ph\":\"E\",\"pid\":1,\"tid\":{},\"ts\":{:.3f}}}",
+						thread->threadID, ToUS(evt.timestamp));
+				}
+				else if (evt.label == TraceFrameMarker)
+				{
+					Separator();
+					fmt::format_to(std::back_inserter(out),
+						"{{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":{},\"ts\":{:.3f}}}",
+						thread->threadID, ToUS(evt.timestamp));
+				}
+				else
+				{
+					depth++;
+					Separator();
+					fmt::format_to(std::back_inserter(out), "{{\"name\":\"");
+					WriteJSONString(out, evt.label);
+					fmt::format_to(std::back_inserter(out),
+						"\",\"ph\":\"B\",\"pid\":1,\"tid\":{},\"ts\":{:.3f}}}",
+						thread->threadID, ToUS(evt.timestamp));
+				}
+			}
+
+			for (; depth; depth--)
+			{
+				Separator();
+				fmt::format_to(std::back_inserter(out),
+					"{{\"ph\":\"E\",\"pid\":1,\"tid\":{},\"ts\":{:.3f}}}",
+					thread->threadID, ToUS(lastTimestamp));
+			}
+		}
+
+		fmt::format_to(std::back_inserter(out), "\n]}}\n");
+
+		const bool success = fwrite(out.data(), 1, out.size(), file) == out.size();
+		fclose(file);
+
+		if (droppedEvents)
+			FK_LOG_WARNING("Trace export: %u events were dropped, trace ring buffers overflowed.", (uint32_t)droppedEvents);
+
+		return success;
+	}
+
+
+	/************************************************************************************************/
+
+
 	void ThreadProfiler::Push(const char* func, uint64_t Id, TimePoint tp)
 	{
 		const auto parentID = activeFrames.size() ? activeFrames.back().profileID : -1;
@@ -54,6 +318,8 @@ namespace FlexKit
 	void EngineProfiling::DrawProfiler(uint2 POS, uint2 WH, iAllocator& temp)
 	{
 #if USING(ENABLEPROFILER)
+		profilerDrawn = true;
+
 		if (auto stats = profiler.GetStats(); stats)
 		{
 			if (ImGui::Begin("Profiler"))
@@ -85,6 +351,19 @@ namespace FlexKit
 
 				ImGui::SliderInt("Stack Depth", &maxDepth, 1, 15);
 
+				if (ImGui::Button(tracer.IsRecording() ? "Stop Trace" : "Record Trace"))
+				{
+					if (tracer.IsRecording())
+						tracer.Stop();
+					else
+						tracer.Start();
+				}
+
+				ImGui::SameLine();
+
+				if (ImGui::Button("Export Trace"))
+					tracer.ExportChromeTrace("trace.json");
+
 				static float beginRange    = 0.0f;
 				static float endRange      = 1.0f;
 
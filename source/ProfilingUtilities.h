@@ -29,10 +29,22 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "containers.h"
 #include "type.h"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <memory>
+#include <new>
 #include <source_location>
+#include <string>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 
 /************************************************************************************************/
@@ -44,6 +56,184 @@ namespace FlexKit
 	using TimeDuration  = std::chrono::high_resolution_clock::duration;
 
 
+	/************************************************************************************************/
+
+
+	inline uint64_t ReadTraceTimestamp() noexcept
+	{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+
+
+	// 16 byte trace record, the event type is encoded in the label:
+	//	label == nullptr			-> End of the innermost open scope
+	//	label == TraceFrameMarker	-> Frame boundary
+	//	else						-> Begin of a scope named label
+	struct TraceEvent
+	{
+		uint64_t    timestamp;
+		const char* label;
+	};
+
+	inline const char TraceFrameMarker[] = "Frame";
+
+
+	/************************************************************************************************/
+
+
+	// Single producer / single consumer ring, the owning thread pushes, the drain thread pops.
+	// Never blocks the producer, events are dropped when the consumer falls behind.
+	// Storage is allocated by the producer on its first event, threads that never trace while recording never pay for it.
+	class TraceRingBuffer
+	{
+	public:
+		static constexpr size_t Capacity    = 1 << 16;
+		static constexpr size_t Mask        = Capacity - 1;
+
+		bool Push(const TraceEvent& evt) noexcept
+		{
+			// Published to the drain thread by the head release below, it only reads events once head moves
+			if (!events) [[unlikely]]
+			{
+				events.reset(new (std::nothrow) TraceEvent[Capacity]);
+
+				if (!events)
+				{
+					dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+			}
+
+			const uint64_t h = head.load(std::memory_order_relaxed);
+
+			if (h - cachedTail >= Capacity)
+			{
+				cachedTail = tail.load(std::memory_order_acquire);
+
+				if (h - cachedTail >= Capacity)
+				{
+					dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+			}
+
+			events[h & Mask] = evt;
+			head.store(h + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		template<typename TY_FN>
+		size_t Drain(TY_FN&& fn)
+		{
+			const uint64_t t = tail.load(std::memory_order_relaxed);
+			const uint64_t h = head.load(std::memory_order_acquire);
+
+			for (uint64_t I = t; I < h; I++)
+				fn(events[I & Mask]);
+
+			tail.store(h, std::memory_order_release);
+
+			return h - t;
+		}
+
+		uint64_t GetDropCount() const noexcept { return dropped.load(std::memory_order_relaxed); }
+		bool     IsAllocated()  const noexcept { return events != nullptr; }
+
+	private:
+		alignas(64) std::atomic_uint64_t    head        = 0;
+		uint64_t                            cachedTail  = 0;
+		alignas(64) std::atomic_uint64_t    tail        = 0;
+		std::atomic_uint64_t                dropped     = 0;
+
+		std::unique_ptr<TraceEvent[]>       events;
+	};
+
+
+	/************************************************************************************************/
+
+
+	class TraceRecorder
+	{
+	public:
+		TraceRecorder() = default;
+		~TraceRecorder() { Stop(); }
+
+		TraceRecorder(const TraceRecorder&)               = delete;
+		TraceRecorder& operator = (const TraceRecorder&)  = delete;
+
+		void Start(size_t maxEventsPerThread = 1024 * 1024);
+		void Stop();
+		void Clear();
+
+		bool IsRecording() const noexcept { return recording.load(std::memory_order_relaxed); }
+
+		// Writes the currently captured window in the Chrome trace event format, loadable by chrome://tracing and Perfetto
+		bool ExportChromeTrace(const char* fileName);
+
+		void SetThreadName(const char* name);
+
+		void Begin(const char* label) noexcept
+		{
+			if (recording.load(std::memory_order_relaxed))
+				GetThreadTrace().buffer.Push({ ReadTraceTimestamp(), label });
+		}
+
+		void End() noexcept
+		{
+			if (recording.load(std::memory_order_relaxed))
+				GetThreadTrace().buffer.Push({ ReadTraceTimestamp(), nullptr });
+		}
+
+		void MarkFrame() noexcept
+		{
+			if (recording.load(std::memory_order_relaxed))
+				GetThreadTrace().buffer.Push({ ReadTraceTimestamp(), TraceFrameMarker });
+		}
+
+	private:
+
+		struct ThreadTrace
+		{
+			TraceRingBuffer         buffer;
+			std::deque<TraceEvent>  captured;
+			std::string             name;
+			uint32_t                threadID;
+		};
+
+		ThreadTrace& GetThreadTrace()
+		{
+			thread_local ThreadTrace* threadTrace = nullptr;
+
+			if (!threadTrace)
+				threadTrace = RegisterThread();
+
+			return *threadTrace;
+		}
+
+		ThreadTrace*    RegisterThread();
+		void            DrainBuffers();
+
+		std::mutex                                  m;
+		std::condition_variable                     cv;
+		std::thread                                 drainThread;
+		std::atomic_bool                            recording   = false;
+		std::atomic_bool                            running     = false;
+
+		size_t                                      maxEvents   = 0;
+		uint64_t                                    tscBegin    = 0;
+		std::chrono::steady_clock::time_point       clockBegin;
+
+		std::vector<std::unique_ptr<ThreadTrace>>   threads;
+	};
+
+	inline TraceRecorder tracer{};
+
+
 	struct FrameTiming
 	{
 		const char* Function;
@@ -213,11 +403,24 @@ namespace FlexKit
 
 			if (!paused)
 				stats.push_back(std::move(frameStats));
+
+			// Per frame profiling is only collected while the profiler window is drawn, the trace rings are the only sink otherwise
+			frameProfiling.store(profilerDrawn, std::memory_order_relaxed);
+			profilerDrawn = false;
+
+			tracer.MarkFrame();
 #endif
 		}
 
+		bool IsFrameProfiling() const noexcept
+		{
+			return frameProfiling.load(std::memory_order_relaxed);
+		}
+
 		void Release()
 		{
+			tracer.Stop();
+
 			for (auto& threadProfiler : threadProfilers)
 				threadProfiler->Release();
 
@@ -238,6 +441,9 @@ namespace FlexKit
 		bool showLabels = true;
 		size_t frameOffset = 0;
 
+		bool                profilerDrawn   = false;
+		std::atomic_bool    frameProfiling  = false;
+
 		std::shared_ptr<ProfilingStats>                     pausedFrame;
 		CircularBuffer<std::shared_ptr<ProfilingStats>>     stats;
 		std::vector<std::unique_ptr<ThreadProfiler>>        threadProfilers;
@@ -266,23 +472,39 @@ namespace FlexKit
 	{
 	public:
 		_ProfileFunction(const char* FunctionName, uint64_t IN_profileID) :
-			function	{ FunctionName },
-			profileID	{ IN_profileID + rand() }
+			function		{ FunctionName },
+			frameProfiled	{ profiler.IsFrameProfiling() },
+			profileID		{ frameProfiled ? IN_profileID + rand() : 0 }
 		{
-			profiler.GetThreadProfiler().Push(FunctionName, profileID, std::chrono::high_resolution_clock::now());
+			tracer.Begin(FunctionName);
+
+			if (frameProfiled)
+				profiler.GetThreadProfiler().Push(FunctionName, profileID, std::chrono::high_resolution_clock::now());
 		}
 
 		~_ProfileFunction()
 		{
-			profiler.GetThreadProfiler().Pop(profileID, std::chrono::high_resolution_clock::now());
+			if (frameProfiled)
+				profiler.GetThreadProfiler().Pop(profileID, std::chrono::high_resolution_clock::now());
+
+			tracer.End();
 		}
 
 	private:
-		std::chrono::high_resolution_clock::time_point before = std::chrono::high_resolution_clock::now();
 		const char*     function = "Unnamed function";
+		const bool      frameProfiled;
 		const uint64_t  profileID;
 	};
 
+
+	// Trace only scope, skips the per frame profiler. Intended for hot paths.
+	class _TraceScope
+	{
+	public:
+		_TraceScope(const char* label) noexcept	{ tracer.Begin(label); }
+		~_TraceScope() noexcept					{ tracer.End(); }
+	};
+
 #define PROFILELABEL_(a) MERGECOUNT_(PROFILE_ID_, a)
 #define PROFILELABEL PROFILELABEL_(__LINE__)
 
@@ -294,9 +516,11 @@ namespace FlexKit
 #if USING(ENABLEPROFILER)
 #define ProfileFunction() const auto PROFILELABEL_ = _ProfileFunction(__FUNCTION__, GETLINEHASH(STRINGIFY(__LINE__) __FUNCTION__ ))
 #define ProfileFunctionLabeled(LABEL)  const auto PROFILELABEL_##LABEL = _ProfileFunction(__FUNCTION__":"#LABEL, GETLINEHASH(STRINGIFY(__LINE__) __FUNCTION__ ))
+#define TraceScope(LABEL) const FlexKit::_TraceScope TRACESCOPE_##LABEL{ __FUNCTION__":"#LABEL }
 #else
 #define ProfileFunction()
 #define ProfileFunctionLabeled(LABEL)
+#define TraceScope(LABEL)
 #endif
 #define TIMEBLOCK(A, B) _TimeBlock([&]{ return A(); }, B)
 
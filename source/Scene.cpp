@@ -743,6 +743,7 @@ namespace FlexKit
 	{
 		auto& view = go.AddView<SceneVisibilityView>(node, sceneID);
 		sceneEntities.push_back(view);
+		bvhDirty = true;
 
 		Trigger(go, AddedToSceneID);
 	}
@@ -751,6 +752,7 @@ namespace FlexKit
 	{
 		auto& view = go.AddView<SceneVisibilityView>(GetSceneNode(go), sceneID);
 		sceneEntities.push_back(view);
+		bvhDirty = true;
 
 		Trigger(go, AddedToSceneID);
 	}
@@ -770,6 +772,8 @@ namespace FlexKit
 
 			sceneEntities.remove_unstable(
 				find(sceneEntities, [&](auto i) { return i == handle; }));
+
+			bvhDirty = true;
 		},	[] { });
 	}
 
@@ -802,7 +806,8 @@ namespace FlexKit
 
 		ownedGameObjects.clear();
 
-		bvh = SceneBVH(*allocator);
+		bvh			= SceneBVH(*allocator);
+		bvhDirty	= true;
 	}
 
 
@@ -892,6 +897,31 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	static uint CreateBVHMortonCode(const float3 POS, const float3 offset, const float3 worldSpan)
+	{
+		const auto normalizePOS = (offset + POS) / worldSpan;
+
+		return CreateMortonCode({
+					(uint)(normalizePOS.x * ComponentMask),
+					(uint)(normalizePOS.y * ComponentMask),
+					(uint)(normalizePOS.z * ComponentMask)});
+	}
+
+
+	/************************************************************************************************/
+
+
+	static float BVHNodeCost(const AABB& aabb)
+	{
+		const float3 span = aabb.Span();
+
+		return 2.0f * (span.x * span.y + span.y * span.z + span.z * span.x);
+	}
+
+
+	/************************************************************************************************/
+
+
 	SceneBVH SceneBVH::Build(const Scene& scene, iAllocator& allocator)
 	{
 		ProfileFunction();
@@ -899,8 +929,9 @@ namespace FlexKit
 		auto& visables              = scene.sceneEntities;
 		auto& visibilityComponent   = SceneVisibilityComponent::GetComponent();
 
-		auto elements   = Vector<BVHElement>{ &allocator, visables.size() };
-		auto nodes      = Vector<BVHNode>{ &allocator, visables.size() * 2 };
+		auto elements       = Vector<BVHElement>{ &allocator, visables.size() };
+		auto nodes          = Vector<BVHNode>{ &allocator, visables.size() * 2 };
+		auto packedBounds   = Vector<PackedBounds>{ &allocator, visables.size() * 2 };
 
 		AABB worldAABB;
 
@@ -912,12 +943,7 @@ namespace FlexKit
 
 		for (auto& visable : visables)
 		{
-			const auto POS          = GetPositionW(visibilityComponent[visable].node);
-			const auto normalizePOS = (offset + POS) / worldSpan;
-			const auto ID           = CreateMortonCode({
-										(uint)(normalizePOS.x * ComponentMask),
-										(uint)(normalizePOS.y * ComponentMask),
-										(uint)(normalizePOS.z * ComponentMask)});
+			const auto ID = CreateBVHMortonCode(GetPositionW(visibilityComponent[visable].node), offset, worldSpan);
 
 			elements.push_back({ ID, visable });
 		}
@@ -928,18 +954,20 @@ namespace FlexKit
 		const size_t end            = (size_t)std::ceil(elements.size() / 4.0f);
 		const size_t elementCount   = elements.size();
 
-		for (uint16_t I = 0; I < end; ++I)
+		for (uint32_t I = 0; I < end; ++I)
 		{
-			BVHNode node;
+			BVHNode         node;
+			PackedBounds    bounds;
 
-			const uint16_t begin  = 4 * I;
-			const uint16_t end    = (uint16_t)Min(elementCount, 4 * I + 4);
+			const uint32_t begin  = 4 * I;
+			const uint32_t end    = (uint32_t)Min(elementCount, 4 * I + 4);
 
-			for (uint16_t II = 4 * I; II < end; II++) {
-				const uint16_t idx  = II;
+			for (uint32_t II = 4 * I; II < end; II++) {
+				const uint32_t idx  = II;
 				auto& visable       = elements[idx].handle;
 				const auto aabb     = visibilityComponent[visable].GetAABB();
 				node.boundingVolume += aabb;
+				bounds.Set(II - begin, aabb);
 			}
 
 			node.children   = 4 * I;
@@ -947,6 +975,7 @@ namespace FlexKit
 			node.Leaf       = true;
 
 			nodes.push_back(node);
+			packedBounds.push_back(bounds);
 		}
 
 		// Phase 2 - Build Interior Nodes -
@@ -960,17 +989,25 @@ namespace FlexKit
 			{
 				for (uint I = begin; I < end; I += 4)
 				{
-					BVHNode node;
+					BVHNode         node;
+					PackedBounds    bounds;
 
 					const size_t localEnd = Min(end, I + 4);
 					for (size_t II = I; II < localEnd; II++)
+					{
 						node.boundingVolume += nodes[II].boundingVolume;
+						bounds.Set(uint32_t(II - I), nodes[II].boundingVolume);
+					}
 
 					node.children   = I;
 					node.count      = uint8_t(localEnd - I);
 					node.Leaf       = false;
 
+					for (size_t II = I; II < localEnd; II++)
+						nodes[II].parent = (uint32_t)nodes.size();
+
 					nodes.push_back(node);
+					packedBounds.push_back(bounds);
 				}
 			}
 			else
@@ -979,10 +1016,433 @@ namespace FlexKit
 			begin = temp;
 		}
 
+		float cost = 0.0f;
+		for (auto& node : nodes)
+			cost += BVHNodeCost(node.boundingVolume);
+
+		SceneBVH BVH{ allocator };
+		BVH.elements        = elements.Copy(allocator);
+		BVH.nodes           = nodes.Copy(allocator);
+		BVH.packedBounds    = packedBounds.Copy(allocator);
+		BVH.root            = begin;
+		BVH.buildCost   = cost;
+		BVH.cost        = cost;
+		BVH.MapNodesToLeaves(allocator);
+
+		return BVH;
+	}
+
+
+	/************************************************************************************************/
+
+
+	SceneBVH SceneBVH::Build(const Scene& scene, ThreadManager& threads, iAllocator& allocator)
+	{
+		const auto& visables		= scene.sceneEntities;
+		const uint32_t elementCount	= (uint32_t)visables.size();
+
+		if (elementCount < ParallelBuildThreshold)
+			return Build(scene, allocator);
+
+		ProfileFunction();
+
+		auto& visibilityComponent = SceneVisibilityComponent::GetComponent();
+
+		const size_t threadCount	= Max(threads.GetThreadCount(), 1);
+		const size_t blockSize		= Max(elementCount / (threadCount * 4), ParallelBuildThreshold / 4);
+		const size_t blockCount		= (elementCount + blockSize - 1) / blockSize;
+
+		// Parallel_For2 splits a range into blockSize chunks and hands each its chunk index,
+		// every pass below that uses blockSize over elementCount items sees the same partitioning.
+		const VisibilityHandle* visablesBegin	= visables.begin();
+		const VisibilityHandle* visablesEnd		= visables.end();
+
+		// Phase 1 - World Bounds -
+		Vector<AABB> blockAABBs{ &allocator, blockCount, AABB{} };
+
+		Parallel_For2(
+			threads, allocator,
+			visablesBegin, visablesEnd,
+			blockSize,
+			[&](const VisibilityHandle* begin, const VisibilityHandle* end, size_t dispatchID, iAllocator&)
+			{
+				AABB aabb;
+				for (auto itr = begin; itr < end; ++itr)
+					aabb += visibilityComponent[*itr].GetAABB();
+
+				blockAABBs[dispatchID] = aabb;
+			});
+
+		AABB worldAABB;
+		for (auto& aabb : blockAABBs)
+			worldAABB += aabb;
+
+		const float3 worldSpan  = worldAABB.Span();
+		const float3 offset     = -worldAABB.Min;
+
+		// Phase 2 - Morton Codes -
+		Vector<BVHElement> elements	{ &allocator, elementCount, BVHElement{} };
+		Vector<BVHElement> scratch	{ &allocator, elementCount, BVHElement{} };
+
+		Parallel_For2(
+			threads, allocator,
+			visablesBegin, visablesEnd,
+			blockSize,
+			[&](const VisibilityHandle* begin, const VisibilityHandle* end, size_t, iAllocator&)
+			{
+				for (auto itr = begin; itr < end; ++itr)
+				{
+					const auto ID = CreateBVHMortonCode(GetPositionW(visibilityComponent[*itr].node), offset, worldSpan);
+
+					elements[itr - visablesBegin] = { ID, *itr };
+				}
+			});
+
+		// Phase 3 - LSD Radix Sort, 8 bits per pass -
+		Vector<uint32_t> histograms{ &allocator, blockCount * 256, 0u };
+
+		BVHElement* src = elements.data();
+		BVHElement* dst = scratch.data();
+
+		for (uint32_t shift = 0; shift < 32; shift += 8)
+		{
+			Parallel_For2(
+				threads, allocator,
+				src, src + elementCount,
+				blockSize,
+				[&](BVHElement* begin, BVHElement* end, size_t dispatchID, iAllocator&)
+				{
+					uint32_t* histogram = histograms.data() + 256 * dispatchID;
+					memset(histogram, 0, sizeof(uint32_t) * 256);
+
+					for (auto itr = begin; itr < end; ++itr)
+						histogram[(itr->ID >> shift) & 0xff]++;
+				});
+
+			// Digit major exclusive scan, each block scatters behind the earlier blocks' keys of the same digit
+			bool		skipPass	= false;
+			uint32_t	scanOffset	= 0;
+
+			for (uint32_t digit = 0; digit < 256; ++digit)
+			{
+				const uint32_t digitBegin = scanOffset;
+
+				for (size_t block = 0; block < blockCount; ++block)
+				{
+					const uint32_t count = histograms[block * 256 + digit];
+					histograms[block * 256 + digit] = scanOffset;
+					scanOffset += count;
+				}
+
+				if (scanOffset - digitBegin == elementCount)
+					skipPass = true;
+			}
+
+			if (skipPass) // Every key shares this digit, order is unchanged
+				continue;
+
+			Parallel_For2(
+				threads, allocator,
+				src, src + elementCount,
+				blockSize,
+				[&](BVHElement* begin, BVHElement* end, size_t dispatchID, iAllocator&)
+				{
+					uint32_t* histogram = histograms.data() + 256 * dispatchID;
+
+					for (auto itr = begin; itr < end; ++itr)
+						dst[histogram[(itr->ID >> shift) & 0xff]++] = *itr;
+				});
+
+			std::swap(src, dst);
+		}
+
+		const BVHElement* sorted = src;
+
+		// Phase 4 - Build Leaf Nodes -
+		const uint32_t leafCount = (elementCount + 3) / 4;
+
+		Vector<uint32_t> levelBegin{ &allocator, 16 };
+		levelBegin.push_back(0);
+
+		for (uint32_t levelSize = leafCount, nodeCount = 0;; levelSize = (levelSize + 3) / 4)
+		{
+			nodeCount += levelSize;
+			levelBegin.push_back(nodeCount);
+
+			if (levelSize == 1)
+				break;
+		}
+
+		Vector<BVHNode>			nodes			{ &allocator, levelBegin.back(), BVHNode{} };
+		Vector<PackedBounds>	packedBounds	{ &allocator, levelBegin.back(), PackedBounds{} };
+		BVHNode* nodesBegin = nodes.data();
+
+		Parallel_For2(
+			threads, allocator,
+			nodesBegin, nodesBegin + leafCount,
+			Max(leafCount / (threadCount * 4), 256),
+			[&](BVHNode* begin, BVHNode* end, size_t, iAllocator&)
+			{
+				for (auto node = begin; node < end; ++node)
+				{
+					const uint32_t I		= uint32_t(node - nodesBegin);
+					const uint32_t localEnd	= Min(elementCount, 4 * I + 4);
+
+					for (uint32_t II = 4 * I; II < localEnd; ++II)
+					{
+						const AABB aabb = visibilityComponent[sorted[II].handle].GetAABB();
+
+						node->boundingVolume += aabb;
+						packedBounds[I].Set(II - 4 * I, aabb);
+					}
+
+					node->children	= 4 * I;
+					node->count		= uint8_t(localEnd - 4 * I);
+					node->Leaf		= true;
+				}
+			});
+
+		// Phase 5 - Build Interior Nodes, one level at a time -
+		for (size_t level = 1; level + 1 < levelBegin.size(); ++level)
+		{
+			const uint32_t childBegin	= levelBegin[level - 1];
+			const uint32_t childEnd		= levelBegin[level];
+			const uint32_t begin		= levelBegin[level];
+			const uint32_t end			= levelBegin[level + 1];
+
+			Parallel_For2(
+				threads, allocator,
+				nodesBegin + begin, nodesBegin + end,
+				Max((end - begin) / (threadCount * 4), 256),
+				[&](BVHNode* rangeBegin, BVHNode* rangeEnd, size_t, iAllocator&)
+				{
+					for (auto node = rangeBegin; node < rangeEnd; ++node)
+					{
+						const uint32_t nodeIdx	= uint32_t(node - nodesBegin);
+						const uint32_t children	= childBegin + 4 * (nodeIdx - begin);
+						const uint32_t localEnd	= Min(childEnd, children + 4);
+
+						for (uint32_t II = children; II < localEnd; ++II)
+						{
+							node->boundingVolume += nodes[II].boundingVolume;
+							nodes[II].parent = nodeIdx;
+							packedBounds[nodeIdx].Set(II - children, nodes[II].boundingVolume);
+						}
+
+						node->children	= children;
+						node->count		= uint8_t(localEnd - children);
+						node->Leaf		= false;
+					}
+				});
+		}
+
+		float cost = 0.0f;
+		for (auto& node : nodes)
+			cost += BVHNodeCost(node.boundingVolume);
+
+		SceneBVH BVH{ allocator };
+		BVH.elements        = (sorted == elements.data() ? elements : scratch).Copy(allocator);
+		BVH.nodes           = nodes.Copy(allocator);
+		BVH.packedBounds    = packedBounds.Copy(allocator);
+		BVH.root            = levelBegin.back() - 1;
+		BVH.buildCost   = cost;
+		BVH.cost        = cost;
+		BVH.MapNodesToLeaves(allocator);
+
+		return BVH;
+	}
+
+
+	/************************************************************************************************/
+
+
+	SceneBVH SceneBVH::BuildSAH(const Scene& scene, iAllocator& allocator)
+	{
+		ProfileFunction();
+
+		auto& visables              = scene.sceneEntities;
+		auto& visibilityComponent   = SceneVisibilityComponent::GetComponent();
+
+		const uint32_t elementCount = (uint32_t)visables.size();
+
+		if (!elementCount)
+			return SceneBVH{ allocator };
+
+		struct Primitive
+		{
+			AABB				aabb;
+			float3				centroid;
+			VisibilityHandle	handle;
+		};
+
+		Vector<Primitive> primitives{ &allocator, elementCount };
+
+		for (auto& visable : visables)
+		{
+			const AABB aabb = visibilityComponent[visable].GetAABB();
+			primitives.push_back({ aabb, aabb.MidPoint(), visable });
+		}
+
+		struct BuildTask
+		{
+			uint32_t node;
+			uint32_t begin;
+			uint32_t end;
+		};
+
+		Vector<BuildTask>	tasks{ &allocator, 64 };
+		Vector<BVHNode>		nodes{ &allocator, 2 * ((elementCount + SAHMaxLeafSize - 1) / SAHMaxLeafSize) };
+
+		nodes.emplace_back();
+		tasks.push_back({ 0, 0, elementCount });
+
+		while (tasks.size())
+		{
+			const auto task = tasks.pop_back();
+
+			AABB bounds;
+			AABB centroidBounds;
+
+			for (uint32_t I = task.begin; I < task.end; ++I)
+			{
+				bounds			+= primitives[I].aabb;
+				centroidBounds	+= primitives[I].centroid;
+			}
+
+			nodes[task.node].boundingVolume = bounds;
+
+			const uint32_t count = task.end - task.begin;
+
+			if (count <= SAHMaxLeafSize)
+			{
+				nodes[task.node].children	= task.begin;
+				nodes[task.node].count		= uint8_t(count);
+				nodes[task.node].Leaf		= true;
+
+				continue;
+			}
+
+			// Bin centroids along each axis and sweep the bin boundaries for the lowest surface area cost
+			const float3 centroidSpan = centroidBounds.Span();
+
+			int			bestAxis	= -1;
+			uint32_t	bestBin		= 0;
+			float		bestCost	= std::numeric_limits<float>::max();
+
+			auto GetBin =
+				[&](const Primitive& primitive, const int axis)
+				{
+					const float scale = SAHBinCount / centroidSpan[axis];
+					return Min(uint32_t((primitive.centroid[axis] - centroidBounds.Min[axis]) * scale), SAHBinCount - 1);
+				};
+
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (centroidSpan[axis] <= 0.0f)
+					continue;
+
+				AABB		binBounds[SAHBinCount];
+				uint32_t	binCounts[SAHBinCount] = {};
+
+				for (uint32_t I = task.begin; I < task.end; ++I)
+				{
+					const auto bin = GetBin(primitives[I], axis);
+
+					binBounds[bin] += primitives[I].aabb;
+					binCounts[bin]++;
+				}
+
+				float		rightCosts[SAHBinCount] = {};
+				uint32_t	rightCounts[SAHBinCount] = {};
+
+				AABB		right;
+				uint32_t	rightCount = 0;
+
+				for (uint32_t bin = SAHBinCount - 1; bin > 0; --bin)
+				{
+					right		+= binBounds[bin];
+					rightCount	+= binCounts[bin];
+
+					rightCosts[bin]		= BVHNodeCost(right);
+					rightCounts[bin]	= rightCount;
+				}
+
+				AABB		left;
+				uint32_t	leftCount = 0;
+
+				for (uint32_t bin = 1; bin < SAHBinCount; ++bin)
+				{
+					left		+= binBounds[bin - 1];
+					leftCount	+= binCounts[bin - 1];
+
+					if (!leftCount || !rightCounts[bin])
+						continue;
+
+					const float cost = leftCount * BVHNodeCost(left) + rightCounts[bin] * rightCosts[bin];
+
+					if (cost < bestCost)
+					{
+						bestCost	= cost;
+						bestAxis	= axis;
+						bestBin		= bin;
+					}
+				}
+			}
+
+			uint32_t mid = task.begin + count / 2;
+
+			if (bestAxis != -1)
+			{
+				auto itr = std::partition(
+					primitives.begin() + task.begin,
+					primitives.begin() + task.end,
+					[&](const Primitive& primitive) { return GetBin(primitive, bestAxis) < bestBin; });
+
+				mid = uint32_t(itr - primitives.begin());
+			}
+			// else: every centroid coincides, split evenly
+
+			const uint32_t children = (uint32_t)nodes.size();
+
+			nodes.emplace_back();
+			nodes.emplace_back();
+
+			nodes[children + 0].parent	= task.node;
+			nodes[children + 1].parent	= task.node;
+			nodes[task.node].children	= children;
+			nodes[task.node].count		= 2;
+			nodes[task.node].Leaf		= false;
+
+			tasks.push_back({ children + 0, task.begin, mid });
+			tasks.push_back({ children + 1, mid, task.end });
+		}
+
+		Vector<BVHElement>		elements		{ &allocator, elementCount };
+		Vector<PackedBounds>	packedBounds	{ &allocator, nodes.size(), PackedBounds{} };
+
+		for (uint32_t I = 0; I < elementCount; ++I)
+			elements.push_back({ I, primitives[I].handle });
+
+		for (uint32_t I = 0; I < nodes.size(); ++I)
+		{
+			const auto& node = nodes[I];
+
+			for (uint32_t lane = 0; lane < node.count; ++lane)
+				packedBounds[I].Set(lane, node.Leaf ? primitives[node.children + lane].aabb : nodes[node.children + lane].boundingVolume);
+		}
+
+		float cost = 0.0f;
+		for (auto& node : nodes)
+			cost += BVHNodeCost(node.boundingVolume);
+
 		SceneBVH BVH{ allocator };
-		BVH.elements    = elements.Copy(allocator);
-		BVH.nodes       = nodes.Copy(allocator);
-		BVH.root        = begin;
+		BVH.elements        = elements.Copy(allocator);
+		BVH.nodes           = nodes.Copy(allocator);
+		BVH.packedBounds    = packedBounds.Copy(allocator);
+		BVH.root            = 0;
+		BVH.buildCost   = cost;
+		BVH.cost        = cost;
+		BVH.MapNodesToLeaves(allocator);
 
 		return BVH;
 	}
@@ -991,6 +1451,289 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	std::optional<SceneRayCastResult> SceneBVH::RayCastClosest(const Ray& ray, iAllocator& temporary) const
+	{
+		if (!Valid())
+			return {};
+
+		auto& visibilityComponent = SceneVisibilityComponent::GetComponent();
+
+		struct StackEntry
+		{
+			uint32_t	node;
+			float		distance;
+		};
+
+		const RayQuery query{ ray };
+
+		Vector<StackEntry, 64, uint32_t> stack{ &temporary };
+		stack.push_back({ root, 0.0f });
+
+		std::optional<SceneRayCastResult> closest;
+		float closestDistance = std::numeric_limits<float>::max();
+
+		while (stack.size())
+		{
+			const auto entry = stack.pop_back();
+
+			if (entry.distance >= closestDistance)
+				continue;
+
+			const auto& node = nodes[entry.node];
+
+			FK_ASSERT(node.count <= 4);
+
+			alignas(16) float distances[4];
+			__m128 tEntry;
+
+			const int mask = Intersects4(query, packedBounds[entry.node], closestDistance, tEntry) & ((1 << node.count) - 1);
+			_mm_store_ps(distances, tEntry);
+
+			if (node.Leaf)
+			{
+				for (uint32_t lane = 0; lane < node.count; ++lane)
+				{
+					if ((mask & (1 << lane)) && distances[lane] < closestDistance)
+					{
+						const auto handle = elements[node.children + lane].handle;
+
+						closestDistance	= distances[lane];
+						closest			= SceneRayCastResult{ handle, distances[lane], visibilityComponent[handle].entity };
+					}
+				}
+			}
+			else
+			{
+				// Push the children far to near so the nearest is popped first
+				StackEntry	hits[4];
+				uint32_t	hitCount = 0;
+
+				for (uint32_t lane = 0; lane < node.count; ++lane)
+				{
+					if (mask & (1 << lane))
+						hits[hitCount++] = { node.children + lane, distances[lane] };
+				}
+
+				std::sort(hits, hits + hitCount, [](auto& lhs, auto& rhs) { return lhs.distance > rhs.distance; });
+
+				for (uint32_t I = 0; I < hitCount; ++I)
+					stack.push_back(hits[I]);
+			}
+		}
+
+		return closest;
+	}
+
+
+	/************************************************************************************************/
+
+
+	void SceneBVH::RayCastClosest(std::span<const Ray> rays, std::span<SceneRayCastResult> results, iAllocator& temporary) const
+	{
+		ProfileFunction();
+
+		FK_ASSERT(results.size() >= rays.size());
+
+		auto& visibilityComponent = SceneVisibilityComponent::GetComponent();
+
+		Vector<RayQuery>	queries		{ &temporary, rays.size() };
+		Vector<float>		closest		{ &temporary, rays.size(), std::numeric_limits<float>::max() };
+
+		for (size_t I = 0; I < rays.size(); ++I)
+		{
+			queries.emplace_back(rays[I]);
+			results[I] = SceneRayCastResult{ InvalidHandle, std::numeric_limits<float>::max(), nullptr };
+		}
+
+		TraverseStream(
+			(uint32_t)rays.size(),
+			[&](const uint32_t rayIdx, const PackedBounds& bounds)
+			{
+				__m128 tEntry;
+				return Intersects4(queries[rayIdx], bounds, closest[rayIdx], tEntry);
+			},
+			[&](const uint32_t rayIdx, const uint32_t leafIdx)
+			{
+				const auto& leaf = nodes[leafIdx];
+
+				alignas(16) float distances[4];
+				__m128 tEntry;
+
+				const int mask = Intersects4(queries[rayIdx], packedBounds[leafIdx], closest[rayIdx], tEntry) & ((1 << leaf.count) - 1);
+				_mm_store_ps(distances, tEntry);
+
+				for (uint32_t lane = 0; lane < leaf.count; ++lane)
+				{
+					if ((mask & (1 << lane)) && distances[lane] < closest[rayIdx])
+					{
+						const auto handle = elements[leaf.children + lane].handle;
+
+						closest[rayIdx] = distances[lane];
+						results[rayIdx] = SceneRayCastResult{ handle, distances[lane], visibilityComponent[handle].entity };
+					}
+				}
+			},
+			temporary);
+	}
+
+
+	/************************************************************************************************/
+
+
+	void SceneBVH::MapNodesToLeaves(iAllocator& allocator)
+	{
+		auto& visibilityComponent = SceneVisibilityComponent::GetComponent();
+
+		nodeLeaves = Vector<NodeLeaf>{ &allocator, elements.size() };
+
+		for (uint32_t I = 0; I < nodes.size(); ++I)
+		{
+			const auto& leaf = nodes[I];
+
+			if (!leaf.Leaf)
+				continue;
+
+			const auto end = leaf.children + leaf.count;
+
+			for (auto childIdx = leaf.children; childIdx < end; ++childIdx)
+				nodeLeaves.push_back({ visibilityComponent[elements[childIdx].handle].node.to_uint(), I });
+		}
+
+		std::sort(nodeLeaves.begin(), nodeLeaves.end());
+
+		// A build reflects every move so far, refits continue from here
+		ConsumeMovedWatched();
+	}
+
+
+	/************************************************************************************************/
+
+
+	void SceneBVH::ConsumeMovedWatched()
+	{
+		movedGeneration	= SceneNodeTable.movedGeneration;
+		movedConsumed	= SceneNodeTable.movedWatched.size();
+
+		SceneNodeTable.movedConsumed.store(true, std::memory_order_relaxed);
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool SceneBVH::Refit(const Scene& scene, iAllocator& temporary)
+	{
+		ProfileFunction();
+
+		if (!Valid() || elements.size() != scene.sceneEntities.size() || refitCount >= MaxRefitCount)
+			return false;
+
+		// movedWatched accumulates until consumed, but another scene may have consumed it and a later transform
+		// update cleared entries this hierarchy never saw. Only continue if nothing was dropped in between.
+		const auto& table		= SceneNodeTable;
+		const bool	current		= movedGeneration == table.movedGeneration;
+		const bool	caughtUp	= movedGeneration + 1 == table.movedGeneration && movedConsumed == table.movedPreviousSize;
+
+		if (!current && !caughtUp)
+			return false;
+
+		const size_t movedBegin = current ? Min(movedConsumed, table.movedWatched.size()) : 0;
+		ConsumeMovedWatched();
+
+		auto& visibilityComponent = SceneVisibilityComponent::GetComponent();
+
+		enum RefitState : uint8_t
+		{
+			Clean,
+			Queued,
+			Expanded,
+		};
+
+		// Kept between refits and reset through the queued list, so nothing here is proportional to the scene size
+		if (refitState.size() != nodes.size())
+			refitState = Vector<uint8_t>{ allocator, nodes.size(), uint8_t(Clean) };
+
+		Vector<uint32_t> queued{ &temporary, 64 };
+
+		// Scene nodes holding visibility are watched, the transform update reports the ones that moved.
+		// Bounds changes dirty the node too, so both arrive here. Every leaf with a moved element is queued
+		// along with its path to the root, stopping at the first already queued ancestor.
+		for (size_t I = movedBegin; I < table.movedWatched.size(); ++I)
+		{
+			const auto movedNode = table.movedWatched[I];
+			const auto range = std::equal_range(nodeLeaves.begin(), nodeLeaves.end(), NodeLeaf{ movedNode.to_uint(), 0 });
+
+			for (auto itr = range.first; itr != range.second; ++itr)
+			{
+				for (auto nodeIdx = itr->leaf; nodeIdx != InvalidParent && refitState[nodeIdx] == Clean; nodeIdx = nodes[nodeIdx].parent)
+				{
+					refitState[nodeIdx] = Queued;
+					queued.push_back(nodeIdx);
+				}
+			}
+		}
+
+		// Nothing moved, the hierarchy is unchanged and does not count towards MaxRefitCount
+		if (queued.empty())
+			return true;
+
+		// Post-order walk over the queued nodes only, so children are always refit before their parents.
+		// Independent of node layout, Morton and SAH builds order their nodes differently.
+		Vector<uint32_t> stack{ &temporary, 64 };
+
+		if (refitState[root] == Queued)
+			stack.push_back(root);
+
+		while (stack.size())
+		{
+			const uint32_t	nodeIdx	= stack.back();
+			auto&			node	= nodes[nodeIdx];
+			const auto		end		= node.children + node.count;
+
+			if (!node.Leaf && refitState[nodeIdx] == Queued)
+			{
+				refitState[nodeIdx] = Expanded;
+
+				for (auto childIdx = node.children; childIdx < end; ++childIdx)
+				{
+					if (refitState[childIdx] == Queued)
+						stack.push_back(childIdx);
+				}
+
+				continue;
+			}
+
+			stack.pop_back();
+
+			AABB	boundingVolume;
+			auto&	bounds = packedBounds[nodeIdx];
+
+			for (auto childIdx = node.children; childIdx < end; ++childIdx)
+			{
+				const AABB aabb = node.Leaf ?
+									visibilityComponent[elements[childIdx].handle].GetAABB() :
+									nodes[childIdx].boundingVolume;
+
+				boundingVolume += aabb;
+				bounds.Set(childIdx - node.children, aabb);
+			}
+
+			cost += BVHNodeCost(boundingVolume) - BVHNodeCost(node.boundingVolume);
+			node.boundingVolume = boundingVolume;
+		}
+
+		for (const auto nodeIdx : queued)
+			refitState[nodeIdx] = Clean;
+
+		refitCount++;
+
+		return cost <= buildCost * MaxRefitCostRatio;
+	}
+
+
+	/************************************************************************************************/
+
+
 	ComputeLod_RES ComputeLOD(const Brush& brush, const float3 CameraPosition, const float maxZ)
 	{
 		auto brushPosition		= GetPositionW(brush.Node);
@@ -1126,46 +1869,60 @@ namespace FlexKit
 				data.camera			= C;
 
 				builder.SetDebugString("Gather Scene");
+				builder.Reads(SceneVisibilityComponentID);
+				builder.Reads(BrushComponentID);
+				builder.Reads(TransformComponentID);
+				builder.Reads(CameraComponentID);
 			},
-			[&allocator, &threads = *dispatcher.threads](GetPVSTaskData& data, iAllocator& threadAllocator)
+			[&allocator, &threads = *dispatcher.threads](GetPVSTaskData& data, iAllocator& threadAllocator) -> WorkCoroutine
 			{
-				ProfileFunction();
+				// Everything here outlives the co_await below, so nothing comes from the thread allocator
+				PVS				pvs{ &allocator };
+				Vector<PassPVS>	passes{ &allocator };
 
-				PVS pvs{ &threadAllocator };
-
-				auto activePasses = MaterialComponent::GetComponent().GetActivePasses(threadAllocator);
+				{
+					ProfileFunction();
 
-				GatherScene(data.scene, data.camera, pvs);
-				SortPVS(&pvs, &CameraComponent::GetComponent().GetCamera(data.camera));
+					auto activePasses = MaterialComponent::GetComponent().GetActivePasses(allocator);
 
-				for (auto&& [submissionId, PV] : zip(iota(0), pvs))
-					PV.submissionID = submissionId;
+					GatherScene(data.scene, data.camera, pvs);
+					SortPVS(&pvs, &CameraComponent::GetComponent().GetCamera(data.camera));
 
-				Vector<PassPVS> passes{ &allocator };
+					for (auto&& [submissionId, PV] : zip(iota(0), pvs))
+						PV.submissionID = submissionId;
 
-				for (auto& pass : activePasses)
-					passes.emplace_back(pass, &allocator);
+					for (auto& pass : activePasses)
+						passes.emplace_back(pass, &allocator);
+				}
 
-				Parallel_For(
-					threads, threadAllocator,
-					passes.begin(), passes.end(), 2,
-					[&](PassPVS& pass, iAllocator& threadAllocator)
+				auto FilterPasses =
+					[&](auto begin, auto end, size_t, iAllocator&)
 					{
-						const auto passID = pass.pass;
 						auto& materials = MaterialComponent::GetComponent();
 
-						pass.pvs.reserve(128);
-
-						for (auto& visable: pvs)
+						for (auto& pass : std::ranges::subrange(begin, end))
 						{
-							const auto passes = materials.GetPasses(visable.brush->material);
+							const auto passID = pass.pass;
+
+							pass.pvs.reserve(128);
 
-							if (std::find(passes.begin(), passes.end(), passID) != passes.end())
-								pass.pvs.push_back(visable);
+							for (auto& visable : pvs)
+							{
+								const auto passes = materials.GetPasses(visable.brush->material);
+
+								if (std::find(passes.begin(), passes.end(), passID) != passes.end())
+									pass.pvs.push_back(visable);
+							}
 						}
-					});
+					};
+
+				// The worker is free to run other update tasks while the passes are filtered
+				WorkBarrier barrier{ threads, &allocator };
+				Parallel_For2_Async(threads, allocator, passes.begin(), passes.end(), 1, FilterPasses, barrier);
 
-				data.solid  = pvs.Copy(allocator);
+				co_await barrier;
+
+				data.solid  = std::move(pvs);
 				data.passes = std::move(passes);
 			});
 
@@ -1471,14 +2228,26 @@ namespace FlexKit
 			[&](UpdateDispatcher::UpdateBuilder& builder, SceneBVHBuild& data)
 			{
 				builder.SetDebugString("BVH");
+				builder.Reads(SceneVisibilityComponentID);
+				builder.Reads(TransformComponentID);
 				builder.AddInput(transformDependency);
 			},
-			[this, allocator = allocator](SceneBVHBuild& data, iAllocator& threadAllocator)
+			[this, allocator = allocator, threads = dispatcher.threads](SceneBVHBuild& data, iAllocator& threadAllocator)
 			{
 				FK_LOG_9("Build BVH");
 				ProfileFunction();
 
-				bvh			= bvh.Build(*this, threadAllocator).Copy(*allocator);
+				if (bvhDirty || !bvh.Refit(*this, threadAllocator))
+				{
+					auto newBVH =
+						bvhBuildMode == SceneBVH::BuildMode::SAH					? SceneBVH::BuildSAH(*this, threadAllocator) :
+						bvhBuildMode == SceneBVH::BuildMode::Parallel && threads	? SceneBVH::Build(*this, *threads, threadAllocator) :
+																					  SceneBVH::Build(*this, threadAllocator);
+
+					bvh			= newBVH.Copy(*allocator);
+					bvhDirty	= false;
+				}
+
 				data.bvh	= &bvh;
 			}
 		);
@@ -1497,6 +2266,8 @@ namespace FlexKit
 				data.scene	= this;
 
 				builder.SetDebugString("Point Light Gather");
+				builder.Reads(SceneVisibilityComponentID);
+				builder.Reads(LightComponentID);
 			},
 			[this](LightGather& data, iAllocator& threadAllocator)
 			{
@@ -1532,6 +2303,9 @@ namespace FlexKit
 			[&](UpdateDispatcher::UpdateBuilder& builder, VisibleLightGather& data)
 			{
 				builder.SetDebugString("Point Light Shadow Gather");
+				builder.Reads(SceneVisibilityComponentID);
+				builder.Reads(LightComponentID);
+				builder.Reads(CameraComponentID);
 				builder.AddInput(bvh);
 
 				data.lights = Vector<LightHandle>{ temporaryMemory };
@@ -1705,6 +2479,9 @@ namespace FlexKit
 			[&](UpdateDispatcher::UpdateBuilder& builder, LightUpdate_DATA& data)
 			{
 				builder.SetDebugString("Point Light Shadow Gather");
+				builder.Reads(SceneVisibilityComponentID);
+				builder.Reads(TransformComponentID);
+				builder.Writes(LightComponentID);
 				builder.AddInput(bvh);
 				builder.AddInput(visablePointLights);
 
@@ -1756,7 +2533,7 @@ namespace FlexKit
 		Vector<SceneRayCastResult> results{ &allocator };
 
 		if (!bvh.Valid())
-			const_cast<SceneBVH&>(bvh) = bvh.Build(*this, allocator);
+			const_cast<SceneBVH&>(bvh) = bvhBuildMode == SceneBVH::BuildMode::SAH ? bvh.BuildSAH(*this, allocator) : bvh.Build(*this, allocator);
 
 		bvh.Traverse(v,
 			[&](auto& visable, const auto& intersectionResult, [[maybe_unused]] GameObject* gameObject)
@@ -1778,6 +2555,27 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	std::optional<SceneRayCastResult> Scene::RayCastClosest(FlexKit::Ray v, iAllocator& allocator) const
+	{
+		if (!bvh.Valid())
+			const_cast<SceneBVH&>(bvh) = bvhBuildMode == SceneBVH::BuildMode::SAH ? bvh.BuildSAH(*this, allocator) : bvh.Build(*this, allocator);
+
+		return bvh.RayCastClosest(v, allocator);
+	}
+
+
+	void Scene::RayCastClosest(std::span<const Ray> rays, std::span<SceneRayCastResult> results, iAllocator& allocator) const
+	{
+		if (!bvh.Valid())
+			const_cast<SceneBVH&>(bvh) = bvhBuildMode == SceneBVH::BuildMode::SAH ? bvh.BuildSAH(*this, allocator) : bvh.Build(*this, allocator);
+
+		bvh.RayCastClosest(rays, results, allocator);
+	}
+
+
+	/************************************************************************************************/
+
+
 	size_t	Scene::GetLightCount()
 	{
 		auto& visables		= SceneVisibilityComponent::GetComponent();
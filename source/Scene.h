@@ -10,6 +10,7 @@
 #include "CoreSceneObjects.h"
 #include "defaultpipelinestates.h"
 #include "RuntimeComponentIDs.h"
+#include "ArchetypeComponents.h"
 
 #include "FrameGraph.h"
 
@@ -263,55 +264,42 @@ namespace FlexKit
 	};
 
 
+	// Visibility values live in an ArchetypeStorage column. Handle lookups go through the storage,
+	// whole scene passes can walk the column chunk by chunk with QueryChunks.
 	class SceneVisibilityComponent : public Component<SceneVisibilityComponent, SceneVisibilityComponentID>
 	{
 	public:
-		template<typename ... TY_args>
-		SceneVisibilityComponent(iAllocator* allocator, TY_args&&... args) :
-			elements		{  allocator },
-			handles			{  allocator } {}
+		using ValueType = VisibilityFields;
 
+		// Shares a storage with other archetype components, so their columns end up in the same chunks
+		SceneVisibilityComponent(ArchetypeStorage& IN_storage, iAllocator* IN_allocator) :
+			storage			{ IN_storage },
+			handles			{ IN_allocator },
+			allocator		{ IN_allocator } {}
 
-		SceneVisibilityComponent(iAllocator* allocator) :
-			elements		{  allocator },
-			handles			{  allocator } {}
+
+		// Private storage, objects with visibility can't hold archetype components from any other storage
+		SceneVisibilityComponent(iAllocator* IN_allocator) :
+			ownedStorage	{ &IN_allocator->allocate<ArchetypeStorage>(IN_allocator) },
+			storage			{ *ownedStorage },
+			handles			{ IN_allocator },
+			allocator		{ IN_allocator } {}
 
 
 		~SceneVisibilityComponent()
 		{
-			elements.Release();
+			if (ownedStorage)
+				allocator->release(ownedStorage);
 		}
 
 
-		struct ElementData
+		VisibilityHandle Create(GameObject& gameObject, const VisibilityFields& initial)
 		{
-			VisibilityHandle handle;
-			VisibilityFields componentData;
-		};
-
+			auto& fields	= storage.Add(gameObject, SceneVisibilityComponentID, VisibilityFields{ initial });
+			fields.entity	= &gameObject;
 
-		VisibilityHandle Create(const VisibilityFields& initial)
-		{
 			auto handle		= handles.GetNewHandle();
-			handles[handle] = (index_t)elements.push_back({ handle, initial });
-
-			return handle;
-		}
-
-
-		VisibilityHandle Create(VisibilityFields&& initial)
-		{
-			auto handle = handles.GetNewHandle();
-			handles[handle] = (index_t)elements.emplace_back(handle, initial);
-
-			return handle;
-		}
-
-
-		VisibilityHandle Create()
-		{
-			auto handle = handles.GetNewHandle();
-			handles[handle] = (index_t)elements.emplace_back(handle);
+			handles[handle] = gameObject.archetypeEntity;
 
 			return handle;
 		}
@@ -330,57 +318,57 @@ namespace FlexKit
 
 		void Remove(VisibilityHandle handle)
 		{
-			auto lastElement			= std::move(elements.back());
-			elements[handles[handle]]	= std::move(lastElement);
-			elements.pop_back();
-
-			handles[lastElement.handle] = handles[handle];
+			storage.Remove(*(*this)[handle].entity, SceneVisibilityComponentID);
 			handles.RemoveHandle(handle);
 		}
 
 
-		Vector<VisibilityFields> GetElements_copy(iAllocator* tempMemory) const
+		Vector<VisibilityFields> GetElements_copy(iAllocator* tempMemory)
 		{
-			Vector<VisibilityFields>	out{ tempMemory };
+			Vector<VisibilityFields> out{ tempMemory };
 
-			for (auto& I : elements)
-				out.push_back({ I.componentData });
+			QueryChunks(
+				[&](std::span<GameObject*>, std::span<const VisibilityFields> column)
+				{
+					for (auto& fields : column)
+						out.push_back(fields);
+				});
 
 			return out;
 		}
 
 
-		auto& operator[] (VisibilityHandle handle)
+		// Calls FN(std::span<GameObject*>, std::span<const VisibilityFields>) once per chunk
+		template<typename FN>
+		void QueryChunks(FN&& fn)
 		{
-			return elements[handles[handle]].componentData;
+			storage.QueryChunks(std::forward<FN>(fn), ReadOnly<View>{});
 		}
 
-		auto operator[] (VisibilityHandle handle) const
-		{
-			return elements[handles[handle]].componentData;
-		}
 
-		auto begin()
+		auto& operator[] (VisibilityHandle handle)
 		{
-			return elements.begin();
+			return *static_cast<VisibilityFields*>(storage.Get(handles[handle], SceneVisibilityComponentID));
 		}
 
-		auto end()
+		auto operator[] (VisibilityHandle handle) const
 		{
-			return elements.end();
+			return *static_cast<const VisibilityFields*>(storage.Get(handles[handle], SceneVisibilityComponentID));
 		}
 
+		ArchetypeStorage& GetStorage() noexcept { return storage; }
+
 		
 		class View : public ComponentView_t<SceneVisibilityComponent>
 		{
 		public:
 			View(GameObject& go, const NodeHandle node, const SceneHandle scene) :
-				visibility	{ GetComponent().Create(VisibilityFields{}) }
+				visibility	{ GetComponent().Create(go, VisibilityFields{ .scene = scene, .node = node }) }
 			{
-				auto& vis_ref	= GetComponent()[visibility];
-				vis_ref.entity	= &go;
-				vis_ref.node	= node;
-				vis_ref.scene	= scene;
+
+				// BVH refits only visit the nodes the transform update reports as moved
+				if (node != InvalidHandle)
+					SetFlag(node, SceneNodes::WATCHED);
 			}
 
 
@@ -399,7 +387,12 @@ namespace FlexKit
 
 			void SetBoundingSphere(const BoundingSphere boundingSphere)
 			{
-				GetComponent()[visibility].boundingSphere = boundingSphere;
+				auto& vis_ref = GetComponent()[visibility];
+				vis_ref.boundingSphere = boundingSphere;
+
+				// Dirtying the node reports the bounds change to BVH refits like a move
+				if (vis_ref.node != InvalidHandle)
+					SetFlag(vis_ref.node, SceneNodes::DIRTY);
 			}
 
 
@@ -419,8 +412,11 @@ namespace FlexKit
 			VisibilityHandle visibility;
 		};
 
+	private:
+		ArchetypeStorage*								ownedStorage	= nullptr;
+		ArchetypeStorage&								storage;
 		HandleUtilities::HandleTable<VisibilityHandle>	handles;
-		Vector<ElementData>								elements;
+		iAllocator*										allocator;
 	};
 
 
@@ -457,8 +453,24 @@ namespace FlexKit
 		const Scene*		scene;
 	};
 
+	struct SceneRayCastResult;
+
 	struct alignas(64) SceneBVH
 	{
+		static constexpr uint32_t	InvalidParent		= 0xffffffff;
+		static constexpr uint32_t	MaxRefitCount		= 240;	// Rebuild at least this often, refitting alone never improves the Morton ordering
+		static constexpr float		MaxRefitCostRatio	= 1.5f;	// Rebuild once node surface area grows this much past the last build
+		static constexpr uint32_t	ParallelBuildThreshold	= 4096;	// Smaller scenes are built serially, dispatch would cost more than the build
+		static constexpr uint32_t	SAHBinCount				= 16;
+		static constexpr uint32_t	SAHMaxLeafSize			= 4;
+
+		enum class BuildMode : uint8_t
+		{
+			Serial,
+			Parallel,
+			SAH,		// Slower binary binned-SAH build, tighter boxes for ray queries
+		};
+
 		struct BVHElement
 		{
 			uint32_t			ID;
@@ -469,21 +481,146 @@ namespace FlexKit
 		};
 
 
+		// Scene node of an element and the leaf holding it, sorted by node
+		struct NodeLeaf
+		{
+			uint32_t	node;
+			uint32_t	leaf;
+
+			friend bool operator < (const NodeLeaf& lhs, const NodeLeaf& rhs) { return lhs.node < rhs.node; }
+		};
+
+
 		struct BVHNode {
 			AABB boundingVolume;
 
-			uint16_t	children	= 0;
+			uint32_t	children	= 0;
+			uint32_t	parent		= InvalidParent;
 			uint8_t		count		= 0;
 			bool		Leaf		= false;
 		};
 
 
+		// Bounds of a node's children in SoA form for 4-wide tests, for leaves these are the element bounds.
+		// Stored per node so leaf visits do not go through SceneVisibilityComponent.
+		struct alignas(16) PackedBounds
+		{
+			static constexpr float inf = std::numeric_limits<float>::infinity();
+
+			float minX[4] = {  inf,  inf,  inf,  inf };
+			float minY[4] = {  inf,  inf,  inf,  inf };
+			float minZ[4] = {  inf,  inf,  inf,  inf };
+			float maxX[4] = { -inf, -inf, -inf, -inf };
+			float maxY[4] = { -inf, -inf, -inf, -inf };
+			float maxZ[4] = { -inf, -inf, -inf, -inf };
+
+			void Set(const uint32_t lane, const AABB& aabb) noexcept
+			{
+				minX[lane] = aabb.Min.x;
+				minY[lane] = aabb.Min.y;
+				minZ[lane] = aabb.Min.z;
+				maxX[lane] = aabb.Max.x;
+				maxY[lane] = aabb.Max.y;
+				maxZ[lane] = aabb.Max.z;
+			}
+
+			AABB Get(const uint32_t lane) const noexcept
+			{
+				AABB aabb;
+				aabb.Min = float3{ minX[lane], minY[lane], minZ[lane] };
+				aabb.Max = float3{ maxX[lane], maxY[lane], maxZ[lane] };
+
+				return aabb;
+			}
+		};
+
+
+		// Ray prepared for 4-wide slab tests
+		struct RayQuery
+		{
+			RayQuery(const Ray& ray) noexcept
+			{
+				// Zero direction components get a huge inverse instead of inf, avoids 0 * inf = NaN on the slab planes
+				for (int I = 0; I < 3; ++I)
+				{
+					const float d = ray.D[I];
+					const float inverse = d != 0.0f ? 1.0f / d : std::copysign(1e30f, d);
+
+					O[I]		= _mm_set_ps1(ray.O[I]);
+					inverseD[I]	= _mm_set_ps1(inverse);
+				}
+			}
+
+			__m128 O[3];
+			__m128 inverseD[3];
+		};
+
+
+		// Returns a bit per lane hit within [0, tMax], entry distances clamped to zero are written to tEntry
+		static int Intersects4(const RayQuery& ray, const PackedBounds& bounds, const float tMax, __m128& tEntry) noexcept
+		{
+			const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds.minX), ray.O[0]), ray.inverseD[0]);
+			const __m128 tx2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds.maxX), ray.O[0]), ray.inverseD[0]);
+			const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds.minY), ray.O[1]), ray.inverseD[1]);
+			const __m128 ty2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds.maxY), ray.O[1]), ray.inverseD[1]);
+			const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds.minZ), ray.O[2]), ray.inverseD[2]);
+			const __m128 tz2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds.maxZ), ray.O[2]), ray.inverseD[2]);
+
+			const __m128 tMin = _mm_max_ps(
+									_mm_max_ps(_mm_min_ps(tx1, tx2), _mm_min_ps(ty1, ty2)),
+									_mm_max_ps(_mm_min_ps(tz1, tz2), _mm_setzero_ps()));
+
+			const __m128 tFar = _mm_min_ps(
+									_mm_min_ps(_mm_max_ps(tx1, tx2), _mm_max_ps(ty1, ty2)),
+									_mm_min_ps(_mm_max_ps(tz1, tz2), _mm_set_ps1(tMax)));
+
+			tEntry = tMin;
+
+			return _mm_movemask_ps(_mm_cmple_ps(tMin, tFar));
+		}
+
+
+		// Returns a bit per lane that is not fully outside of any frustum plane, matches Intersects(Frustum, AABB)
+		static int Intersects4(const Frustum& frustum, const PackedBounds& bounds) noexcept
+		{
+			const __m128 minX = _mm_loadu_ps(bounds.minX);
+			const __m128 minY = _mm_loadu_ps(bounds.minY);
+			const __m128 minZ = _mm_loadu_ps(bounds.minZ);
+			const __m128 maxX = _mm_loadu_ps(bounds.maxX);
+			const __m128 maxY = _mm_loadu_ps(bounds.maxY);
+			const __m128 maxZ = _mm_loadu_ps(bounds.maxZ);
+
+			__m128 outside = _mm_setzero_ps();
+
+			for (const auto& plane : frustum.Planes)
+			{
+				// Plane normals are uniform across lanes, so the nearest corner is picked per plane rather than per lane
+				const __m128 px = plane.n.x >= 0.0f ? minX : maxX;
+				const __m128 py = plane.n.y >= 0.0f ? minY : maxY;
+				const __m128 pz = plane.n.z >= 0.0f ? minZ : maxZ;
+
+				const __m128 dP = _mm_sub_ps(
+					_mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(px, _mm_set_ps1(plane.n.x)), _mm_mul_ps(py, _mm_set_ps1(plane.n.y))),
+						_mm_mul_ps(pz, _mm_set_ps1(plane.n.z))),
+					_mm_set_ps1(plane.n.dot(plane.o)));
+
+				outside = _mm_or_ps(outside, _mm_cmpge_ps(dP, _mm_setzero_ps()));
+			}
+
+			return ~_mm_movemask_ps(outside) & 0x0f;
+		}
+
+
 		SceneBVH() = default;
 
 		SceneBVH(iAllocator& allocator) :
-			elements	{ &allocator },
-			nodes		{ &allocator },
-			allocator	{ &allocator } {}
+			elements		{ &allocator },
+			nodes			{ &allocator },
+			packedBounds	{ &allocator },
+			nodeLeaves		{ &allocator },
+			refitState		{ &allocator },
+			allocator		{ &allocator } {}
 
 		SceneBVH(SceneBVH&& rhs)					= default;
 		SceneBVH(const SceneBVH&)					= default;
@@ -491,6 +628,19 @@ namespace FlexKit
 		SceneBVH& operator = (const SceneBVH& rhs)	= default;
 
 		static SceneBVH Build(const Scene& scene, iAllocator& allocator);
+		static SceneBVH Build(const Scene& scene, ThreadManager& threads, iAllocator& allocator);
+		static SceneBVH BuildSAH(const Scene& scene, iAllocator& allocator);
+
+		// Fills nodeLeaves once the leaves are final, shared by every builder
+		void MapNodesToLeaves(iAllocator& allocator);
+
+		// Records how much of SceneNodes::movedWatched this hierarchy has seen and marks the list consumed
+		void ConsumeMovedWatched();
+
+		// Updates the bounding volumes along the paths from moved elements to the root, moved elements are
+		// taken from SceneNodes::movedWatched entries added since the last refit or build. Returns false when
+		// the hierarchy is stale or degraded, or moves were cleared before it saw them, and needs a full Build.
+		bool Refit(const Scene& scene, iAllocator& temporary);
 
 		void Release()
 		{
@@ -498,26 +648,28 @@ namespace FlexKit
 		}
 
 		template<typename TY_BV, typename TY_FN_OnIntersection>
-		void TraverseBVHNode(const BVHNode& node, const TY_BV& bv, TY_FN_OnIntersection& IntersectionHandler) const
+		void TraverseBVHNode(const uint32_t nodeIdx, const TY_BV& bv, TY_FN_OnIntersection& IntersectionHandler) const
 		{
 			static auto& visabilityComponent = SceneVisibilityComponent::GetComponent();
 
+			const auto& node = nodes[nodeIdx];
+
 			if (!Intersects(bv, node.boundingVolume))
 				return;
 
 			if (node.Leaf)
 			{
-				const auto end = node.children + node.count;
+				const auto& bounds	= packedBounds[nodeIdx];
+				const auto	end		= node.children + node.count;
 
 				for (auto childIdx = node.children; childIdx < end; ++childIdx)
 				{
-					const auto	child			= elements[childIdx];
-					const auto&	visibleObject	= visabilityComponent[child.handle];
-					const AABB	aabb			= visibleObject.GetAABB();
+					const AABB aabb = bounds.Get(childIdx - node.children);
 
 					if (auto res = Intersects(bv, aabb); res)
 					{
-						const auto	gameObject = visibleObject.entity;
+						const auto	child		= elements[childIdx];
+						const auto	gameObject	= visabilityComponent[child.handle].entity;
 						IntersectionHandler(child.handle, res, gameObject);
 					}
 				}
@@ -527,7 +679,97 @@ namespace FlexKit
 				const auto end = node.children + node.count;
 
 				for (auto child = node.children; child < end; ++child)
-					TraverseBVHNode(nodes[child], bv, IntersectionHandler);
+					TraverseBVHNode(child, bv, IntersectionHandler);
+			}
+		}
+
+
+		// Walks the hierarchy with a whole batch of queries at once. Each node holds the list of queries still
+		// active in it, TY_FN_Test(queryIdx, PackedBounds) returns the lanes (children) a query continues into,
+		// TY_FN_Leaf(queryIdx, leafIdx) is called for every query reaching a leaf.
+		template<typename TY_FN_Test, typename TY_FN_Leaf>
+		void TraverseStream(const uint32_t queryCount, TY_FN_Test&& test, TY_FN_Leaf&& onLeaf, iAllocator& temporary) const
+		{
+			if (!Valid() || !queryCount)
+				return;
+
+			struct StreamEntry
+			{
+				uint32_t node;
+				uint32_t begin;
+				uint32_t count;
+			};
+
+			// Query lists are allocated like a stack, entries are popped in reverse order of their lists
+			// so everything past the popped entry's list belongs to finished subtrees.
+			Vector<uint32_t>	queries	{ &temporary, queryCount * 4 };
+			Vector<uint8_t>		masks	{ &temporary, queryCount, uint8_t(0) };
+			Vector<StreamEntry>	stack	{ &temporary, 64 };
+
+			for (uint32_t I = 0; I < queryCount; ++I)
+				queries.push_back(I);
+
+			stack.push_back({ root, 0, queryCount });
+
+			while (stack.size())
+			{
+				const auto		entry		= stack.pop_back();
+				const auto&		node		= nodes[entry.node];
+				const uint32_t	arenaEnd	= entry.begin + entry.count;
+
+				if (node.Leaf)
+				{
+					for (uint32_t I = entry.begin; I < arenaEnd; ++I)
+						onLeaf(queries[I], entry.node);
+
+					continue;
+				}
+
+				FK_ASSERT(node.count <= 4);
+
+				const auto&		bounds		= packedBounds[entry.node];
+				const int		laneMask	= (1 << node.count) - 1;
+				uint32_t		laneCounts[4] = {};
+
+				for (uint32_t I = 0; I < entry.count; ++I)
+				{
+					const int mask = test(queries[entry.begin + I], bounds) & laneMask;
+					masks[I] = uint8_t(mask);
+
+					for (int lane = 0; lane < 4; ++lane)
+						laneCounts[lane] += (mask >> lane) & 0x01;
+				}
+
+				uint32_t laneBegin[4];
+				uint32_t offset = arenaEnd;
+
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					laneBegin[lane]	= offset;
+					offset			+= laneCounts[lane];
+				}
+
+				if (queries.size() < offset)
+					queries.resize(offset);
+
+				uint32_t cursor[4] = { laneBegin[0], laneBegin[1], laneBegin[2], laneBegin[3] };
+
+				for (uint32_t I = 0; I < entry.count; ++I)
+				{
+					const uint32_t query = queries[entry.begin + I];
+
+					for (int lane = 0; lane < 4; ++lane)
+					{
+						if (masks[I] & (1 << lane))
+							queries[cursor[lane]++] = query;
+					}
+				}
+
+				for (uint32_t lane = 0; lane < 4; ++lane)
+				{
+					if (laneCounts[lane])
+						stack.push_back({ node.children + lane, laneBegin[lane], laneCounts[lane] });
+				}
 			}
 		}
 
@@ -536,9 +778,45 @@ namespace FlexKit
 		void Traverse(const TY_BV& bv, TY_FN_OnIntersection IntersectionHandler) const
 		{
 			if(nodes.size())
-				TraverseBVHNode(nodes[root], bv, IntersectionHandler);
+				TraverseBVHNode(root, bv, IntersectionHandler);
+		}
+
+
+		// Batched frustum query, calls IntersectionHandler(frustumIdx, VisibilityHandle, GameObject*) for each overlap.
+		template<typename TY_FN_OnIntersection>
+		void TraverseFrusta(std::span<const Frustum> frusta, TY_FN_OnIntersection IntersectionHandler, iAllocator& temporary) const
+		{
+			auto& visabilityComponent = SceneVisibilityComponent::GetComponent();
+
+			TraverseStream(
+				(uint32_t)frusta.size(),
+				[&](const uint32_t frustumIdx, const PackedBounds& bounds)
+				{
+					return Intersects4(frusta[frustumIdx], bounds);
+				},
+				[&](const uint32_t frustumIdx, const uint32_t leafIdx)
+				{
+					const auto& leaf	= nodes[leafIdx];
+					const int	mask	= Intersects4(frusta[frustumIdx], packedBounds[leafIdx]) & ((1 << leaf.count) - 1);
+
+					for (uint32_t lane = 0; lane < leaf.count; ++lane)
+					{
+						if (mask & (1 << lane))
+						{
+							const auto handle = elements[leaf.children + lane].handle;
+							IntersectionHandler(frustumIdx, handle, visabilityComponent[handle].entity);
+						}
+					}
+				},
+				temporary);
 		}
 
+		// Front to back traversal, skips any node further away than the closest hit found so far.
+		std::optional<SceneRayCastResult> RayCastClosest(const Ray& ray, iAllocator& temporary) const;
+
+		// Batched closest hit query, results[I] receives the closest hit of rays[I] or an InvalidHandle visibileObject on a miss.
+		void RayCastClosest(std::span<const Ray> rays, std::span<SceneRayCastResult> results, iAllocator& temporary) const;
+
 		bool Valid() const
 		{
 			return nodes.size();
@@ -550,7 +828,14 @@ namespace FlexKit
 
 			copy.elements	= elements.Copy(dest);
 			copy.nodes		= nodes.Copy(dest);
+			copy.packedBounds	= packedBounds.Copy(dest);
+			copy.nodeLeaves	= nodeLeaves.Copy(dest);
 			copy.root		= root;
+			copy.buildCost	= buildCost;
+			copy.cost		= cost;
+			copy.refitCount	= refitCount;
+			copy.movedGeneration	= movedGeneration;
+			copy.movedConsumed		= movedConsumed;
 
 			return copy;
 		}
@@ -559,12 +844,28 @@ namespace FlexKit
 		{
 			elements.clear();
 			nodes.clear();
-			root = 0;
+			packedBounds.clear();
+			nodeLeaves.clear();
+			refitState.clear();
+			root		= 0;
+			buildCost	= 0.0f;
+			cost		= 0.0f;
+			refitCount	= 0;
+			movedGeneration	= 0;
+			movedConsumed	= 0;
 		}
 
 		Vector<BVHElement>		elements;
 		Vector<BVHNode>			nodes;
-		uint16_t				root		= 0;
+		Vector<PackedBounds>	packedBounds;
+		Vector<NodeLeaf>		nodeLeaves;
+		Vector<uint8_t>			refitState;	// Per node, kept between refits so a refit only touches the nodes it queues
+		uint32_t				root		= 0;
+		float					buildCost	= 0.0f;
+		float					cost		= 0.0f;
+		uint32_t				refitCount	= 0;
+		uint64_t				movedGeneration	= 0;	// SceneNodes::movedGeneration and movedWatched size at the last refit or build
+		size_t					movedConsumed	= 0;
 		iAllocator*				allocator	= nullptr;
 	};
 
@@ -614,7 +915,8 @@ namespace FlexKit
 				HandleTable					{ in_allocator		},
 				sceneID						{ (size_t)rand()	},
 				ownedGameObjects			{ in_allocator		},
-				sceneEntities				{ in_allocator		} {}
+				sceneEntities				{ in_allocator		},
+				queryAccess					{ in_allocator		} {}
 				
 		~Scene()
 		{
@@ -637,7 +939,9 @@ namespace FlexKit
 		GatherVisibleLightsTask&	GetVisableLights(UpdateDispatcher&, CameraHandle, BuildBVHTask&, iAllocator* tempMemory) const;
 		LightUpdate&				UpdateLights(UpdateDispatcher&, BuildBVHTask&, GatherVisibleLightsTask&, iAllocator* temporaryMemory, iAllocator* persistentMemory) const;
 
-		Vector<SceneRayCastResult>	RayCast(FlexKit::Ray v, iAllocator& allocator = SystemAllocator) const;
+		Vector<SceneRayCastResult>			RayCast			(FlexKit::Ray v, iAllocator& allocator = SystemAllocator) const;
+		std::optional<SceneRayCastResult>	RayCastClosest	(FlexKit::Ray v, iAllocator& allocator = SystemAllocator) const;
+		void								RayCastClosest	(std::span<const Ray> rays, std::span<SceneRayCastResult> results, iAllocator& allocator = SystemAllocator) const;
 
 		template<typename ... TY_Queries>
 		[[nodiscard]] auto Query(iAllocator& allocator, TY_Queries ... queries)
@@ -662,9 +966,6 @@ namespace FlexKit
 		{
 			auto& visables = SceneVisibilityComponent::GetComponent();
 
-			using Optional_ty = decltype(FlexKit::Query(std::declval<GameObject&>(), queries...));
-			Vector<Optional_ty> results{ &allocator };
-
 			uint32_t count = 0;
 
 			for (auto entity : sceneEntities)
@@ -694,6 +995,116 @@ namespace FlexKit
 			}
 		}
 
+		// Parallel variants, sceneEntities is split into blocks across the worker threads.
+		// They declare their access through ReadOnly<>/Mut<> and hold a queryAccess ticket while the workers run,
+		// a parallel query that would race a running one is rejected: Query returns an empty optional, QueryFor false.
+		// Serial queries run on the calling thread and are not tracked, they can nest inside each other's callbacks.
+		template<typename ... TY_Queries>
+		[[nodiscard]] auto Query(ThreadManager& threads, iAllocator& allocator, TY_Queries ... queries)
+		{
+			ProfileFunction();
+
+			using Optional_ty	= decltype(FlexKit::Query(std::declval<GameObject&>(), queries...));
+			using Block_ty		= Vector<Optional_ty>;
+
+			const ComponentAccessTracker::ScopedTicket ticket{ queryAccess, GetComponentAccess<TY_Queries...>() };
+			if (!ticket)
+			{
+				FK_LOG_ERROR("Scene::Query: parallel query conflicts with a running query!");
+				return std::optional<Vector<Optional_ty>>{};
+			}
+
+			Vector<Optional_ty> results{ &allocator };
+
+			auto& visables				= SceneVisibilityComponent::GetComponent();
+			const size_t blockSize		= GetQueryBlockSize(threads);
+			const size_t blockCount		= (sceneEntities.size() + blockSize - 1) / blockSize;
+
+			Vector<Block_ty>	blocks{ &allocator, blockCount };
+			std::mutex			m;
+
+			for (size_t I = 0; I < blockCount; ++I)
+				blocks.emplace_back(&allocator);
+
+			Parallel_For2(
+				threads, allocator,
+				sceneEntities.begin(), sceneEntities.end(), blockSize,
+				[&](auto begin, auto end, size_t dispatchID, iAllocator& threadLocal)
+				{
+					Block_ty local{ &threadLocal };
+
+					for (auto itr = begin; itr != end; ++itr)
+					{
+						auto& gameObject = *visables[*itr].entity;
+						if (auto res = FlexKit::Query(gameObject, queries...); res)
+							local.emplace_back(std::move(res));
+					}
+
+					if (local.empty())
+						return;
+
+					// caller's allocator isn't assumed to be thread safe
+					std::scoped_lock lock{ m };
+
+					auto& block = blocks[dispatchID];
+					block.reserve(local.size());
+
+					for (auto& res : local)
+						block.emplace_back(std::move(res));
+				});
+
+			size_t resultCount = 0;
+			for (auto& block : blocks)
+				resultCount += block.size();
+
+			results.reserve(resultCount);
+
+			for (auto& block : blocks)
+				for (auto& res : block)
+					results.emplace_back(std::move(res));
+
+			return std::optional<Vector<Optional_ty>>{ std::move(results) };
+		}
+
+		template<typename TY_FN, typename ... TY_Queries>
+		bool QueryFor(ThreadManager& threads, iAllocator& allocator, TY_FN FN, const TY_Queries& ... queries)
+		{
+			ProfileFunction();
+
+			const ComponentAccessTracker::ScopedTicket ticket{ queryAccess, GetComponentAccess<TY_Queries...>() };
+			if (!ticket)
+			{
+				FK_LOG_ERROR("Scene::QueryFor: parallel query conflicts with a running query!");
+				return false;
+			}
+
+			auto& visables = SceneVisibilityComponent::GetComponent();
+
+			Parallel_For2(
+				threads, allocator,
+				sceneEntities.begin(), sceneEntities.end(), GetQueryBlockSize(threads),
+				[&](auto begin, auto end, size_t dispatchID, iAllocator& threadLocal)
+				{
+					for (auto itr = begin; itr != end; ++itr)
+					{
+						auto& gameObject = *visables[*itr].entity;
+						if (auto res = FlexKit::Query(gameObject, queries...); res)
+							FN(gameObject, res);
+					}
+				});
+
+			return true;
+		}
+
+		size_t GetQueryBlockSize(ThreadManager& threads) const
+		{
+			const size_t threadCount = Max(threads.GetThreadCount(), 1);
+
+			return Max(sceneEntities.size() / (threadCount * 4), ParallelQueryMinBlockSize);
+		}
+
+		static constexpr size_t ParallelQueryMinBlockSize = 256;
+
 		auto begin()	{ return sceneEntities.begin(); }
 		auto end()		{ return sceneEntities.end(); }
 
@@ -704,7 +1115,10 @@ namespace FlexKit
 		Vector<GameObject*>				ownedGameObjects;
 		Vector<VisibilityHandle>		sceneEntities;
 		SceneBVH						bvh;
-		iAllocator*						allocator = nullptr;
+		SceneBVH::BuildMode				bvhBuildMode	= SceneBVH::BuildMode::Parallel;
+		bool							bvhDirty		= true;
+		ComponentAccessTracker			queryAccess;
+		iAllocator*						allocator		= nullptr;
 
 		operator Scene* () { return this; }
 	};
@@ -3,6 +3,15 @@
 #include "Serialization.hpp"
 #include "Logging.h"
 
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace FlexKit
 {   /************************************************************************************************/
 
@@ -42,6 +51,138 @@ namespace FlexKit
     }
 
 
+    /************************************************************************************************/
+
+
+    size_t CompressBlockBound(const size_t size)
+    {
+        return zng_compressBound(size);
+    }
+
+
+    /************************************************************************************************/
+
+
+    std::optional<size_t> CompressBlock(const void* src, const size_t srcSize, void* dest, const size_t destCapacity)
+    {
+        size_t size = destCapacity;
+
+        if (auto res = zng_compress((uint8_t*)dest, &size, (const uint8_t*)src, srcSize); res != Z_OK)
+            return {};
+
+        return size;
+    }
+
+
+    /************************************************************************************************/
+
+
+    bool DecompressBlock(const void* src, const size_t srcSize, void* dest, const size_t destSize)
+    {
+        size_t size = destSize;
+
+        if (auto res = zng_uncompress((uint8_t*)dest, &size, (const uint8_t*)src, srcSize); res != Z_OK)
+            return false;
+
+        return size == destSize;
+    }
+
+
+    /************************************************************************************************/
+
+
+    MappedFile::MappedFile(const char* path)
+    {
+#if defined(_WIN32)
+        HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            FK_LOG_ERROR("Failed to open file for mapping: %s", path);
+            return;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(fileHandle);
+            return;
+        }
+
+        HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (!mappingHandle)
+        {
+            FK_LOG_ERROR("Failed to create file mapping: %s", path);
+            CloseHandle(fileHandle);
+            return;
+        }
+
+        auto view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+        if (!view)
+        {
+            FK_LOG_ERROR("Failed to map view of file: %s", path);
+            CloseHandle(mappingHandle);
+            CloseHandle(fileHandle);
+            return;
+        }
+
+        file    = fileHandle;
+        mapping = mappingHandle;
+        _ptr    = static_cast<const std::byte*>(view);
+        _size   = static_cast<size_t>(fileSize.QuadPart);
+#else
+        const int fd = open(path, O_RDONLY);
+
+        if (fd == -1)
+        {
+            FK_LOG_ERROR("Failed to open file for mapping: %s", path);
+            return;
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+        {
+            close(fd);
+            return;
+        }
+
+        auto view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (view == MAP_FAILED)
+        {
+            FK_LOG_ERROR("Failed to map file: %s", path);
+            return;
+        }
+
+        madvise(view, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+
+        _ptr    = static_cast<const std::byte*>(view);
+        _size   = static_cast<size_t>(fileStat.st_size);
+#endif
+    }
+
+
+    /************************************************************************************************/
+
+
+    MappedFile::~MappedFile()
+    {
+        if (!_ptr)
+            return;
+
+#if defined(_WIN32)
+        UnmapViewOfFile(_ptr);
+        CloseHandle(static_cast<HANDLE>(mapping));
+        CloseHandle(static_cast<HANDLE>(file));
+#else
+        munmap(const_cast<std::byte*>(_ptr), _size);
+#endif
+    }
+
+
 }   /************************************************************************************************/
 
 
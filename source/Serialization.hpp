@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <any>
 #include <assert.h>
 #include <cstdio>
@@ -12,6 +13,10 @@
 #include <variant>
 #include <optional>
 #include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
 #include "static_vector.h"
 
 namespace FlexKit
@@ -120,6 +125,189 @@ namespace FlexKit
 		}while(bytesWritten < b.size());
 	}
 
+
+	/************************************************************************************************/
+
+
+	// Growable output buffer made out of fixed size chunks, appending never moves bytes that were already written.
+	// With a spill file set, full chunks are written out and their memory reused so only a single chunk stays resident.
+	class ArchiveWriteBuffer
+	{
+	public:
+		static constexpr size_t ChunkSize = 1024 * 1024;
+
+		ArchiveWriteBuffer() = default;
+
+		ArchiveWriteBuffer(const ArchiveWriteBuffer&)               = delete;
+		ArchiveWriteBuffer& operator = (const ArchiveWriteBuffer&)  = delete;
+
+		ArchiveWriteBuffer(ArchiveWriteBuffer&&)                    = default;
+		ArchiveWriteBuffer& operator = (ArchiveWriteBuffer&&)       = default;
+
+
+		void Write(const void* src, size_t byteSize)
+		{
+			auto bytes = static_cast<const std::byte*>(src);
+
+			while (byteSize)
+			{
+				if (chunks.empty() || chunks.back().used == ChunkSize)
+					NextChunk();
+
+				auto& chunk			= chunks.back();
+				const size_t count	= std::min(byteSize, ChunkSize - chunk.used);
+
+				memcpy(chunk.data.get() + chunk.used, bytes, count);
+
+				chunk.used	+= count;
+				bytes		+= count;
+				byteSize	-= count;
+				bufferedSize += count;
+			}
+		}
+
+
+		void Append(const ArchiveWriteBuffer& rhs)
+		{
+			assert(rhs.spill == nullptr);
+
+			for (auto& chunk : rhs.chunks)
+				Write(chunk.data.get(), chunk.used);
+		}
+
+
+		// Full chunks are written to file as soon as the next chunk is needed.
+		void SetSpillFile(FILE* file)
+		{
+			spill.reset(file);
+		}
+
+
+		size_t size() const noexcept
+		{
+			return spilledSize + bufferedSize;
+		}
+
+
+		bool WriteTo(FILE* file)
+		{
+			if (spill)
+			{
+				std::byte* scratch = chunks.size() ? chunks.front().data.get() : nullptr;
+				std::unique_ptr<std::byte[]> temp;
+
+				if (!scratch)
+				{
+					temp	= std::make_unique_for_overwrite<std::byte[]>(ChunkSize);
+					scratch	= temp.get();
+				}
+
+				// Buffered chunks have to go out first to free up one as scratch space
+				for (auto& chunk : chunks)
+				{
+					if (fwrite(chunk.data.get(), 1, chunk.used, spill.get()) != chunk.used)
+						return false;
+
+					spilledSize		+= chunk.used;
+					bufferedSize	-= chunk.used;
+					chunk.used		= 0;
+				}
+
+				chunks.resize(std::min<size_t>(chunks.size(), 1));
+
+				fflush(spill.get());
+				rewind(spill.get());
+
+				size_t remaining = spilledSize;
+				while (remaining)
+				{
+					const size_t count = fread(scratch, 1, std::min(remaining, ChunkSize), spill.get());
+
+					if (!count || fwrite(scratch, 1, count, file) != count)
+						return false;
+
+					remaining -= count;
+				}
+
+				fseek(spill.get(), 0, SEEK_END);
+			}
+			else
+			{
+				for (auto& chunk : chunks)
+				{
+					if (fwrite(chunk.data.get(), 1, chunk.used, file) != chunk.used)
+						return false;
+				}
+			}
+
+			return true;
+		}
+
+
+		// dest has to hold size() bytes, spilled data is read back from the spill file first
+		bool CopyTo(std::byte* dest)
+		{
+			if (spill && spilledSize)
+			{
+				fflush(spill.get());
+				rewind(spill.get());
+
+				const size_t count = fread(dest, 1, spilledSize, spill.get());
+
+				fseek(spill.get(), 0, SEEK_END);
+
+				if (count != spilledSize)
+					return false;
+
+				dest += spilledSize;
+			}
+
+			for (auto& chunk : chunks)
+			{
+				memcpy(dest, chunk.data.get(), chunk.used);
+				dest += chunk.used;
+			}
+
+			return true;
+		}
+
+	private:
+
+		void NextChunk()
+		{
+			if (spill && chunks.size())
+			{
+				auto& chunk = chunks.back();
+				if (fwrite(chunk.data.get(), 1, chunk.used, spill.get()) != chunk.used)
+					throw std::runtime_error("Failed to write archive spill file");
+
+				spilledSize		+= chunk.used;
+				bufferedSize	-= chunk.used;
+				chunk.used		= 0;
+			}
+			else
+				chunks.emplace_back(Chunk{ std::make_unique_for_overwrite<std::byte[]>(ChunkSize), 0 });
+		}
+
+
+		struct Chunk
+		{
+			std::unique_ptr<std::byte[]>	data;
+			size_t							used = 0;
+		};
+
+		struct FileCloser
+		{
+			void operator () (FILE* f) const noexcept { fclose(f); }
+		};
+
+		std::vector<Chunk>					chunks;
+		std::unique_ptr<FILE, FileCloser>	spill;
+		size_t								spilledSize		= 0;
+		size_t								bufferedSize	= 0;
+	};
+
+
 	/************************************************************************************************/
 
 
@@ -131,6 +319,7 @@ namespace FlexKit
 	class SaveArchiveContext;
 	class LoadFileArchiveContext;
 	class LoadBlobArchiveContext;
+	class LoadMappedArchiveContext;
 
 	class SerializableBase
 	{
@@ -139,6 +328,7 @@ namespace FlexKit
 		virtual void _Serialize(SaveArchiveContext& archive) {}
 		virtual void _Serialize(LoadFileArchiveContext& archive) {}
 		virtual void _Serialize(LoadBlobArchiveContext& archive) {}
+		virtual void _Serialize(LoadMappedArchiveContext& archive) {}
 
 		virtual TypeID_t GetTypeID() const noexcept { return -1; }
 
@@ -193,6 +383,11 @@ namespace FlexKit
 			static_cast<TY*>(this)->Serialize(archive);
 		}
 
+		void _Serialize(LoadMappedArchiveContext& archive) final
+		{
+			static_cast<TY*>(this)->Serialize(archive);
+		}
+
 		size_t GetID() { return typeID; }
 
 		virtual TypeID_t GetTypeID() const noexcept final { return typeID; }
@@ -251,6 +446,12 @@ namespace FlexKit
 	};
 
 
+	// Tag for a SaveArchiveContext that streams its data to a temporary file while serializing.
+	struct StreamedArchive
+	{
+	};
+
+
 	/************************************************************************************************/
 
 
@@ -398,15 +599,36 @@ namespace FlexKit
 		size_t& size;
 	};
 
+	// Written the same as a RawBuffer. LoadMappedArchiveContext points _ptr into the mapping instead of
+	// allocating, the buffer is owned by the archive and only valid while it is open.
+	struct RawBufferView
+	{
+		const void*&	_ptr;
+		size_t&			size;
+	};
+
 	std::optional<Blob>     CompressBuffer      (const RawBuffer& buffer);
 	std::optional<void*>    DecompressBuffer    (const RawBuffer& buffer, const size_t decompressedBufferSize);
 
+	// Single block helpers, no allocation or logging. Blocks compressed with CompressBlock are independent of each other.
+	size_t                  CompressBlockBound  (const size_t size);
+	std::optional<size_t>   CompressBlock       (const void* src, const size_t srcSize, void* dest, const size_t destCapacity);
+	bool                    DecompressBlock     (const void* src, const size_t srcSize, void* dest, const size_t destSize);
+
 	constexpr const char* stringTest() { return "Testing"; }
 
 	class SaveArchiveContext
 	{
 	public:
-		SaveArchiveContext() = default;
+		SaveArchiveContext() { dataBuffer.emplace_back(); }
+
+		// Data is spilled to a temporary file in ArchiveWriteBuffer::ChunkSize pieces instead of held in memory,
+		// use WriteToFile to write out the final archive.
+		SaveArchiveContext(StreamedArchive) : SaveArchiveContext{}
+		{
+			if (auto spillFile = std::tmpfile(); spillFile)
+				dataBuffer.front().SetSpillFile(spillFile);
+		}
 
 		SaveArchiveContext(const SaveArchiveContext&)               = delete;
 		SaveArchiveContext(SaveArchiveContext&&)                    = delete;
@@ -419,8 +641,22 @@ namespace FlexKit
 		std::map<std::string, SerializableBase*>    serializers;
 		std::map<void*, DeferredSerializer>         deferred;
 
-		std::vector<Blob>           dataBuffer = { Blob{} };
-		std::vector<PointerValue>   pointerTable;
+		std::vector<ArchiveWriteBuffer> dataBuffer;
+		std::vector<PointerValue>       pointerTable;
+
+
+		template<typename TY>
+		requires std::is_trivially_copyable_v<TY>
+		void Write(const TY& value)
+		{
+			dataBuffer.back().Write(&value, sizeof(TY));
+		}
+
+
+		void Write(const void* src, const size_t size)
+		{
+			dataBuffer.back().Write(src, size);
+		}
 
 
 		//template<typename TY>
@@ -433,7 +669,7 @@ namespace FlexKit
 		void _Serialize(SerializableInterfacePointer auto& value)
 		{
 			const TypeID_t typeID = GetTypeID(value);
-			dataBuffer.back() += { typeID };
+			Write(typeID);
 
 			value._Serialize(*this);
 		}
@@ -443,7 +679,7 @@ namespace FlexKit
 		requires TrivialCopy<TY, SaveArchiveContext>
 		void _Serialize(TY& value)
 		{
-			dataBuffer.back() += Blob{ value };
+			Write(value);
 		}
 
 
@@ -473,15 +709,16 @@ namespace FlexKit
 
 			value->Serialize(*this);
 
-			*(++dataBuffer.rbegin()) += dataBuffer.back();
+			auto child = std::move(dataBuffer.back());
 			dataBuffer.pop_back();
+			dataBuffer.back().Append(child);
 		}
 
 
 		void _Serialize(const std::string& string)
 		{
-			dataBuffer.back() += StringHeader{ string.size() };
-			dataBuffer.back() += Blob{ string.data(), string.size() };
+			Write(StringHeader{ string.size() });
+			Write(string.data(), string.size());
 		}
 
 
@@ -502,11 +739,11 @@ namespace FlexKit
 								_Serialize(*_ptr); 
 							};
 
-					dataBuffer.back() += Blob{ PointerHeader{ PointerHeader{ typeID, (uint64_t)_ptr}}};
+					Write(PointerHeader{ typeID, (uint64_t)_ptr });
 				}
 				else
 				{
-					dataBuffer.back() += PointerHeader{ 0, (uint64_t)nullptr };
+					Write(PointerHeader{ 0, (uint64_t)nullptr });
 				}
 			}
 			else
@@ -520,7 +757,7 @@ namespace FlexKit
 							_Serialize(value); 
 						};
 
-				dataBuffer.back() += Blob{ PointerHeader{ typeID, (uint64_t)value } };
+				Write(PointerHeader{ typeID, (uint64_t)value });
 			}
 		}
 
@@ -536,7 +773,7 @@ namespace FlexKit
 		void SerializeValue(std::variant<TY_Types...>& variant)
 		{
 			size_t i = variant.index();
-			dataBuffer.back() += i;
+			Write(i);
 
 			if (i != std::variant_npos)
 				std::visit(
@@ -554,7 +791,7 @@ namespace FlexKit
 
 			const auto& typeID = typeid(std::map<TY_Key, TY_Value>);
 
-			dataBuffer.back() += MapHeader{ value_map.size() };
+			Write(MapHeader{ value_map.size() });
 
 			for (auto& element : value_map)
 			{
@@ -577,18 +814,35 @@ namespace FlexKit
 			using namespace SerializeableUtilities;
 
 			const auto& typeID = typeid(TY).hash_code();
-			dataBuffer.back() += VectorHeader{ typeID, vector.size() };
+			Write(VectorHeader{ typeID, vector.size() });
 
-			for (auto& element : vector)
+			if constexpr (TrivialCopy<TY, SaveArchiveContext> && !is_pointer<TY>())
+			{	// Same bytes as writing each element, in one copy
+				Write(vector.data(), sizeof(TY) * vector.size());
+			}
+			else
 			{
-				if constexpr (is_pointer<TY>())
-					SerializePointer(element);
-				else
-					SerializeValue(element);
+				for (auto& element : vector)
+				{
+					if constexpr (is_pointer<TY>())
+						SerializePointer(element);
+					else
+						SerializeValue(element);
+				}
 			}
 		}
 
 
+		// Written as a std::vector<TY>, can be loaded back as either a std::vector or a std::span view.
+		template<typename TY>
+		requires TrivialCopy<TY, SaveArchiveContext>
+		void SerializeValue(std::span<const TY> range)
+		{
+			Write(VectorHeader{ typeid(TY).hash_code(), range.size() });
+			Write(range.data(), range.size_bytes());
+		}
+
+
 		template<typename TY>
 		void operator & (TY& rhs)
 		{
@@ -601,30 +855,46 @@ namespace FlexKit
 		}
 
 
+		template<typename TY>
+		void operator & (std::span<const TY>& rhs)
+		{
+			SerializeValue(rhs);
+		}
+
+
 		void operator & (RawBuffer&& rhs)
 		{
 			if (rhs.size < 4096)
 			{
-				dataBuffer.back() += rhs.size;
-				dataBuffer.back() += Blob{ (const char*)rhs._ptr, rhs.size };
+				Write(rhs.size);
+				Write(rhs._ptr, rhs.size);
 			}
 			else
 			{
 				if (auto compressed = CompressBuffer(rhs); compressed)
 				{
-					dataBuffer.back() += rhs.size;
-					dataBuffer.back() += compressed.value().buffer.size();
-					dataBuffer.back() += compressed.value();
+					Write(rhs.size);
+					Write(compressed.value().buffer.size());
+					Write(compressed.value().buffer.data(), compressed.value().buffer.size());
 				}
 				else
 				{
-					dataBuffer.back() += 0;
-					dataBuffer.back() += 0;
+					Write(0);
+					Write(0);
 				}
 			}
 		}
 
 
+		void operator & (RawBufferView&& rhs)
+		{
+			void*	_ptr = const_cast<void*>(rhs._ptr);
+			size_t	size = rhs.size;
+
+			(*this) & RawBuffer{ _ptr, size };
+		}
+
+
 		void SerializeDeferred()
 		{
 			assert(dataBuffer.size() == 1);
@@ -645,26 +915,10 @@ namespace FlexKit
 				}
 			} while (deferred.size());
 
-			PointerTableHeader header{ pointerTable.size(), sizeof(PointerValue) * pointerTable.size() };
-			size_t pointerTableSize = sizeof(PointerTableHeader) + sizeof(PointerValue) * pointerTable.size();
+			const size_t pointerTableSize = sizeof(PointerTableHeader) + sizeof(PointerValue) * pointerTable.size();
 
-			Blob pointerTableBlob;
 			for (auto& pointerKey : pointerTable)
-			{
-				pointerKey.offset   += pointerTableSize;
-				pointerTableBlob    += pointerKey;
-			}
-
-			/*
-			* { Header }
-			*   [PointerTable]
-			* { DataBlocks   }
-			*   [bytes] * n
-			*   [void*, size_t] * n
-			* { DataBlocks   }
-			*/
-
-			dataBuffer.back() = Blob{ header } + pointerTableBlob + dataBuffer.back();
+				pointerKey.offset += pointerTableSize;
 		}
 
 
@@ -684,7 +938,45 @@ namespace FlexKit
 		{
 			SerializeDeferred();
 
-			return dataBuffer.front();
+			/*
+			* { Header }
+			*   [PointerTable]
+			* { DataBlocks   }
+			*   [bytes] * n
+			*   [void*, size_t] * n
+			* { DataBlocks   }
+			*/
+
+			const PointerTableHeader	header{ pointerTable.size(), sizeof(PointerValue) * pointerTable.size() };
+			const size_t				tableSize = sizeof(PointerValue) * pointerTable.size();
+
+			Blob out;
+			out.resize(sizeof(header) + tableSize + dataBuffer.front().size());
+
+			memcpy(out.data(), &header, sizeof(header));
+			if (tableSize)
+				memcpy(out.data() + sizeof(header), pointerTable.data(), tableSize);
+			if (!dataBuffer.front().CopyTo(out.data() + sizeof(header) + tableSize))
+				throw std::runtime_error("Failed to read back archive spill file");
+
+			return out;
+		}
+
+
+		// Writes the archive to file without building it as a single Blob first.
+		bool WriteToFile(FILE* file)
+		{
+			SerializeDeferred();
+
+			const PointerTableHeader header{ pointerTable.size(), sizeof(PointerValue) * pointerTable.size() };
+
+			if (fwrite(&header, 1, sizeof(header), file) != sizeof(header))
+				return false;
+
+			if (fwrite(pointerTable.data(), sizeof(PointerValue), pointerTable.size(), file) != pointerTable.size())
+				return false;
+
+			return dataBuffer.front().WriteTo(file);
 		}
 	};
 
@@ -1372,62 +1664,629 @@ namespace FlexKit
 	};
 
 
-	template<class Archive, typename T, size_t Size>
-	void Serialize(Archive& ar, FlexKit::static_vector<T, Size>& vector)
+	/************************************************************************************************/
+
+
+	// Read only memory mapping of a whole file
+	class MappedFile
 	{
-		if (ar.Loading())
-		{
-			size_t S = 0;
-			ar& S;
-			vector.resize(S);
-		}
-		else
-		{
-			size_t S = vector.size();
-			ar& S;
-		}
+	public:
+		MappedFile() = default;
+		MappedFile(const char* path);
+		~MappedFile();
 
-		for (auto& element : vector)
-			ar& element;
-	}
+		MappedFile              (const MappedFile&) = delete;
+		MappedFile& operator =  (const MappedFile&) = delete;
+
+		bool				IsOpen()	const noexcept { return _ptr != nullptr; }
+		const std::byte*	data()		const noexcept { return _ptr; }
+		size_t				size()		const noexcept { return _size; }
+
+	private:
+		const std::byte*	_ptr	= nullptr;
+		size_t				_size	= 0;
+
+		void*				file	= nullptr;
+		void*				mapping	= nullptr;
+	};
 
 
 	/************************************************************************************************/
 
 
-	struct ValueStore
+	// Reads an archive through a memory mapping of the file instead of a read per field.
+	// The pointer table is left in place and only indexed the first time a pointer or mapped value is resolved.
+	// Arrays of trivially copyable values can be read as views into the mapping with DeserializeView and RawBufferView,
+	// views are only valid while the context is alive.
+	// Sizes and offsets read from the file are checked against the mapping, a truncated or corrupt archive fails
+	// the load instead of reading past the end. Once failed every further read returns zeroes, check Failed once done.
+	class LoadMappedArchiveContext
 	{
-		struct ValueMapping
+		// Fails the load if size bytes aren't left at the current offset
+		bool CheckRead(size_t size) noexcept
 		{
-			using Deserializer	= std::function<void(ValueMapping&, LoadFileArchiveContext&)>;
-			using Deserializer2	= std::function<void(ValueMapping&, LoadBlobArchiveContext&)>;
-			using Serializer	= std::function<void(ValueMapping&, SaveArchiveContext&)>;
+			if (failed || offset > file.size() || size > file.size() - offset)
+			{
+				failed = true;
+				return false;
+			}
 
-			uint64_t							id;
-			uint64_t							blobId;
+			return true;
+		}
 
-			Deserializer	deserializer;
-			Deserializer2	deserializer2;
-			Serializer		serializer;
+		// Same check for count elements of elementSize, without overflowing
+		bool CheckRead(size_t count, size_t elementSize) noexcept
+		{
+			if (elementSize && count > std::numeric_limits<size_t>::max() / elementSize)
+			{
+				failed = true;
+				return false;
+			}
 
-			void Serialize(auto& ar)
+			return CheckRead(count * elementSize);
+		}
+
+		void Read(void* dest, size_t size) noexcept
+		{
+			if (!CheckRead(size))
 			{
-				ar& id;
-				ar& blobId;
+				memset(dest, 0, size);
+				return;
 			}
-		};
 
-		void Bind(std::string_view id, auto& rhs)
+			memcpy(dest, file.data() + offset, size);
+			offset += size;
+		}
+
+		void Seek(size_t pos) noexcept
 		{
-			const auto idHash		= std::hash<std::string_view>{}(id);
-			const uint64_t blobId	= rand();
+			if (pos > file.size())
+				failed = true;
+			else
+				offset = pos;
+		}
 
-			auto deserializer = [&, idHash, id](ValueMapping& value, LoadFileArchiveContext& ctx)
-			{
-				ctx.MappedValue(value.blobId, rhs);
-			};
+		size_t Tell() const noexcept
+		{
+			return offset;
+		}
+	public:
 
-			auto deserializer2 = [&, idHash, id](ValueMapping& value, LoadBlobArchiveContext& ctx)
+
+		LoadMappedArchiveContext(const char* path) : file { path }
+		{
+			if (!file.IsOpen() || file.size() < sizeof(PointerTableHeader))
+				return;
+
+			PointerTableHeader pointerHeader;
+			Read(&pointerHeader, sizeof(pointerHeader));
+
+			if (!CheckRead(pointerHeader.size, sizeof(PointerValue)))
+				return;
+
+			pointerValues	= file.data() + offset;
+			pointerCount	= pointerHeader.size;
+
+			offset += sizeof(PointerValue) * pointerHeader.size;
+		}
+
+
+		~LoadMappedArchiveContext() = default;
+
+
+		LoadMappedArchiveContext              (const LoadMappedArchiveContext&) = delete;
+		LoadMappedArchiveContext& operator =  (const LoadMappedArchiveContext&) = delete;
+
+		LoadMappedArchiveContext              (LoadMappedArchiveContext&&) = delete;
+		LoadMappedArchiveContext& operator =  (LoadMappedArchiveContext&&) = delete;
+
+		static consteval bool Loading() noexcept { return true; }
+
+		bool IsOpen() const noexcept { return pointerValues != nullptr; }
+		bool Failed() const noexcept { return failed; }
+
+		template<typename TY>
+		requires TrivialCopy<TY, LoadMappedArchiveContext>
+		void _Deserialize(TY& value)
+		{
+			Read(&value, sizeof(TY));
+		}
+
+		template<typename ... TY_Types>
+		void _Deserialize(std::variant<TY_Types...>& variant)
+		{
+			size_t i = -1;
+			Read(&i, sizeof(i));
+
+			if (i == std::variant_npos)
+				return;
+
+			if (i < sizeof...(TY_Types))
+				VariantDeserializationHelper<TY_Types...>::Construct(
+					*this, variant, i);
+			else
+				failed = true;
+		}
+
+		template<typename TY>
+		requires(SerializableValue<TY, LoadMappedArchiveContext>)
+		void _Deserialize(TY& value)
+		{
+			Serialize(*this, value);
+		}
+
+
+		void _Deserialize(std::string& value)
+		{
+			StringHeader header;
+			Read(&header, sizeof(header));
+
+			if (!CheckRead(header.stringSize))
+				return;
+
+			value.assign((const char*)file.data() + offset, header.stringSize);
+			offset += header.stringSize;
+		}
+
+
+		void _Deserialize(SerializableInterfacePointer auto& value)
+		{
+			value._Serialize(*this);
+		}
+
+
+		template<typename TY>
+		requires(SerializableStruct<TY, LoadMappedArchiveContext> && !SerializableInterfacePointer<TY>)
+		void _Deserialize(TY& value)
+		{
+			value.Serialize(*this);
+		}
+
+
+		template<typename TY_Key, typename TY_Value>
+		void _Deserialize(std::map<TY_Key, TY_Value>& value_map)
+		{
+			using namespace SerializeableUtilities;
+
+			MapHeader header{};
+			Read(&header, sizeof(header));
+
+			for (size_t I = 0; I < header.size && !failed; I++)
+			{
+				TY_Key      key;
+				TY_Value    value;
+
+				_Deserialize(key);
+				_Deserialize(value);
+
+				value_map[key] = std::move(value);
+			}
+		}
+
+
+		template<typename TY>
+		void DeserializeValue(TY& value)
+		{
+			using namespace SerializeableUtilities;
+
+			_Deserialize(value);
+		}
+
+
+		template<typename TY>
+		void DeserializeValue(std::vector<TY>& vector)
+		{
+			const auto& typeID = typeid(TY).hash_code();
+
+			VectorHeader header = { 0, 0 };
+			Read(&header, sizeof(header));
+
+			if (typeID != header.type)
+			{
+				failed = true;
+				return;
+			}
+
+			if constexpr (TrivialCopy<TY, LoadMappedArchiveContext> && !is_serializable_ptr<TY>)
+			{	// Elements are written back to back, one copy for the whole array
+				if (!CheckRead(header.size, sizeof(TY)))
+					return;
+
+				vector.resize(header.size);
+				Read(vector.data(), sizeof(TY) * header.size);
+			}
+			else
+			{
+				// Every element takes at least a byte, bounds the reserve on corrupt sizes
+				if (!CheckRead(header.size))
+					return;
+
+				vector.reserve(header.size);
+
+				for (size_t I = 0; I < header.size && !failed; I++)
+				{
+					TY value;
+
+					if constexpr (is_serializable_ptr<TY>)
+					{
+						if (value == nullptr)
+							value = std::make_shared<typename SerializeableUtilities::is_serializable_ptr<TY>::type>();
+
+						DeserializePointer(value);
+					}
+					else
+						DeserializeValue(value);
+
+					vector.emplace_back(std::move(value));
+				}
+			}
+		}
+
+
+		// Zero copy read of an array written as a std::vector of trivially copyable values.
+		// Unaligned arrays are copied into storage owned by the context.
+		template<typename TY>
+		requires TrivialCopy<TY, LoadMappedArchiveContext>
+		void DeserializeView(std::span<const TY>& view)
+		{
+			VectorHeader header = { 0, 0 };
+			Read(&header, sizeof(header));
+
+			view = {};
+
+			if (typeid(TY).hash_code() != header.type)
+			{
+				failed = true;
+				return;
+			}
+
+			if (!CheckRead(header.size, sizeof(TY)))
+				return;
+
+			const std::byte* begin = file.data() + offset;
+			offset += sizeof(TY) * header.size;
+
+			if (reinterpret_cast<uintptr_t>(begin) % alignof(TY) == 0)
+				view = { reinterpret_cast<const TY*>(begin), header.size };
+			else
+			{
+				auto& buffer = ownedBuffers.emplace_back(new std::byte[sizeof(TY) * header.size]);
+				memcpy(buffer.get(), begin, sizeof(TY) * header.size);
+
+				view = { reinterpret_cast<const TY*>(buffer.get()), header.size };
+			}
+		}
+
+
+		template<template<typename ... > typename Ptr_Ty, typename TY>
+		void DeserializePointer(std::shared_ptr<TY>& value) requires std::is_base_of_v<FlexKit::SerializableInterfaceBase, TY> && is_serializable_ptr<Ptr_Ty<TY>>
+		{
+			using namespace SerializeableUtilities;
+
+			PointerHeader header;
+			Read(&header, sizeof(header));
+
+			if (header.pointerID == 0)
+				return;
+
+			auto mapping = FindPointer(header.pointerID);
+			if (!mapping)
+			{
+				failed = true;
+				return;
+			}
+
+			if (mapping->_ptr.has_value())
+			{
+				value = std::any_cast<std::shared_ptr<TY>>(mapping->_ptr);
+			}
+			else
+			{
+				auto temp = Tell();
+
+				Seek(mapping->offset);
+
+				TypeID_t typeID;
+				Read(&typeID, sizeof(typeID));
+
+				if (typeID != header.typeID)
+				{
+					failed = true;
+					Seek(temp);
+					return;
+				}
+
+				auto newValue = FlexKit::SerializableBase::Construct(typeID);
+				newValue->_Serialize(*this);
+
+				value = std::shared_ptr<TY>(dynamic_cast<TY*>(newValue));
+
+				mapping->_ptr = value;
+
+				Seek(temp);
+			}
+		}
+
+
+		template<template<typename ... > typename Ptr_Ty, typename TY>
+		void DeserializePointer(Ptr_Ty<TY>& value) requires is_serializable_ptr<Ptr_Ty<TY>>
+		{
+			using namespace SerializeableUtilities;
+
+			uint64_t pointerValue[2];
+			Read(pointerValue, sizeof(pointerValue));
+
+			if (pointerValue[1] == 0)
+				return;
+
+			auto mapping = FindPointer(pointerValue[1]);
+			if (!mapping)
+			{
+				failed = true;
+				return;
+			}
+
+			if (mapping->_ptr.has_value())
+			{
+				value = std::any_cast<Ptr_Ty<TY>>(mapping->_ptr);
+			}
+			else
+			{
+				auto temp = Tell();
+
+				Seek(mapping->offset);
+
+				if (value == nullptr)
+					value = Ptr_Ty<TY>{ new TY };
+
+				mapping->_ptr = value;
+
+				_Deserialize(*value);
+
+				Seek(temp);
+			}
+		}
+
+		void MappedValue(uint64_t ID, auto& value)
+		{
+			if (auto mapping = FindPointer(ID); mapping)
+			{
+				const auto currentOffset = Tell();
+
+				Seek(mapping->offset);
+
+				(*this)& value;
+
+				Seek(currentOffset);
+			}
+		}
+
+		template<typename TY>
+		void operator & (TY& rhs)
+		{
+			if constexpr (is_serializable_ptr<TY>)
+			{
+				DeserializePointer(rhs);
+			}
+			else
+				DeserializeValue(rhs);
+		}
+
+
+		template<typename TY>
+		void operator & (std::span<const TY>& rhs)
+		{
+			DeserializeView(rhs);
+		}
+
+
+		void operator & (RawBuffer&& rhs)
+		{
+			Read(&rhs.size, sizeof(rhs.size));
+
+			if (!rhs.size)
+				return;
+
+			if(rhs.size >= 4096)
+			{
+				size_t compressedSize;
+				Read(&compressedSize, sizeof(compressedSize));
+
+				if (!CheckRead(compressedSize))
+				{
+					rhs._ptr = nullptr;
+					rhs.size = 0;
+					return;
+				}
+
+				void* compressed = const_cast<std::byte*>(file.data() + offset);
+				offset += compressedSize;
+
+				auto decompressed = DecompressBuffer(RawBuffer{ ._ptr = compressed, .size = compressedSize }, rhs.size);
+
+				rhs._ptr = decompressed.value_or(nullptr);
+				rhs.size = decompressed ? rhs.size : 0;
+			}
+			else
+			{
+				if (!CheckRead(rhs.size))
+				{
+					rhs._ptr = nullptr;
+					rhs.size = 0;
+					return;
+				}
+
+				rhs._ptr = malloc(rhs.size);
+
+				Read(rhs._ptr, rhs.size);
+			}
+		}
+
+
+		void operator & (RawBufferView&& rhs)
+		{
+			Read(&rhs.size, sizeof(rhs.size));
+
+			if (!rhs.size)
+			{
+				rhs._ptr = nullptr;
+				return;
+			}
+
+			if(rhs.size >= 4096)
+			{	// Compressed, decompress into a buffer owned by the context
+				size_t compressedSize;
+				Read(&compressedSize, sizeof(compressedSize));
+
+				if (!CheckRead(compressedSize))
+				{
+					rhs._ptr = nullptr;
+					rhs.size = 0;
+					return;
+				}
+
+				void* compressed = const_cast<std::byte*>(file.data() + offset);
+				offset += compressedSize;
+
+				auto decompressed = DecompressBuffer(RawBuffer{ ._ptr = compressed, .size = compressedSize }, rhs.size);
+
+				if (decompressed)
+				{
+					decompressedBuffers.emplace_back(decompressed.value());
+					rhs._ptr = decompressed.value();
+				}
+				else
+				{
+					rhs._ptr = nullptr;
+					rhs.size = 0;
+				}
+			}
+			else
+			{
+				if (!CheckRead(rhs.size))
+				{
+					rhs._ptr = nullptr;
+					rhs.size = 0;
+					return;
+				}
+
+				rhs._ptr = file.data() + offset;
+				offset += rhs.size;
+			}
+		}
+
+	private:
+		struct PointerMapping
+		{
+			uint64_t    offset  = 0;
+			std::any    _ptr;
+		};
+
+
+		PointerMapping* FindPointer(const uint64_t ID)
+		{
+			if (pointerTable.empty() && pointerCount)
+			{
+				pointerTable.reserve(pointerCount);
+
+				for (size_t I = 0; I < pointerCount; I++)
+				{
+					PointerValue e;
+					memcpy(&e, pointerValues + I * sizeof(PointerValue), sizeof(e));
+
+					pointerTable[e.ID] = { e.offset };
+				}
+			}
+
+			if (auto res = pointerTable.find(ID); res != pointerTable.end())
+				return &res->second;
+			else
+				return nullptr;
+		}
+
+
+		struct FreeDeleter
+		{
+			void operator () (void* _ptr) const noexcept { free(_ptr); }
+		};
+
+		MappedFile											file;
+		const std::byte*									pointerValues	= nullptr;
+		size_t												pointerCount	= 0;
+		std::unordered_map<uint64_t, PointerMapping>		pointerTable;
+
+		std::vector<std::unique_ptr<std::byte[]>>			ownedBuffers;
+		std::vector<std::unique_ptr<void, FreeDeleter>>		decompressedBuffers;
+
+		size_t	offset = 0;
+		bool	failed = false;
+	};
+
+
+
+	template<class Archive, typename T, size_t Size>
+	void Serialize(Archive& ar, FlexKit::static_vector<T, Size>& vector)
+	{
+		if (ar.Loading())
+		{
+			size_t S = 0;
+			ar& S;
+			vector.resize(S);
+		}
+		else
+		{
+			size_t S = vector.size();
+			ar& S;
+		}
+
+		for (auto& element : vector)
+			ar& element;
+	}
+
+
+	/************************************************************************************************/
+
+
+	struct ValueStore
+	{
+		struct ValueMapping
+		{
+			using Deserializer	= std::function<void(ValueMapping&, LoadFileArchiveContext&)>;
+			using Deserializer2	= std::function<void(ValueMapping&, LoadBlobArchiveContext&)>;
+			using Deserializer3	= std::function<void(ValueMapping&, LoadMappedArchiveContext&)>;
+			using Serializer	= std::function<void(ValueMapping&, SaveArchiveContext&)>;
+
+			uint64_t							id;
+			uint64_t							blobId;
+
+			Deserializer	deserializer;
+			Deserializer2	deserializer2;
+			Deserializer3	deserializer3;
+			Serializer		serializer;
+
+			void Serialize(auto& ar)
+			{
+				ar& id;
+				ar& blobId;
+			}
+		};
+
+		void Bind(std::string_view id, auto& rhs)
+		{
+			const auto idHash		= std::hash<std::string_view>{}(id);
+			const uint64_t blobId	= rand();
+
+			auto deserializer = [&, idHash, id](ValueMapping& value, LoadFileArchiveContext& ctx)
+			{
+				ctx.MappedValue(value.blobId, rhs);
+			};
+
+			auto deserializer2 = [&, idHash, id](ValueMapping& value, LoadBlobArchiveContext& ctx)
+			{
+				ctx.MappedValue(value.blobId, rhs);
+			};
+
+			auto deserializer3 = [&, idHash, id](ValueMapping& value, LoadMappedArchiveContext& ctx)
 			{
 				ctx.MappedValue(value.blobId, rhs);
 			};
@@ -1442,6 +2301,7 @@ namespace FlexKit
 			value.blobId		= blobId;
 			value.deserializer = deserializer;
 			value.deserializer2	= deserializer2;
+			value.deserializer3	= deserializer3;
 			value.serializer	= serializer;
 
 			mappings.push_back(value);
@@ -1463,6 +2323,8 @@ namespace FlexKit
 							mapping.deserializer(*res, ar);
 						if constexpr (std::is_same_v<decltype(ar), LoadBlobArchiveContext>)
 							mapping.deserializer2(*res, ar);
+						if constexpr (std::is_same_v<decltype(ar), LoadMappedArchiveContext>)
+							mapping.deserializer3(*res, ar);
 					}
 				}
 			}
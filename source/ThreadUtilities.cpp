@@ -4,8 +4,15 @@
 #include "..\pch.h"
 #include "timeutilities.h"
 #include "ThreadUtilities.h"
+#include "Logging.h"
 #include <atomic>
 #include <chrono>
+#include <immintrin.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 using std::mutex;
 
@@ -13,29 +20,60 @@ namespace FlexKit
 {   /************************************************************************************************/
 
 
-	thread_local CircularStealingQueue<iWork*>* localWorkQueue  = nullptr;
+	thread_local PriorityWorkQueue*             localWorkQueue  = nullptr;
 	thread_local _WorkerThread*                 _localThread    = nullptr;
 	thread_local iAllocator*                    _localAllocator = nullptr;
+	thread_local SchedulerCounters*             _localCounters  = nullptr; // Only set on the manager's threads
 
 
 	FLEXKITAPI void PushToLocalQueue(iWork& work)
 	{
+		// Threads outside of the pool have no local queue, ex. a resumed coroutine's barrier completing
+		// on a foreign thread. Their work is handed to one of the workers instead
+		if (!localWorkQueue)
+		{
+			if (WorkerThread::Manager)
+				WorkerThread::Manager->_PushToWorkerInbox(work);
+
+			return;
+		}
+
 		localWorkQueue->push_back(&work);
+
+		if (_localCounters)
+			SchedulerCounters::Max(_localCounters->maxQueueDepth, localWorkQueue->size());
+
+		if (WorkerThread::Manager)
+			WorkerThread::Manager->WakeWorker();
 	}
 
 
-	FLEXKITAPI CircularStealingQueue<iWork*>& _GetThreadLocalQueue()
+	FLEXKITAPI PriorityWorkQueue& _GetThreadLocalQueue()
 	{
 		return *localWorkQueue;
 	}
 
 
-	FLEXKITAPI void _SetThreadLocalQueue(CircularStealingQueue<iWork*>& localQueue)
+	FLEXKITAPI void _SetThreadLocalQueue(PriorityWorkQueue& localQueue)
 	{
 		localWorkQueue = &localQueue;
 	}
 
 
+	// Tasks run outside of the manager's threads aren't counted
+	FLEXKITAPI void _RecordTaskStats(const WorkPriority priority, const uint64_t ticks) noexcept
+	{
+		if (!_localCounters)
+			return;
+
+		const auto idx = Min((size_t)priority, (size_t)WorkPriority::Count - 1);
+
+		SchedulerCounters::Add(_localCounters->tasksExecuted, 1);
+		SchedulerCounters::Add(_localCounters->priorityTaskCount[idx], 1);
+		SchedulerCounters::Add(_localCounters->priorityTaskTicks[idx], ticks);
+	}
+
+
 	FLEXKITAPI _WorkerThread& GetLocalThread()
 	{
 		return *_localThread;
@@ -47,18 +85,23 @@ namespace FlexKit
 
 	bool _WorkerThread::AddItem(iWork* Work) noexcept
 	{
-		std::unique_lock lock{ exclusive };
-
-		workCount++;
-
 		if (Quit)
 			return false;
 
-		workQueue.push_back(Work);
+		workCount++;
+
+		// Lock free push onto the inbox, the owning thread moves it into workQueue
+		auto head = inbox.load(std::memory_order_relaxed);
+		do
+		{
+			Work->_inboxNext = head;
+		} while (!inbox.compare_exchange_weak(head, Work, std::memory_order_release, std::memory_order_relaxed));
 
 		if (!Running)
 			CV.notify_all();
 
+		TryUnpark();
+
 		return true;
 	}
 
@@ -66,10 +109,83 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	void _WorkerThread::_DrainInbox()
+	{
+		auto work = inbox.exchange(nullptr, std::memory_order_acquire);
+
+		// Inbox is LIFO, reverse to keep submission order
+		iWork* reversed = nullptr;
+		while (work)
+		{
+			auto next			= work->_inboxNext;
+			work->_inboxNext	= reversed;
+			reversed			= work;
+			work				= next;
+		}
+
+		while (reversed)
+		{
+			auto next				= reversed->_inboxNext;
+			reversed->_inboxNext	= nullptr;
+
+			workQueue.push_back(reversed);
+			reversed = next;
+		}
+
+		SchedulerCounters::Max(counters.maxQueueDepth, workQueue.size());
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool _WorkerThread::PinToCore(const size_t core) noexcept
+	{
+#ifdef _WIN32
+		// Affinity masks only cover 64 cores, larger machines split cores into processor groups.
+		// Groups aren't guaranteed to be full, walk them to find the one holding core
+		const WORD	groupCount	= GetActiveProcessorGroupCount();
+		size_t		index		= core;
+		WORD		group		= 0;
+
+		for (; group < groupCount; ++group)
+		{
+			const DWORD groupSize = GetActiveProcessorCount(group);
+
+			if (index < groupSize)
+				break;
+
+			index -= groupSize;
+		}
+
+		if (group == groupCount)
+			return false;
+
+		GROUP_AFFINITY affinity = {};
+		affinity.Group	= group;
+		affinity.Mask	= KAFFINITY(1) << index;
+
+		return SetThreadGroupAffinity(Thread.native_handle(), &affinity, nullptr) != 0;
+#else
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(core, &cpuSet);
+
+		return pthread_setaffinity_np(Thread.native_handle(), sizeof(cpuSet), &cpuSet) == 0;
+#endif
+	}
+
+
+	/************************************************************************************************/
+
+
 	void _WorkerThread::Shutdown() noexcept
 	{
 		Quit = true;
 		CV.notify_all();
+
+		wakeSignal.fetch_add(1, std::memory_order_release);
+		wakeSignal.notify_all();
 	}
 
 
@@ -84,46 +200,123 @@ namespace FlexKit
 			Running.store(false);
 		});
 
+		uint32_t idleCount = 0;
+
 		while (true)
 		{
-			for(size_t I = 0; I < 10; I++)
+			if (HasInboxWork())
+				_DrainInbox();
+
+			Manager->IncrementActiveWorkerCount();
+
+			if (auto workItem = Manager->FindWork(!Quit); workItem)
 			{
-				EXITSCOPE({
-					Manager->DecrementActiveWorkerCount();
-					});
-
-					Manager->IncrementActiveWorkerCount();
-
-					if (auto workItem = Manager->FindWork(!Quit); workItem)
-					{
-						I = 0;
-						hasJob.store(true, std::memory_order_release);
-
-						RunTask(*workItem);
-
-						hasJob.store(false, std::memory_order_release);
-					}
-					else if(I > 1) // Reduce thread contention a little
-					{
-						const auto begin = __rdtsc();
-
-						while (true)
-						{
-							const auto current	= __rdtsc();
-							const auto duration = current - begin;
-
-							if (duration >= 4000)
-								break;
-						}
-					}
+				idleCount = 0;
+				hasJob.store(true, std::memory_order_release);
+
+				RunTask(*workItem);
+
+				hasJob.store(false, std::memory_order_release);
+				Manager->DecrementActiveWorkerCount();
+
+				continue;
 			}
 
-			Manager->WaitForWork();
+			Manager->DecrementActiveWorkerCount();
 
 			if (Quit && localWorkQueue->size() == 0)
 				return;
+
+			_Idle(idleCount++);
 		}
+	}
+
+
+	/************************************************************************************************/
+
+
+	inline void SpinPause(const uint32_t count) noexcept
+	{
+		for (uint32_t I = 0; I < count; ++I)
+			_mm_pause();
+	}
+
+
+	void _WorkerThread::_Idle(const uint32_t idleCount)
+	{
+		const auto idleBegin		= std::chrono::high_resolution_clock::now();
+		std::atomic_uint64_t* timer	= &counters.spinTime;
+
+		switch (Manager->GetIdlePolicy())
+		{
+		case WorkerIdlePolicy::Spin:
+			SpinPause(64);
+			break;
+		case WorkerIdlePolicy::Backoff:
+		{
+			if (idleCount < 10)
+				SpinPause(1u << idleCount);
+			else if (idleCount < 20)
+			{
+				timer = &counters.idleTime;
+				std::this_thread::yield();
+			}
+			else
+			{
+				timer = &counters.idleTime;
+				std::this_thread::sleep_for(microseconds{ 50 << Min(idleCount - 20, 5u) });
+			}
+		}	break;
+		case WorkerIdlePolicy::Park:
+		{
+			if (idleCount < 8)
+				SpinPause(1u << idleCount);
+			else
+			{
+				timer = &counters.parkedTime;
+				_Park();
+			}
+		}	break;
+		}
+
+		SchedulerCounters::Add(*timer, std::chrono::duration_cast<nanoseconds>(std::chrono::high_resolution_clock::now() - idleBegin).count());
+	}
+
+
+	/************************************************************************************************/
+
+
+	void _WorkerThread::_Park()
+	{
+		ProfileFunction();
+
+		const auto signal = wakeSignal.load(std::memory_order_acquire);
 
+		parked.store(true, std::memory_order_seq_cst);
+		Manager->_OnWorkerParked();
+
+		// Recheck after publishing the parked state, a push racing with this will either be seen here or will wake us
+		if (!Quit && !Manager->HasPendingWork())
+			wakeSignal.wait(signal, std::memory_order_acquire);
+
+		parked.store(false, std::memory_order_release);
+		Manager->_OnWorkerUnparked();
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool _WorkerThread::TryUnpark() noexcept
+	{
+		bool expected = true;
+		if (!parked.compare_exchange_strong(expected, false, std::memory_order_acq_rel))
+			return false;
+
+		wakeSignal.fetch_add(1, std::memory_order_release);
+		wakeSignal.notify_one();
+
+		return true;
 	}
 
 
@@ -145,21 +338,29 @@ namespace FlexKit
 	void _WorkerThread::Wake() noexcept
 	{
 		CV.notify_all();
+		TryUnpark();
 	}
 
 
 	/************************************************************************************************/
 
 
-	void _WorkerThread::Start() noexcept
+	void _WorkerThread::Start(const size_t workerIdx) noexcept
 	{
 		Thread = std::move(
-			std::thread([&]
+			std::thread([&, workerIdx]
 				{
 					localWorkQueue  = &workQueue;
 					_localThread    = this;
+					_localCounters  = &counters;
+
+					char name[32];
+					snprintf(name, sizeof(name), "Worker %zu", workerIdx);
+					tracer.SetThreadName(name);
 
 					_Run();
+
+					BlockAllocator::ReleaseThreadCaches();
 				}));
 	}
 
@@ -178,11 +379,13 @@ namespace FlexKit
 
 	iWork* _WorkerThread::Steal() noexcept
 	{
-
 		iWork* work = nullptr;
-		localWorkQueue->Steal(work);
 
-		return work;
+		for (auto priority : { WorkPriority::Critical, WorkPriority::Normal, WorkPriority::Background })
+			if (workQueue.Steal(priority, work))
+				return work;
+
+		return nullptr;
 	}
 
 
@@ -199,7 +402,11 @@ namespace FlexKit
 				localWorkQueue = &queue;
 				running = true;
 
+				tracer.SetThreadName("Background Worker");
+
 				Run();
+
+				BlockAllocator::ReleaseThreadCaches();
 			} };
 	}
 
@@ -245,7 +452,7 @@ namespace FlexKit
 	}
 
 
-	CircularStealingQueue<iWork*>& _BackgrounWorkQueue::GetQueue()
+	PriorityWorkQueue& _BackgrounWorkQueue::GetQueue()
 	{
 		return queue;
 	}
@@ -287,7 +494,7 @@ namespace FlexKit
 		work.Subscribe(
 			[&]
 			{
-				tasksInProgress.fetch_sub(1, std::memory_order::memory_order_seq_cst);
+				OnTaskComplete();
 			});
 	}
 
@@ -303,7 +510,7 @@ namespace FlexKit
 		barrier.AddOnCompletionEvent(
 			[&]
 			{
-				tasksInProgress.fetch_sub(1, std::memory_order::memory_order_seq_cst);
+				OnTaskComplete();
 			});
 	}
 
@@ -311,6 +518,27 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	void WorkBarrier::OnTaskComplete()
+	{
+		// Only touch the barrier after the decrement when a suspended awaiter keeps it alive
+		if (tasksInProgress.fetch_sub(1, std::memory_order::memory_order_seq_cst) == (AwaitingFlag | 1))
+			_ResumeAwaiting();
+	}
+
+
+	/************************************************************************************************/
+
+
+	void WorkBarrier::_ResumeAwaiting()
+	{
+		if (auto work = awaitingWork.exchange(nullptr, std::memory_order_acq_rel); work)
+			work->_Resume();
+	}
+
+
+	/************************************************************************************************/
+
+
 	void WorkBarrier::AddOnCompletionEvent(OnCompletionEvent Callback)
 	{
 		PostEvents.emplace_back(std::move(Callback));
@@ -373,7 +601,7 @@ namespace FlexKit
 
 		while(tasksInProgress.load(std::memory_order::acquire))
 		{
-			ProfileFunctionLabeled(Joined);
+			TraceScope(Joined);
 
 			auto work = localWorkQueue->pop_back().value_or(nullptr);
 			if (work)
@@ -393,6 +621,7 @@ namespace FlexKit
 		tasksInProgress	= 0;
 		tasksScheduled	= 0;
 		joined			= false;
+		awaitingWork	= nullptr;
 	}
 
 
@@ -414,11 +643,22 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
-	ThreadManager::ThreadManager(const size_t threadCount, iAllocator* IN_allocator) :
+	static size_t ResolveWorkerCount(const size_t threadCount) noexcept
+	{
+		if (threadCount != ThreadManager::AutoThreadCount)
+			return threadCount;
+
+		const size_t hardwareThreads = std::thread::hardware_concurrency();
+
+		return Max(hardwareThreads, 2) - 1;
+	}
+
+
+	ThreadManager::ThreadManager(const size_t threadCount, iAllocator* IN_allocator, const bool pinWorkers) :
 		threads				{ },
-		allocator			{ IN_allocator		},
-		workingThreadCount	{ 0					},
-		workerCount			{ threadCount		},
+		allocator			{ IN_allocator							},
+		workingThreadCount	{ 0										},
+		workerCount			{ ResolveWorkerCount(threadCount)		},
 		workQueues			{ IN_allocator		},
 		mainThreadQueue		{ IN_allocator		},
 		backgroundQueue		{ IN_allocator		}
@@ -428,6 +668,9 @@ namespace FlexKit
 		WorkerThread::Manager = this;
 		_SetThreadLocalQueue(mainThreadQueue);
 		workQueues.push_back(&mainThreadQueue);
+		_localCounters = &mainThreadCounters;
+
+		tracer.SetThreadName("Main Thread");
 
 		buffer = std::make_unique<std::array<byte, MEGABYTE * 16>>();
 		localAllocator.Init(buffer->data(), MEGABYTE * 16);
@@ -440,8 +683,22 @@ namespace FlexKit
 			workQueues.push_back(&thread.GetQueue());
 		}
 
+		size_t workerIdx = 0;
 		for (auto& thread : threads)
-			thread.Start();
+			thread.Start(workerIdx++);
+
+		if (pinWorkers)
+		{
+			// Core 0 is left to the main thread
+			const size_t coreCount	= Max(std::thread::hardware_concurrency(), 1u);
+			size_t core				= 1;
+
+			for (auto& thread : threads)
+			{
+				if (!thread.PinToCore(core++ % coreCount))
+					FK_LOG_WARNING("Failed to pin worker thread to core!");
+			}
+		}
 	}
 
 
@@ -483,8 +740,41 @@ namespace FlexKit
 	void ThreadManager::AddWork(iWork* newWork) noexcept
 	{
 		PushToLocalQueue(*newWork);
+	}
+
+
+	/************************************************************************************************/
+
+
+	void ThreadManager::_PushToWorkerInbox(iWork& work) noexcept
+	{
+		// A parked worker starts on it right away, a busy one only drains its inbox between tasks
+		if (parkedWorkerCount.load(std::memory_order_acquire) > 0)
+		{
+			for (auto& thread : threads)
+				if (thread.IsParked() && thread.AddItem(&work))
+					return;
+		}
+
+		const size_t start = nextInbox.fetch_add(1, std::memory_order_relaxed);
+
+		for (size_t I = 0; I < workerCount; ++I)
+		{
+			size_t idx = (start + I) % workerCount;
+
+			for (auto& thread : threads)
+			{
+				if (idx-- == 0)
+				{
+					if (thread.AddItem(&work))
+						return;
+
+					break;
+				}
+			}
+		}
 
-		workerWait.notify_one();
+		FK_LOG_ERROR("ThreadManager::AddWork: no running worker to take work from an outside thread!");
 	}
 
 
@@ -493,7 +783,10 @@ namespace FlexKit
 
 	void ThreadManager::AddBackgroundWork(iWork& newWork) noexcept
 	{
+		newWork.SetPriority(WorkPriority::Background);
+
 		backgroundQueue.PushWork(newWork);
+		WakeWorker();
 	}
 
 
@@ -567,29 +860,88 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	void ThreadManager::WakeWorker() noexcept
+	{
+		// Pairs with the seq_cst parked store in _WorkerThread::_Park
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (parkedWorkerCount.load(std::memory_order_seq_cst) == 0)
+			return;
+
+		for (auto& thread : threads)
+			if (thread.TryUnpark())
+				return;
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool ThreadManager::HasPendingWork() noexcept
+	{
+		for (auto queue : workQueues)
+			if (queue->HasWork())
+				return true;
+
+		for (auto& thread : threads)
+			if (thread.HasInboxWork())
+				return true;
+
+		return backgroundQueue.GetQueue().HasWork();
+	}
+
+
+	/************************************************************************************************/
+
+
 	iWork* ThreadManager::FindWork(bool stealBackground)
 	{
 		auto& localWorkQueue = _GetThreadLocalQueue();
 
-		if (auto res = localWorkQueue.pop_back(); res)
-			return res.value();
+		// Per thread xorshift for victim selection, a shared engine is a contention point on wide machines
+		thread_local uint64_t stealState = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
 
-		thread_local static const size_t startingPoint = randomDevice();
+		stealState ^= stealState << 13;
+		stealState ^= stealState >> 7;
+		stealState ^= stealState << 17;
 
-		for (size_t I = 0; I < workQueues.size(); ++I)
+		const size_t startingPoint = stealState;
+
+		// Highest priority first, local queue before stealing. Background work is only taken
+		// once no worker has foreground work left
+		for (auto priority : { WorkPriority::Critical, WorkPriority::Normal, WorkPriority::Background })
 		{
-			const size_t idx = (I + startingPoint) % workQueues.size();
+			if (auto res = localWorkQueue.pop_back(priority); res)
+				return res.value();
 
-			iWork* work = nullptr;
+			for (size_t I = 0; I < workQueues.size(); ++I)
+			{
+				const size_t idx = (I + startingPoint) % workQueues.size();
 
-			if (auto res = workQueues[idx]->Steal(work); res)
-				return work;
+				if (!workQueues[idx]->HasWork(priority))
+					continue;
+
+				TraceScope(Steal);
+
+				iWork* work = nullptr;
+
+				if (_localCounters)
+					SchedulerCounters::Add(_localCounters->stealsAttempted, 1);
+
+				if (auto res = workQueues[idx]->Steal(priority, work); res)
+				{
+					if (_localCounters)
+						SchedulerCounters::Add(_localCounters->stealsSucceeded, 1);
+
+					return work;
+				}
+			}
 		}
 
 		if (stealBackground)
 		{
 			iWork* work = nullptr;
-			backgroundQueue.GetQueue().Steal(work);
+			backgroundQueue.GetQueue().Steal(WorkPriority::Background, work);
 			return work;
 		}
 		else
@@ -600,6 +952,132 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	ThreadManager::PriorityStats ThreadManager::GetPriorityStats() const noexcept
+	{
+		uint64_t taskTicks[(size_t)WorkPriority::Count] = { 0 };
+		PriorityStats stats;
+
+		auto Accumulate = [&](const SchedulerCounters& counters)
+		{
+			for (size_t I = 0; I < (size_t)WorkPriority::Count; ++I)
+			{
+				stats.taskCount[I]	+= counters.priorityTaskCount[I].load(std::memory_order_relaxed);
+				taskTicks[I]		+= counters.priorityTaskTicks[I].load(std::memory_order_relaxed);
+			}
+		};
+
+		Accumulate(mainThreadCounters);
+
+		for (auto& thread : threads)
+			Accumulate(thread.GetCounters());
+
+		const double elapsedNS		= (double)std::chrono::duration_cast<nanoseconds>(std::chrono::steady_clock::now() - createdTime).count();
+		const double ticksPerNS		= elapsedNS > 0.0 ? double(ReadTraceTimestamp() - createdTicks) / elapsedNS : 1.0;
+
+		for (size_t I = 0; I < (size_t)WorkPriority::Count; ++I)
+			stats.taskTime[I] = nanoseconds{ (int64_t)(double(taskTicks[I]) / ticksPerNS) };
+
+		return stats;
+	}
+
+
+	/************************************************************************************************/
+
+
+	void ThreadManager::ResetPriorityStats() noexcept
+	{
+		auto Reset = [](SchedulerCounters& counters)
+		{
+			for (size_t I = 0; I < (size_t)WorkPriority::Count; ++I)
+			{
+				counters.priorityTaskCount[I].store(0, std::memory_order_relaxed);
+				counters.priorityTaskTicks[I].store(0, std::memory_order_relaxed);
+			}
+		};
+
+		Reset(mainThreadCounters);
+
+		for (auto& thread : threads)
+			Reset(thread.GetCounters());
+	}
+
+
+	/************************************************************************************************/
+
+
+	void ThreadManager::_RecordGraph(const GraphStats& graphStats) noexcept
+	{
+		std::scoped_lock lock{ exclusive };
+
+		lastGraph = graphStats;
+		graphCount++;
+
+		if (graphStats.executeTime > slowestGraph.executeTime)
+			slowestGraph = graphStats;
+	}
+
+
+	/************************************************************************************************/
+
+
+	ThreadManager::SchedulerStats ThreadManager::GetSchedulerStats() const noexcept
+	{
+		SchedulerStats stats;
+		stats.priorities = GetPriorityStats();
+
+		auto ReadCounters = [](const SchedulerCounters& counters)
+		{
+			return WorkerStats{
+				.tasksExecuted		= counters.tasksExecuted.load(std::memory_order_relaxed),
+				.stealsAttempted	= counters.stealsAttempted.load(std::memory_order_relaxed),
+				.stealsSucceeded	= counters.stealsSucceeded.load(std::memory_order_relaxed),
+				.maxQueueDepth		= counters.maxQueueDepth.load(std::memory_order_relaxed),
+				.spinTime			= nanoseconds{ counters.spinTime.load(std::memory_order_relaxed) },
+				.idleTime			= nanoseconds{ counters.idleTime.load(std::memory_order_relaxed) },
+				.parkedTime			= nanoseconds{ counters.parkedTime.load(std::memory_order_relaxed) },
+			};
+		};
+
+		stats.workers.reserve(workerCount + 1);
+		stats.workers.push_back(ReadCounters(mainThreadCounters));
+
+		for (auto& thread : threads)
+			stats.workers.push_back(ReadCounters(thread.GetCounters()));
+
+		std::scoped_lock lock{ exclusive };
+
+		stats.lastGraph		= lastGraph;
+		stats.slowestGraph	= slowestGraph;
+		stats.graphCount	= graphCount;
+
+		return stats;
+	}
+
+
+	/************************************************************************************************/
+
+
+	// Counters are owned by their threads, a reset racing with an update may be lost
+	void ThreadManager::ResetSchedulerStats() noexcept
+	{
+		ResetPriorityStats();
+
+		mainThreadCounters.Reset();
+
+		for (auto& thread : threads)
+			thread.GetCounters().Reset();
+
+		std::scoped_lock lock{ exclusive };
+
+		lastGraph		= {};
+		slowestGraph	= {};
+		graphCount		= 0;
+	}
+
+
+	/************************************************************************************************/
+
+
 	size_t ThreadManager::GetThreadCount() const noexcept
 	{
 		return workerCount;
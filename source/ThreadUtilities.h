@@ -37,6 +37,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <array>
 #include <atomic>
+#include <coroutine>
 #include <memory>
 #include <mutex>
 #include <numeric>
@@ -46,8 +47,6 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <thread>
 #include <utility>
 
-#define MAXTHREADCOUNT 8
-
 
 namespace FlexKit
 {
@@ -60,6 +59,9 @@ namespace FlexKit
 	using namespace std::chrono_literals;
 
 	class ThreadManager;
+	class iWork;
+
+	FLEXKITAPI extern void PushToLocalQueue(iWork& work);
 
 
 	/************************************************************************************************/
@@ -71,6 +73,18 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	enum class WorkPriority : uint8_t
+	{
+		Critical,	// On the frame's longest dependency chain, picked before anything else
+		Normal,
+		Background,	// IO and streaming, only runs on otherwise idle workers
+		Count
+	};
+
+
+	/************************************************************************************************/
+
+
 	class iWork
 	{
 	public:
@@ -86,12 +100,44 @@ namespace FlexKit
 
 		void DoWork(iAllocator& threadLocalAllocator)
 		{
-			Run(threadLocalAllocator);
+			if (_coroutine)
+				_coroutine.resume();
+			else
+				Run(threadLocalAllocator);
+
+			if (_coroutine)
+			{
+				if (!_coroutine.done())
+				{	// Suspended on a co_await, requeued once the awaited barrier completes
+					_Resume();
+					return;
+				}
+
+				_coroutine.destroy();
+				_coroutine = nullptr;
+			}
+
 			completed = true;
 
 			ReleaseAndNotifyWatchers();
 		}
 
+
+		// Called by awaiters when a WorkCoroutine running inside this work suspends
+		void _SuspendOn(std::coroutine_handle<> coroutine) noexcept
+		{
+			_coroutine = coroutine;
+			_resumeGate.store(2, std::memory_order_release);
+		}
+
+
+		// Requeues a suspended work item, needs to be called by both the awaited event and DoWork returning
+		void _Resume() noexcept
+		{
+			if (_resumeGate.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				PushToLocalQueue(*this);
+		}
+
 		template<typename TY_Callable>
 		void Subscribe(TY_Callable&& subscriber)
 		{
@@ -104,7 +150,11 @@ namespace FlexKit
 
 		operator iWork* () { return this; }
 
+		void			SetPriority(const WorkPriority IN_priority) noexcept	{ priority = IN_priority; }
+		WorkPriority	GetPriority() const noexcept							{ return priority; }
+
 		const char*         _debugID;
+		iWork*              _inboxNext = nullptr; // Used by _WorkerThread::AddItem
 
 	protected:
 		virtual void Run(iAllocator& threadLocalAllocatoDDr) { FK_ASSERT(0); }
@@ -122,7 +172,63 @@ namespace FlexKit
 
 	private:
 		static_vector<OnCompletionEvent, 8>	subscribers;
-		std::atomic_bool					completed = false;
+		std::atomic_bool					completed	= false;
+		WorkPriority						priority	= WorkPriority::Normal;
+		std::coroutine_handle<>				_coroutine	= nullptr;
+		std::atomic_int						_resumeGate	= 0;
+	};
+
+
+	/************************************************************************************************/
+
+
+	inline thread_local iWork* _currentWork = nullptr;
+
+	inline iWork* _GetCurrentWork() noexcept { return _currentWork; }
+
+
+	// Return type for coroutine tasks, ex. a work item's Run or an UpdateDispatcher update function.
+	// When one co_awaits a WorkBarrier the enclosing work item suspends and its worker is free to run other tasks,
+	// the work item is requeued once the barrier completes and only then notifies its subscribers.
+	// The thread local allocator passed to Run is cleared while suspended, don't hold on to it across a co_await.
+	// The coroutine should be the last thing a work item runs, and WorkCoroutines shouldn't call each other.
+	class WorkCoroutine
+	{
+	public:
+		struct promise_type
+		{
+			bool adopted = false; // Ownership moved to a suspended iWork
+
+			WorkCoroutine get_return_object() noexcept
+			{
+				return WorkCoroutine{ std::coroutine_handle<promise_type>::from_promise(*this) };
+			}
+
+			std::suspend_never	initial_suspend()	noexcept { return {}; }
+			std::suspend_always	final_suspend()		noexcept { return {}; }
+
+			void return_void() noexcept {}
+			void unhandled_exception() { std::terminate(); }
+		};
+
+
+		WorkCoroutine(WorkCoroutine&& rhs) noexcept :
+			handle{ std::exchange(rhs.handle, nullptr) } {}
+
+		~WorkCoroutine()
+		{
+			if (handle && !handle.promise().adopted)
+				handle.destroy();
+		}
+
+		WorkCoroutine(const WorkCoroutine&)				= delete;
+		WorkCoroutine& operator = (const WorkCoroutine&)	= delete;
+
+	private:
+		explicit WorkCoroutine(std::coroutine_handle<promise_type> IN_handle) noexcept :
+			handle{ IN_handle } {}
+
+		std::coroutine_handle<promise_type> handle;
 	};
 
 
@@ -288,6 +394,13 @@ namespace FlexKit
 		}
 
 
+		// Safe to call from any thread, size() can underflow while a pop_back is in flight
+		bool HasWork() const noexcept
+		{
+			return backCounter.load(std::memory_order_acquire) > frontCounter.load(std::memory_order_acquire);
+		}
+
+
 		size_t size() const noexcept
 		{
 			return (size_t)(backCounter - frontCounter);
@@ -347,6 +460,157 @@ namespace FlexKit
 	class _WorkerThread;
 
 
+	/************************************************************************************************/
+
+
+	// One stealing deque per priority level, pushes are routed by the work item's priority
+	class PriorityWorkQueue
+	{
+	public:
+		PriorityWorkQueue(iAllocator* IN_allocator) noexcept :
+			critical	{ IN_allocator },
+			normal		{ IN_allocator },
+			background	{ IN_allocator } {}
+
+
+		void push_back(iWork* work) noexcept
+		{
+			GetQueue(work->GetPriority()).push_back(work);
+		}
+
+
+		[[nodiscard]] std::optional<iWork*> pop_back(const WorkPriority priority) noexcept
+		{
+			return GetQueue(priority).pop_back();
+		}
+
+
+		[[nodiscard]] std::optional<iWork*> pop_back() noexcept
+		{
+			for (auto priority : { WorkPriority::Critical, WorkPriority::Normal, WorkPriority::Background })
+				if (auto res = pop_back(priority); res)
+					return res;
+
+			return {};
+		}
+
+
+		bool Steal(const WorkPriority priority, iWork*& out) noexcept
+		{
+			return GetQueue(priority).Steal(out);
+		}
+
+
+		bool HasWork() const noexcept
+		{
+			return critical.HasWork() || normal.HasWork() || background.HasWork();
+		}
+
+
+		bool HasWork(const WorkPriority priority) const noexcept
+		{
+			return GetQueue(priority).HasWork();
+		}
+
+
+		bool empty() const noexcept
+		{
+			return critical.empty() && normal.empty() && background.empty();
+		}
+
+
+		size_t size() const noexcept
+		{
+			return critical.size() + normal.size() + background.size();
+		}
+
+
+		void Release()
+		{
+			critical.Release();
+			normal.Release();
+			background.Release();
+		}
+
+
+		CircularStealingQueue<iWork*>& GetQueue(const WorkPriority priority) noexcept
+		{
+			switch (priority)
+			{
+			case WorkPriority::Critical:	return critical;
+			case WorkPriority::Background:	return background;
+			default:						return normal;
+			}
+		}
+
+
+		const CircularStealingQueue<iWork*>& GetQueue(const WorkPriority priority) const noexcept
+		{
+			return const_cast<PriorityWorkQueue*>(this)->GetQueue(priority);
+		}
+
+	private:
+		CircularStealingQueue<iWork*>	critical;
+		CircularStealingQueue<iWork*>	normal;
+		CircularStealingQueue<iWork*>	background;
+	};
+
+
+	/************************************************************************************************/
+
+
+	// How workers wait when they fail to find work
+	enum class WorkerIdlePolicy : uint8_t
+	{
+		Spin,		// Spin with pause, lowest wake latency, burns the core
+		Backoff,	// Exponential spin, then yield, then short sleeps
+		Park,		// Brief spin, then sleep until a new task wakes this worker
+	};
+
+
+
+	// Per thread scheduler counters. Only the owning thread writes, so updates are plain load/store pairs
+	// instead of locked RMWs. Readers on other threads see slightly stale values.
+	struct alignas(64) SchedulerCounters
+	{
+		std::atomic_uint64_t	tasksExecuted	= 0;
+		std::atomic_uint64_t	stealsAttempted	= 0; // Steals tried on a queue that had work
+		std::atomic_uint64_t	stealsSucceeded	= 0;
+		std::atomic_uint64_t	spinTime		= 0; // ns
+		std::atomic_uint64_t	idleTime		= 0; // ns, yields and sleeps
+		std::atomic_uint64_t	parkedTime		= 0; // ns
+		std::atomic_uint64_t	maxQueueDepth	= 0;
+
+		std::atomic_uint64_t	priorityTaskCount[(size_t)WorkPriority::Count]	= {};
+		std::atomic_uint64_t	priorityTaskTicks[(size_t)WorkPriority::Count]	= {}; // ReadTraceTimestamp ticks
+
+		static void Add(std::atomic_uint64_t& counter, const uint64_t value) noexcept
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		static void Max(std::atomic_uint64_t& counter, const uint64_t value) noexcept
+		{
+			if (value > counter.load(std::memory_order_relaxed))
+				counter.store(value, std::memory_order_relaxed);
+		}
+
+		void Reset() noexcept
+		{
+			for (auto counter : { &tasksExecuted, &stealsAttempted, &stealsSucceeded, &spinTime, &idleTime, &parkedTime, &maxQueueDepth })
+				counter->store(0, std::memory_order_relaxed);
+
+			for (size_t I = 0; I < (size_t)WorkPriority::Count; ++I)
+			{
+				priorityTaskCount[I].store(0, std::memory_order_relaxed);
+				priorityTaskTicks[I].store(0, std::memory_order_relaxed);
+			}
+		}
+	};
+
+
+	/************************************************************************************************/
+
 
 	class _BackgrounWorkQueue
 	{
@@ -358,7 +622,7 @@ namespace FlexKit
 		void PushWork(iWork& work);
 
 		void                            Run();
-		CircularStealingQueue<iWork*>&  GetQueue();
+		PriorityWorkQueue&              GetQueue();
 		bool                            Running();
 
 	private:
@@ -370,7 +634,7 @@ namespace FlexKit
 		std::condition_variable         cv;
 		std::thread                     backgroundThread;
 
-		CircularStealingQueue<iWork*>   queue;
+		PriorityWorkQueue               queue;
 	};
 
 
@@ -395,7 +659,7 @@ namespace FlexKit
 		void Shutdown()	noexcept;
 		void Wake()		noexcept;
 
-		void Start() noexcept;
+		void Start(const size_t workerIdx) noexcept;
 
 		bool IsRunning()	noexcept;
 		bool HasJob()		noexcept;
@@ -404,14 +668,28 @@ namespace FlexKit
 		bool	AddItem(iWork* Work)	noexcept;
 		iWork*	Steal()					noexcept;
 
+		bool	IsParked()		const noexcept { return parked.load(std::memory_order_acquire); }
+		bool	TryUnpark()		noexcept;
+
+		bool	HasInboxWork()	const noexcept { return inbox.load(std::memory_order_acquire) != nullptr; }
+		bool	PinToCore(const size_t core) noexcept;
+
 		auto&   GetQueue() { return workQueue; }
 
+		SchedulerCounters&			GetCounters()		noexcept { return counters; }
+		const SchedulerCounters&	GetCounters() const	noexcept { return counters; }
+
 		static ThreadManager*	Manager;
 
 	private:
 		void _Run();
+		void _Idle(const uint32_t idleCount);
+		void _Park();
+		void _DrainInbox();
 
 		std::condition_variable	CV;
+		std::atomic_bool		parked		= false;
+		std::atomic_uint32_t	wakeSignal	= 0;
 		std::atomic_bool		Running;
 		std::atomic_bool		hasJob;
 		std::atomic_bool		Quit;
@@ -419,19 +697,20 @@ namespace FlexKit
 
 		iAllocator*				Allocator;
 
-		std::mutex					    exclusive;
-		CircularStealingQueue<iWork*>   workQueue;
+		std::atomic<iWork*>			    inbox = nullptr; // Work pushed by other threads, only the owner may push to workQueue
+		PriorityWorkQueue               workQueue;
 		std::thread					    Thread;
+		SchedulerCounters				counters;
 	};
 
 
 	/************************************************************************************************/
 
 
-	FLEXKITAPI extern void PushToLocalQueue(iWork& work);
+	FLEXKITAPI PriorityWorkQueue&    _GetThreadLocalQueue();
+	FLEXKITAPI void                  _SetThreadLocalQueue(PriorityWorkQueue& localQueue);
 
-	FLEXKITAPI CircularStealingQueue<iWork*>&    _GetThreadLocalQueue();
-	FLEXKITAPI void                              _SetThreadLocalQueue(CircularStealingQueue<iWork*>& localQueue);
+	FLEXKITAPI void _RecordTaskStats(const WorkPriority priority, const uint64_t ticks) noexcept;
 
 	FLEXKITAPI inline _WorkerThread&                    GetLocalThread();
 
@@ -452,7 +731,19 @@ namespace FlexKit
 			localAllocators.pop_back();
 		}
 
-		work.DoWork(*allocator);
+		const auto priority	= work.GetPriority();
+		const auto begin	= ReadTraceTimestamp();
+
+		auto previousWork	= std::exchange(_currentWork, &work);
+
+		{
+			TraceScope(Task);
+			work.DoWork(*allocator);
+		}
+
+		_currentWork		= previousWork;
+
+		_RecordTaskStats(priority, ReadTraceTimestamp() - begin);
 
 		allocator->clear();
 
@@ -484,7 +775,7 @@ namespace FlexKit
 
 		void Run(iAllocator& allocator) override
 		{
-			ProfileFunction();
+			TraceScope(Run);
 
 			Callback(allocator);
 		}
@@ -518,7 +809,10 @@ namespace FlexKit
 	class ThreadManager
 	{
 	public:
-		ThreadManager(const size_t ThreadCount = 2, iAllocator* IN_allocator = SystemAllocator);
+		// AutoThreadCount sizes the pool to the hardware, leaving a core for the calling thread
+		static constexpr size_t AutoThreadCount = 0;
+
+		ThreadManager(const size_t ThreadCount = AutoThreadCount, iAllocator* IN_allocator = SystemAllocator, const bool pinWorkers = false);
 		~ThreadManager() { Release(); }
 
 		void Release();
@@ -537,6 +831,61 @@ namespace FlexKit
 		void DecrementActiveWorkerCount() noexcept;
 
 		void WaitForWork() noexcept;
+		void WakeWorker() noexcept;
+
+		bool HasPendingWork() noexcept;
+
+		void				SetIdlePolicy(const WorkerIdlePolicy policy) noexcept	{ idlePolicy.store(policy, std::memory_order_relaxed); }
+		WorkerIdlePolicy	GetIdlePolicy() const noexcept							{ return idlePolicy.load(std::memory_order_relaxed); }
+
+		struct PriorityStats
+		{
+			uint64_t		taskCount[(size_t)WorkPriority::Count]	= { 0 };
+			nanoseconds		taskTime[(size_t)WorkPriority::Count]	= {};
+		};
+
+		PriorityStats	GetPriorityStats() const noexcept;
+		void			ResetPriorityStats() noexcept;
+
+		struct WorkerStats
+		{
+			uint64_t	tasksExecuted	= 0;
+			uint64_t	stealsAttempted	= 0;
+			uint64_t	stealsSucceeded	= 0;
+			uint64_t	maxQueueDepth	= 0;
+			nanoseconds	spinTime		= {};
+			nanoseconds	idleTime		= {};
+			nanoseconds	parkedTime		= {};
+		};
+
+		// Reported by UpdateDispatcher::Execute
+		struct GraphStats
+		{
+			size_t		taskCount			= 0;
+			size_t		criticalPathLength	= 0;
+			nanoseconds	criticalPathTime	= {};
+			nanoseconds	executeTime			= {};
+		};
+
+		struct SchedulerStats
+		{
+			std::vector<WorkerStats>	workers;		// workers[0] is the thread that created the manager
+			PriorityStats				priorities;
+			GraphStats					lastGraph;
+			GraphStats					slowestGraph;	// Longest executeTime since the last reset
+			uint64_t					graphCount = 0;
+		};
+
+		SchedulerStats	GetSchedulerStats() const noexcept;
+		void			ResetSchedulerStats() noexcept;
+
+		void _RecordGraph(const GraphStats& graphStats) noexcept;
+
+		// Work submitted from threads outside of the pool, they have no local queue to push to
+		void _PushToWorkerInbox(iWork& work) noexcept;
+
+		void _OnWorkerParked()		noexcept { parkedWorkerCount.fetch_add(1, std::memory_order_seq_cst); }
+		void _OnWorkerUnparked()	noexcept { parkedWorkerCount.fetch_sub(1, std::memory_order_seq_cst); }
 
 		iWork* FindWork(bool stealBackground = false);
 
@@ -552,15 +901,26 @@ namespace FlexKit
 		std::condition_variable		CV;
 		std::condition_variable		workerWait;
 		std::atomic_int				workingThreadCount;
-		std::default_random_engine	randomDevice;
+		std::atomic_int				parkedWorkerCount	= 0;
+		std::atomic_size_t			nextInbox			= 0;
+		std::atomic<WorkerIdlePolicy>	idlePolicy		= WorkerIdlePolicy::Park;
 
 		const size_t				workerCount;
 		iAllocator*					allocator;
-		std::mutex					exclusive;
+		mutable std::mutex			exclusive;
+
+		SchedulerCounters			mainThreadCounters;
+		GraphStats					lastGraph;
+		GraphStats					slowestGraph;
+		uint64_t					graphCount = 0;
 
-		CircularStealingQueue<iWork*>	mainThreadQueue;
+		// Task times are recorded in timestamp ticks, converted to nanoseconds against the clock when read
+		const uint64_t								createdTicks	= ReadTraceTimestamp();
+		const std::chrono::steady_clock::time_point	createdTime		= std::chrono::steady_clock::now();
 
-		Vector<CircularStealingQueue<iWork*>*>			workQueues;
+		PriorityWorkQueue				mainThreadQueue;
+
+		Vector<PriorityWorkQueue*>						workQueues;
 		StackAllocator									localAllocator;
 		std::unique_ptr<std::array<byte, MEGABYTE * 16>> buffer;
 	};
@@ -589,13 +949,75 @@ namespace FlexKit
 
 		void 	Reset();
 
+
+		// co_await from a WorkCoroutine suspends the calling work item instead of blocking its worker,
+		// outside of a work item this falls back to Join
+		struct Awaiter
+		{
+			WorkBarrier& barrier;
+
+			bool await_ready() const noexcept
+			{
+				return (barrier.tasksInProgress.load(std::memory_order_acquire) & ~AwaitingFlag) == 0;
+			}
+
+			bool await_suspend(std::coroutine_handle<WorkCoroutine::promise_type> coroutine)
+			{
+				auto work = _GetCurrentWork();
+				if (!work)
+				{
+					barrier.Join();
+					return false;
+				}
+
+				const bool alreadyAdopted = coroutine.promise().adopted;
+
+				coroutine.promise().adopted = true;
+				work->_SuspendOn(coroutine);
+
+				barrier.awaitingWork.store(work, std::memory_order_relaxed);
+
+				// The awaiting flag shares the counter so the last task knows to resume us without touching
+				// the barrier otherwise, a blocking joiner may destroy the barrier as soon as the count hits zero
+				const auto prev = barrier.tasksInProgress.fetch_add(AwaitingFlag, std::memory_order_acq_rel);
+				if ((prev & ~AwaitingFlag) == 0)
+				{	// Everything finished before we published, nobody else will resume us
+					barrier.tasksInProgress.fetch_sub(AwaitingFlag, std::memory_order_relaxed);
+
+					if (!alreadyAdopted)
+					{
+						work->_SuspendOn(nullptr);
+						coroutine.promise().adopted = false;
+					}
+
+					return false;
+				}
+
+				return true;
+			}
+
+			void await_resume()
+			{
+				barrier.tasksInProgress.fetch_and(~AwaitingFlag, std::memory_order_acq_rel);
+				barrier.joined.store(true, std::memory_order_release);
+				barrier.OnEnd();
+			}
+		};
+
+		Awaiter operator co_await () noexcept { return { *this }; }
+
 	private:
 
 		void OnEnd();
+		void OnTaskComplete();
+		void _ResumeAwaiting();
+
+		static constexpr int AwaitingFlag = 1 << 30;
 
 		std::atomic_int		tasksInProgress = 0;
 		std::atomic_int		tasksScheduled	= 0;
 		std::atomic_bool	joined			= false;
+		std::atomic<iWork*>	awaitingWork	= nullptr;
 
 		ThreadManager&				threads;
 		Vector<OnCompletionEvent>	PostEvents;
@@ -731,7 +1153,7 @@ namespace FlexKit
 
 			void Run(iAllocator& threadLocalAllocator) final
 			{
-				ProfileFunction();
+				TraceScope(Block);
 
 				for(auto I = begin; I < end; I++)
 					(*task_FN)(*I, threadLocalAllocator);
@@ -773,14 +1195,17 @@ namespace FlexKit
 	}
 
 
-		template<typename ITERATOR_TY, typename FN_TY>
-	void Parallel_For2(
+	// Schedules the blocks onto barrier and returns without waiting, task has to outlive the barrier.
+	// Used from a WorkCoroutine to co_await the barrier instead of blocking the worker.
+	template<typename ITERATOR_TY, typename FN_TY>
+	void Parallel_For2_Async(
 		ThreadManager&	threads,
 		iAllocator&		allocator,
 		ITERATOR_TY		begin,
 		ITERATOR_TY		end,
 		const size_t	blockSize,
-		FN_TY			task)
+		FN_TY&			task,
+		WorkBarrier&	barrier)
 	{
 		ProfileFunction();
 
@@ -813,7 +1238,7 @@ namespace FlexKit
 
 			void Run(iAllocator& threadLocalAllocator) final
 			{
-				ProfileFunction();
+				TraceScope(Block);
 
 				(*task_FN)(begin, end, dispatchID, threadLocalAllocator);
 			}
@@ -823,26 +1248,43 @@ namespace FlexKit
 			}
 		};
 
-		if (threadCount > 1)
+		Vector<Task*> tasks{&allocator, threadCount};
+
+		for (size_t I = 0; I < threadCount; ++I)
 		{
-			WorkBarrier barrier{threads, &allocator};
-			Vector<Task*> tasks{&allocator, threadCount};
+			auto workItem =
+				&allocator.allocate<Task>(
+					begin + I * blockSize,
+					begin + Min((I + 1) * blockSize, taskCount),
+					I,
+					&task);
+
+			tasks.emplace_back(workItem);
+			barrier.AddWork(*workItem);
+		}
 
-			for (size_t I = 0; I < threadCount; ++I)
-			{
-				auto workItem =
-					&allocator.allocate<Task>(
-						begin + I * blockSize,
-						begin + Min((I + 1) * blockSize, taskCount),
-						I,
-						&task);
+		for (auto& task : tasks)
+			threads.AddWork(task);
+	}
 
-				tasks.emplace_back(workItem);
-				barrier.AddWork(*workItem);
-			}
 
-			for (auto& task : tasks)
-				threads.AddWork(task);
+	template<typename ITERATOR_TY, typename FN_TY>
+	void Parallel_For2(
+		ThreadManager&	threads,
+		iAllocator&		allocator,
+		ITERATOR_TY		begin,
+		ITERATOR_TY		end,
+		const size_t	blockSize,
+		FN_TY			task)
+	{
+		ProfileFunction();
+
+		const size_t taskCount = std::distance(begin, end);
+
+		if (taskCount > blockSize)
+		{
+			WorkBarrier barrier{threads, &allocator};
+			Parallel_For2_Async(threads, allocator, begin, end, blockSize, task, barrier);
 
 			barrier.Join();
 		}
@@ -851,6 +1293,298 @@ namespace FlexKit
 	}
 
 
+	/************************************************************************************************/
+	// Adaptive parallel for, callers don't pick a block size.
+	// A probe at the front of the range is timed to estimate the per item cost, chunks are sized to run for
+	// about ParallelForTargetChunkTime. Ranges are split in halves lazily, only while fewer split ranges are
+	// waiting to be picked up than there are workers. Loops that are done within the probe or would only make
+	// a couple of chunks run inline without creating any tasks.
+
+	inline constexpr nanoseconds	ParallelForTargetChunkTime	= microseconds{ 50 };
+	inline constexpr nanoseconds	ParallelForProbeTime		= microseconds{ 2 };
+	inline constexpr size_t			ParallelForMaxTasksPerThread	= 32;
+	inline constexpr size_t			ParallelScanThreshold		= 4096;
+
+
+	template<typename ITERATOR_TY, typename FN_TY>
+	struct _ParallelForRangeContext
+	{
+		struct RangeTask : public iWork
+		{
+			RangeTask(_ParallelForRangeContext* IN_ctx, ITERATOR_TY IN_begin, ITERATOR_TY IN_end) :
+				iWork	{ nullptr	},
+				ctx		{ IN_ctx	},
+				begin	{ IN_begin	},
+				end		{ IN_end	} {}
+
+			void Run(iAllocator& threadLocalAllocator) final
+			{
+				TraceScope(Block);
+
+				ctx->pendingRanges.fetch_sub(1, std::memory_order_relaxed);
+				ctx->Process(begin, end, threadLocalAllocator);
+			}
+
+			void Release() final {}
+
+			_ParallelForRangeContext*	ctx;
+			ITERATOR_TY					begin;
+			ITERATOR_TY					end;
+		};
+
+
+		_ParallelForRangeContext(ThreadManager& IN_threads, iAllocator& IN_allocator, FN_TY& IN_task, const size_t IN_grain, const size_t maxTasks) :
+			threads		{ IN_threads								},
+			allocator	{ IN_allocator								},
+			task		{ IN_task									},
+			grain		{ IN_grain									},
+			threadCount	{ IN_threads.GetThreadCount()				},
+			poolSize	{ maxTasks									},
+			pool		{ (RangeTask*)IN_allocator._aligned_malloc(sizeof(RangeTask) * maxTasks, alignof(RangeTask)) },
+			barrier		{ IN_threads, &IN_allocator					}
+		{
+			if (!pool)
+				throw std::bad_alloc{};
+		}
+
+
+		~_ParallelForRangeContext()
+		{
+			const size_t createdTasks = Min(taskCounter.load(), poolSize);
+
+			for (size_t I = 0; I < createdTasks; ++I)
+				pool[I].~RangeTask();
+
+			allocator._aligned_free(pool);
+		}
+
+
+		void Process(ITERATOR_TY begin, ITERATOR_TY end, iAllocator& threadLocalAllocator)
+		{
+			while (begin != end)
+			{
+				const size_t size = std::distance(begin, end);
+
+				if (size >= 2 * grain && pendingRanges.load(std::memory_order_relaxed) < threadCount)
+				{
+					const auto mid = begin + size / 2;
+
+					if (Spawn(mid, end))
+					{
+						end = mid;
+						continue;
+					}
+				}
+
+				const auto chunkEnd = begin + Min(grain, size);
+				task(begin, chunkEnd, threadLocalAllocator);
+
+				begin = chunkEnd;
+			}
+		}
+
+
+		bool Spawn(ITERATOR_TY begin, ITERATOR_TY end)
+		{
+			const size_t idx = taskCounter.fetch_add(1, std::memory_order_relaxed);
+			if (idx >= poolSize)
+				return false;
+
+			auto rangeTask = new(pool + idx) RangeTask{ this, begin, end };
+
+			pendingRanges.fetch_add(1, std::memory_order_relaxed);
+			barrier.AddWork(*rangeTask);
+			PushToLocalQueue(*rangeTask);
+
+			return true;
+		}
+
+
+		ThreadManager&		threads;
+		iAllocator&			allocator;
+		FN_TY&				task;
+		const size_t		grain;
+		const size_t		threadCount;
+		const size_t		poolSize;
+		RangeTask*			pool;
+
+		std::atomic_size_t	taskCounter		= 0;
+		std::atomic_size_t	pendingRanges	= 0;
+
+		WorkBarrier			barrier;
+	};
+
+
+	// task is called as task(begin, end, iAllocator& threadLocal)
+	template<typename ITERATOR_TY, typename FN_TY>
+	void Parallel_ForRange(
+		ThreadManager&	threads,
+		iAllocator&		allocator,
+		ITERATOR_TY		begin,
+		ITERATOR_TY		end,
+		FN_TY			task)
+	{
+		ProfileFunction();
+
+		const size_t count = std::distance(begin, end);
+
+		// Probe with doubling chunks until enough time has passed for a usable estimate
+		size_t		processed	= 0;
+		size_t		probeSize	= 1;
+		nanoseconds	probeTime	= {};
+
+		while (processed < count && probeTime < ParallelForProbeTime)
+		{
+			const size_t size		= Min(probeSize, count - processed);
+			const auto probeBegin	= std::chrono::high_resolution_clock::now();
+
+			task(begin + processed, begin + processed + size, allocator);
+
+			probeTime	+= std::chrono::duration_cast<nanoseconds>(std::chrono::high_resolution_clock::now() - probeBegin);
+			processed	+= size;
+			probeSize	*= 2;
+		}
+
+		const size_t remaining = count - processed;
+		if (!remaining)
+			return;
+
+		const size_t perItem	= Max(size_t(probeTime.count()) / processed, 1);
+		const size_t grain		= Max(size_t(ParallelForTargetChunkTime.count()) / perItem, 1);
+
+		if (remaining <= 2 * grain || threads.GetThreadCount() == 0)
+		{
+			task(begin + processed, end, allocator);
+			return;
+		}
+
+		const size_t maxTasks = Min(remaining / grain + 1, threads.GetThreadCount() * ParallelForMaxTasksPerThread);
+
+		_ParallelForRangeContext<ITERATOR_TY, FN_TY> ctx{ threads, allocator, task, grain, maxTasks };
+
+		ctx.Process(begin + processed, end, allocator);
+		ctx.barrier.Join();
+	}
+
+
+	// Adaptive element wise Parallel_For, task is called as task(element, iAllocator& threadLocal)
+	template<typename ITERATOR_TY, typename FN_TY>
+	void Parallel_For(
+		ThreadManager&	threads,
+		iAllocator&		allocator,
+		ITERATOR_TY		begin,
+		ITERATOR_TY		end,
+		FN_TY			task)
+	{
+		Parallel_ForRange(
+			threads, allocator, begin, end,
+			[&](ITERATOR_TY rangeBegin, ITERATOR_TY rangeEnd, iAllocator& threadLocalAllocator)
+			{
+				for (auto I = rangeBegin; I < rangeEnd; I++)
+					task(*I, threadLocalAllocator);
+			});
+	}
+
+
+	// map is called as map(begin, end, iAllocator& threadLocal) -> TY, combine(TY, TY) -> TY
+	// Partial results are combined in the order chunks finish, combine needs to be associative and commutative
+	template<typename TY, typename ITERATOR_TY, typename FN_MAP, typename FN_COMBINE>
+	[[nodiscard]] TY Parallel_Reduce(
+		ThreadManager&	threads,
+		iAllocator&		allocator,
+		ITERATOR_TY		begin,
+		ITERATOR_TY		end,
+		TY				identity,
+		FN_MAP			map,
+		FN_COMBINE		combine)
+	{
+		ProfileFunction();
+
+		std::mutex	m;
+		TY			result = identity;
+
+		Parallel_ForRange(
+			threads, allocator, begin, end,
+			[&](ITERATOR_TY rangeBegin, ITERATOR_TY rangeEnd, iAllocator& threadLocalAllocator)
+			{
+				TY partial = map(rangeBegin, rangeEnd, threadLocalAllocator);
+
+				std::scoped_lock lock{ m };
+				result = combine(result, partial);
+			});
+
+		return result;
+	}
+
+
+	// Inclusive scan, out[I] = combine(in[0], ... in[I]). combine needs to be associative.
+	// Two passes over a fixed set of blocks, block sums are scanned serially in between.
+	template<typename ITERATOR_TY, typename OUT_ITERATOR_TY, typename TY, typename FN_COMBINE>
+	void Parallel_InclusiveScan(
+		ThreadManager&	threads,
+		iAllocator&		allocator,
+		ITERATOR_TY		begin,
+		ITERATOR_TY		end,
+		OUT_ITERATOR_TY	out,
+		TY				identity,
+		FN_COMBINE		combine)
+	{
+		ProfileFunction();
+
+		const size_t count		= std::distance(begin, end);
+		const size_t blockCount	= Min(count, (threads.GetThreadCount() + 1) * 4);
+
+		if (count < ParallelScanThreshold || blockCount < 2)
+		{
+			TY sum = identity;
+			for (auto itr = begin; itr != end; ++itr, ++out)
+			{
+				sum		= combine(sum, *itr);
+				*out	= sum;
+			}
+
+			return;
+		}
+
+		const size_t blockSize = (count + blockCount - 1) / blockCount;
+
+		Vector<TY> blockSums{ &allocator, blockCount, identity };
+
+		Parallel_For2(
+			threads, allocator, begin, end, blockSize,
+			[&](ITERATOR_TY rangeBegin, ITERATOR_TY rangeEnd, size_t blockID, iAllocator&)
+			{
+				TY sum = identity;
+				for (auto itr = rangeBegin; itr != rangeEnd; ++itr)
+					sum = combine(sum, *itr);
+
+				blockSums[blockID] = sum;
+			});
+
+		TY running = identity;
+		for (auto& blockSum : blockSums)
+		{
+			const TY sum	= blockSum;
+			blockSum		= running;
+			running			= combine(running, sum);
+		}
+
+		Parallel_For2(
+			threads, allocator, begin, end, blockSize,
+			[&](ITERATOR_TY rangeBegin, ITERATOR_TY rangeEnd, size_t blockID, iAllocator&)
+			{
+				TY		sum		= blockSums[blockID];
+				auto	output	= out + std::distance(begin, rangeBegin);
+
+				for (auto itr = rangeBegin; itr != rangeEnd; ++itr, ++output)
+				{
+					sum		= combine(sum, *itr);
+					*output	= sum;
+				}
+			});
+	}
+
+
 	/************************************************************************************************/
 }	// namespace FlexKit
 
@@ -12,7 +12,7 @@ namespace FlexKit
 
 	size_t CalculateNodeBufferSize(size_t BufferSize)
 	{
-		size_t PerNodeFootPrint = sizeof(LT_Entry) + sizeof(WT_Entry) + sizeof(Node) + sizeof(uint16_t);
+		size_t PerNodeFootPrint = sizeof(LT_Entry) + sizeof(WT_Entry) + sizeof(Node) + 2 * sizeof(uint32_t) + sizeof(char); // Handle index, parent index, flags
 		return (BufferSize - sizeof(SceneNodes)) / PerNodeFootPrint;
 	}
 
@@ -20,7 +20,7 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
-	inline uint16_t	_SNHandleToIndex(NodeHandle Node) 
+	inline uint32_t	_SNHandleToIndex(NodeHandle Node) 
 	{
 		if (Node == InvalidHandle)
 			return 0;
@@ -32,7 +32,7 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
-	inline void		_SNSetHandleIndex(NodeHandle Node, uint16_t index)
+	inline void		_SNSetHandleIndex(NodeHandle Node, uint32_t index)
 	{ 
 		SceneNodeTable.Indexes[Node] = index; 
 	}
@@ -47,13 +47,16 @@ namespace FlexKit
 		SceneNodeTable.LT       = { persistent, 2048 };
 		SceneNodeTable.WT       = { persistent, 2048 };
 		SceneNodeTable.Flags    = { persistent, 2048 };
-		SceneNodeTable.Children = { persistent, 2048 };
+
+		SceneNodeTable.ParentIndex	= { persistent, 2048 };
+		SceneNodeTable.LevelBegin	= { persistent, 32 };
+		SceneNodeTable.LevelFlags	= { persistent, 32 };
+		SceneNodeTable.movedWatched	= { persistent, 256 };
 
 		SceneNodeTable.Nodes.reserve(1024);
 		SceneNodeTable.LT.reserve(1024);
 		SceneNodeTable.WT.reserve(1024);
 		SceneNodeTable.Flags.reserve(1024);
-		SceneNodeTable.Children.reserve(1024);
 
 		SceneNodeTable.Indexes.Initiate( persistent );
 
@@ -137,8 +140,8 @@ namespace FlexKit
 
 					SceneNodeTable.Nodes[I];
 
-					SceneNodeTable.Indexes[NodeHandle(I)]   = (uint16_t)I;
-					SceneNodeTable.Indexes[NodeHandle(II)]  = (uint16_t)II;
+					SceneNodeTable.Indexes[NodeHandle(I)]   = (uint32_t)I;
+					SceneNodeTable.Indexes[NodeHandle(II)]  = (uint32_t)II;
 					//NewLength--;
 					int x = 0;
 				}
@@ -149,8 +152,8 @@ namespace FlexKit
 				if (ParentIndex > I)
 				{					
 					SwapNodeEntryies(ParentIndex, I);
-					SceneNodeTable.Indexes[NodeHandle(ParentIndex)]	= (uint16_t)I;
-					SceneNodeTable.Indexes[NodeHandle(I)]			= (uint16_t)ParentIndex;
+					SceneNodeTable.Indexes[NodeHandle(ParentIndex)]	= (uint32_t)I;
+					SceneNodeTable.Indexes[NodeHandle(I)]			= (uint32_t)ParentIndex;
 				}
 			}
 
@@ -209,6 +212,7 @@ namespace FlexKit
 
 		SceneNodeTable.Flags[_SNHandleToIndex(handle)] = SceneNodes::FREE;
 		SceneNodeTable.Nodes[_SNHandleToIndex(handle)].Parent = NodeHandle(-1);
+		SceneNodeTable.releasedCount++;
 		_SNSetHandleIndex(handle, -1);
 	}
 
@@ -231,15 +235,137 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	bool IsAncestorIndex(const size_t ancestorIdx, size_t idx)
+	{
+		auto& table = SceneNodeTable;
+
+		// Bounded by the node count so a corrupted chain can not hang the walk
+		for (size_t steps = 0; idx != 0 && steps < table.size(); ++steps)
+		{
+			if (idx == ancestorIdx)
+				return true;
+
+			NodeHandle parent = table.Nodes[idx].Parent;
+			if (parent == InvalidHandle)
+				return false;
+
+			idx = _SNHandleToIndex(parent);
+
+			if (idx >= table.size())
+				return false;
+		}
+
+		return idx == ancestorIdx;
+	}
+
+
+	/************************************************************************************************/
+
+
+	void MoveSubtreeToTail(const uint32_t subtreeRoot, const uint32_t newParent)
+	{
+		auto& table = SceneNodeTable;
+
+		constexpr uint32_t unmoved = (uint32_t)-1;
+
+		// Descendants of a laid out node can only live in deeper levels or in the tail
+		const uint32_t tailBegin	= (uint32_t)table._TailBegin();
+		const uint32_t tailEnd		= (uint32_t)table.size();
+		size_t         level		= table._LevelOf(subtreeRoot) + 1;
+		const uint32_t scanBegin	= table.LevelBegin[level];
+
+		Vector<uint32_t> moved{ table.Nodes.Allocator, tailBegin - scanBegin, unmoved };
+
+		auto Move =
+			[&](const uint32_t idx, const uint32_t parentIdx) -> uint32_t
+			{
+				const uint32_t newIdx = (uint32_t)table._AddNode();
+
+				table.Nodes[newIdx]			= table.Nodes[idx];
+				table.LT[newIdx]			= table.LT[idx];
+				table.WT[newIdx]			= table.WT[idx];
+				table.Flags[newIdx]			= table.Flags[idx];
+				table.ParentIndex[newIdx]	= parentIdx;
+
+				table.Indexes[table.Nodes[newIdx].handle] = newIdx;
+
+				// The old slot is left released and reclaimed by the next relayout
+				table.Flags[idx]		= SceneNodes::FREE;
+				table.Nodes[idx].Parent	= InvalidHandle;
+				table.releasedCount++;
+
+				return newIdx;
+			};
+
+		auto MovedTo =
+			[&](const uint32_t idx) -> uint32_t
+			{
+				if (idx == subtreeRoot)
+					return tailEnd;
+
+				return (idx >= scanBegin && idx < tailBegin) ? moved[idx - scanBegin] : unmoved;
+			};
+
+		Move(subtreeRoot, newParent);
+
+		// Levels are visited top down so parents are always appended before their children,
+		// the walk stops at the first level without any descendants.
+		for (bool levelMoved = true; levelMoved && level + 1 < table.LevelBegin.size(); ++level)
+		{
+			levelMoved = false;
+
+			for (uint32_t idx = table.LevelBegin[level]; idx < table.LevelBegin[level + 1]; ++idx)
+			{
+				const uint32_t parentTo = MovedTo(table.ParentIndex[idx]);
+
+				if (parentTo != unmoved && !(table.Flags[idx] & SceneNodes::FREE))
+				{
+					moved[idx - scanBegin]	= Move(idx, parentTo);
+					levelMoved				= true;
+				}
+			}
+		}
+
+		// Tail nodes stay where they are, only their parent links follow the move
+		for (uint32_t idx = tailBegin; idx < tailEnd; ++idx)
+		{
+			const uint32_t parentTo = MovedTo(table.ParentIndex[idx]);
+
+			if (parentTo != unmoved)
+				table.ParentIndex[idx] = parentTo;
+		}
+	}
+
+
+	/************************************************************************************************/
+
+
 	void SetParentNode(NodeHandle parent, NodeHandle node)
 	{
-		auto ParentIndex	= _SNHandleToIndex(parent);
-		auto ChildIndex		= _SNHandleToIndex(node);
+		auto& table = SceneNodeTable;
 
-		if (ChildIndex < ParentIndex)
-			SwapNodes(parent, node);
+		const uint32_t nodeIdx		= _SNHandleToIndex(node);
+		const uint32_t parentIdx	= _SNHandleToIndex(parent);
 
-		SceneNodeTable.Nodes[SceneNodeTable.Indexes[node]].Parent = parent;
+		if (IsAncestorIndex(nodeIdx, parentIdx))
+		{
+			FK_LOG_ERROR("SetParentNode: node %u is an ancestor of its new parent %u, parenting ignored", nodeIdx, parentIdx);
+			FK_ASSERT(false, "Parent cycle");
+			return;
+		}
+
+		table.Nodes[nodeIdx].Parent = parent;
+
+		// Patch the layout in place, a full relayout only happens when compacting
+		if (!table.layoutDirty)
+		{
+			if (nodeIdx >= table._TailBegin())
+				table.ParentIndex[nodeIdx] = parentIdx; // The tail pass orders itself
+			else if (table._LevelOf(parentIdx) + 1 == table._LevelOf(nodeIdx))
+				table.ParentIndex[nodeIdx] = parentIdx; // Depth is unchanged, node stays in its level
+			else
+				MoveSubtreeToTail(nodeIdx, parentIdx);
+		}
 
 		SetFlag(node, SceneNodes::DIRTY);
 	}
@@ -507,89 +633,364 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
-	bool UpdateTransforms()
+	void UpdateNodeLayout()
+	{
+		auto& table = SceneNodeTable;
+
+		if (!table.layoutDirty)
+			return;
+
+		ProfileFunction();
+
+		constexpr uint32_t unresolved	= (uint32_t)-1;
+		constexpr uint32_t released		= (uint32_t)-2;
+		constexpr uint32_t visiting		= (uint32_t)-3;
+
+		const size_t	nodeCount	= table.size();
+		iAllocator*		allocator	= table.Nodes.Allocator;
+
+		auto GetParent =
+			[&](const size_t idx) -> size_t
+			{
+				const size_t parentIdx = _SNHandleToIndex(table.Nodes[idx].Parent);
+				return (parentIdx < nodeCount && !(table.Flags[parentIdx] & SceneNodes::FREE)) ? parentIdx : 0;
+			};
+
+		// Resolve the depth of every live node, parents are not guaranteed to precede children
+		Vector<uint32_t> depth{ allocator, (uint32_t)nodeCount, unresolved };
+		Vector<uint32_t> stack{ allocator };
+
+		depth[0] = 0;
+		uint32_t maxDepth = 0;
+
+		for (size_t itr = 1; itr < nodeCount; ++itr)
+		{
+			if (table.Flags[itr] & SceneNodes::FREE)
+			{
+				depth[itr] = released;
+				continue;
+			}
+
+			size_t current = itr;
+			while (depth[current] == unresolved)
+			{
+				depth[current] = visiting;
+				stack.push_back((uint32_t)current);
+				current = GetParent(current);
+
+				if (depth[current] == visiting)
+				{
+					// Walked back into the chain being resolved, break the cycle at the root
+					FK_LOG_ERROR("UpdateNodeLayout: parent cycle at node %u, reattaching to root", stack.back());
+
+					table.Nodes[stack.back()].Parent = table.root;
+					current = 0;
+				}
+			}
+
+			uint32_t currentDepth = depth[current];
+			while (!stack.empty())
+				depth[stack.pop_back()] = ++currentDepth;
+
+			maxDepth = Max(maxDepth, depth[itr]);
+		}
+
+		// Counting sort by depth, released nodes are dropped from the table
+		const uint32_t levelCount = maxDepth + 1;
+
+		table.LevelBegin.clear();
+		table.LevelBegin.resize(levelCount + 1);
+		table.LevelFlags.clear();
+		table.LevelFlags.resize(levelCount);
+
+		for (size_t itr = 0; itr < nodeCount; ++itr)
+			if (depth[itr] != released)
+				table.LevelBegin[depth[itr] + 1]++;
+
+		for (uint32_t level = 1; level <= levelCount; ++level)
+			table.LevelBegin[level] += table.LevelBegin[level - 1];
+
+		const uint32_t		liveCount = table.LevelBegin.back();
+		Vector<uint32_t>	cursor{ table.LevelBegin };
+		Vector<uint32_t>	remap{ allocator, (uint32_t)nodeCount, released };
+		Vector<uint32_t>	order{ allocator, liveCount, 0u };
+
+		for (size_t itr = 0; itr < nodeCount; ++itr)
+		{
+			if (depth[itr] != released)
+			{
+				remap[itr]			= cursor[depth[itr]]++;
+				order[remap[itr]]	= (uint32_t)itr;
+
+				table.LevelFlags[depth[itr]] |= table.Flags[itr] & (SceneNodes::DIRTY | SceneNodes::UPDATED);
+			}
+		}
+
+		Vector<Node>			nodes		{ allocator, liveCount };
+		Vector<LT_Entry>		LT			{ allocator, liveCount };
+		Vector<WT_Entry>		WT			{ allocator, liveCount };
+		Vector<char>			flags		{ allocator, liveCount };
+		Vector<uint32_t>		parents		{ allocator, liveCount };
+
+		for (const auto idx : order)
+		{
+			nodes.push_back(table.Nodes[idx]);
+			LT.push_back(table.LT[idx]);
+			WT.push_back(table.WT[idx]);
+			flags.push_back(table.Flags[idx]);
+			parents.push_back(remap[GetParent(idx)]);
+		}
+
+		table.Nodes			= std::move(nodes);
+		table.LT			= std::move(LT);
+		table.WT			= std::move(WT);
+		table.Flags			= std::move(flags);
+		table.ParentIndex	= std::move(parents);
+
+		for (uint32_t itr = 0; itr < liveCount; ++itr)
+			table.Indexes[table.Nodes[itr].handle] = itr;
+
+		table.releasedCount	= 0;
+		table.layoutDirty	= false;
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool UpdateNodeRange(const size_t begin, const size_t end)
 	{
-		using DirectX::XMMatrixIdentity;
 		using DirectX::XMMatrixMultiply;
 		using DirectX::XMMatrixTranspose;
 		using DirectX::XMMatrixTranslationFromVector;
 		using DirectX::XMMatrixScalingFromVector;
 		using DirectX::XMMatrixRotationQuaternion;
 
-		SceneNodeTable.WT[0].SetToIdentity();// Making sure root is Identity 
-#if 0
-		for (size_t itr = 1; itr < Nodes->used; ++itr)// Skip Root
+		bool updated = false;
+
+		static_vector<NodeHandle, 64> moved;
+
+		auto FlushMoved =
+			[&]
+			{
+				std::scoped_lock lock{ SceneNodeTable.movedLock };
+
+				for (auto node : moved)
+					SceneNodeTable.movedWatched.push_back(node);
+
+				moved.clear();
+			};
+
+		for (size_t itr = begin; itr < end; ++itr)
 		{
-			if ( Nodes->Flags[itr]												| SceneNodes::DIRTY || 
-				 Nodes->Flags[_SNHandleToIndex(Nodes, Nodes->Nodes[itr].Parent)]| SceneNodes::DIRTY )
+			const auto flag = SceneNodeTable.Flags[itr];
+
+			if (flag & SceneNodes::FREE)
+				continue;
+
+			const auto parentIdx	= SceneNodeTable.ParentIndex[itr];
+			const auto parentFlag	= SceneNodeTable.Flags[parentIdx];
+			const auto scaleFlag	= flag & SceneNodes::SCALE;
+			const auto keptFlags	= flag & (SceneNodes::SCALE | SceneNodes::WATCHED);
+
+			if((flag & SceneNodes::DIRTY) || (parentFlag & SceneNodes::UPDATED))
 			{
-				Nodes->Flags[itr] = Nodes->Flags[itr] | SceneNodes::DIRTY; // To cause Further children to update
-				bool			  EnableScale = Nodes->Nodes[itr].Scaleflag;
-				FlexKit::WT_Entry Parent;
-				FlexKit::WT_Entry WOut;
-				FlexKit::LT_Entry LIn;
-
-				// Gather
-				GetTransform(Nodes, Nodes->Nodes[itr].Parent, &Parent);
-
-				WOut = Nodes->WT[itr];
-				LIn  = Nodes->LT[itr];
-
-				// Calculate
-				WOut.World.R = DirectX::XMQuaternionMultiply(LIn.R, Parent.World.R);
-				WOut.World.S = DirectX::XMVectorMultiply	(LIn.S, Parent.World.S);
-
-				LIn.T.m128_f32[3] = 0;// Should Always Be Zero
-				//if(EnableScale)	WOut.World.T = DirectX::XMVectorMultiply(Parent.World.S, LIn.T);
-				WOut.World.T = DirectX::XMQuaternionMultiply(DirectX::XMQuaternionConjugate(Parent.World.R), LIn.T);
-				WOut.World.T = DirectX::XMQuaternionMultiply(WOut.World.T, Parent.World.R);
-				WOut.World.T = DirectX::XMVectorAdd			(WOut.World.T, Parent.World.T);
-
-				// Write Results
-				Nodes->WT[itr] = WOut;
+				const LT_Entry& TRS = SceneNodeTable.LT[itr];
+
+				const auto LT =(XMMatrixRotationQuaternion(TRS.R) *
+								XMMatrixScalingFromVector(scaleFlag ? TRS.S : float3(1.0f, 1.0f, 1.0f).pfloats)) *
+								XMMatrixTranslationFromVector(TRS.T);
+
+				const auto PT = SceneNodeTable.WT[parentIdx].m4x4;
+
+				SceneNodeTable.WT[itr].m4x4	= XMMatrixTranspose(XMMatrixMultiply(LT, XMMatrixTranspose(PT)));
+				SceneNodeTable.Flags[itr]	= keptFlags | SceneNodes::UPDATED;
+
+				if (flag & SceneNodes::WATCHED)
+				{
+					moved.push_back(SceneNodeTable.Nodes[itr].handle);
+
+					if (moved.full())
+						FlushMoved();
+				}
+
+				updated = true;
 			}
+			else
+				SceneNodeTable.Flags[itr] = keptFlags;
 		}
-#else
 
-		SceneNodeTable.Flags[0] = SceneNodes::CLEAR;
+		if (moved.size())
+			FlushMoved();
+
+		return updated;
+	}
+
+
+	/************************************************************************************************/
+
 
-		size_t Unused_Nodes = 0;
-		for (size_t itr = 1; itr < SceneNodeTable.size(); ++itr)
+	void UpdateTail(iAllocator* allocator)
+	{
+		auto& table = SceneNodeTable;
+
+		const uint32_t tailBegin	= (uint32_t)table._TailBegin();
+		const uint32_t tailEnd		= (uint32_t)table.size();
+
+		// Appended nodes normally follow their parents already
+		bool ordered = true;
+		for (uint32_t idx = tailBegin; idx < tailEnd && ordered; ++idx)
+			ordered = table.ParentIndex[idx] < idx;
+
+		if (ordered)
 		{
-			const auto flag         = SceneNodeTable.Flags[itr];
-			const auto parentFlag   = SceneNodeTable.Flags[_SNHandleToIndex(SceneNodeTable.Nodes[itr].Parent)];
-			const auto scaleFlag    = flag & SceneNodes::SCALE;
+			UpdateNodeRange(tailBegin, tailEnd);
+			return;
+		}
 
+		// Otherwise order the tail by its depth below the laid out levels
+		constexpr uint32_t unresolved = (uint32_t)-1;
 
-			if((flag & SceneNodes::DIRTY) || (parentFlag & SceneNodes::UPDATED))
+		const uint32_t		tailSize = tailEnd - tailBegin;
+		Vector<uint32_t>	depth{ allocator, tailSize, unresolved };
+		Vector<uint32_t>	stack{ allocator };
+		uint32_t			maxDepth = 0;
+
+		for (uint32_t itr = 0; itr < tailSize; ++itr)
+		{
+			uint32_t current = itr;
+			while (depth[current] == unresolved)
 			{
-				DirectX::XMMATRIX LT = XMMatrixIdentity();
-				LT_Entry TRS = GetLocal(SceneNodeTable.Nodes[itr].handle);
+				const uint32_t parent = table.ParentIndex[tailBegin + current];
 
-				const auto newFlag          = scaleFlag | SceneNodes::UPDATED;
-				SceneNodeTable.Flags[itr]   = newFlag;
+				// Parented to a laid out node, the stack bound guards against a corrupted chain
+				if (parent < tailBegin || stack.size() >= tailSize)
+				{
+					depth[current] = 0;
+					break;
+				}
 
-				bool sf = (SceneNodeTable.Flags[itr] & SceneNodes::StateFlags::SCALE) != 0;
-				LT =(	XMMatrixRotationQuaternion(TRS.R) *
-						XMMatrixScalingFromVector(sf ? TRS.S : float3(1.0f, 1.0f, 1.0f).pfloats)) *
-						XMMatrixTranslationFromVector(TRS.T);
+				stack.push_back(current);
+				current = parent - tailBegin;
+			}
 
-				auto ParentIndex = _SNHandleToIndex(SceneNodeTable.Nodes[itr].Parent);
-				auto PT = SceneNodeTable.WT[ParentIndex].m4x4;
-				auto WT = XMMatrixTranspose(XMMatrixMultiply(LT, XMMatrixTranspose(PT)));
+			uint32_t currentDepth = depth[current];
+			while (!stack.empty())
+				depth[stack.pop_back()] = ++currentDepth;
 
-				auto temp						= SceneNodeTable.WT[itr].m4x4;
-				SceneNodeTable.WT[itr].m4x4	= WT;
+			maxDepth = Max(maxDepth, depth[itr]);
+		}
+
+		// Counting sort by depth, parents land before their children
+		Vector<uint32_t> cursor{ allocator, maxDepth + 2, 0u };
+
+		for (const auto d : depth)
+			cursor[d + 1]++;
+
+		for (uint32_t level = 1; level < cursor.size(); ++level)
+			cursor[level] += cursor[level - 1];
+
+		Vector<uint32_t> order{ allocator, tailSize, 0u };
+		for (uint32_t itr = 0; itr < tailSize; ++itr)
+			order[cursor[depth[itr]]++] = tailBegin + itr;
+
+		for (const auto idx : order)
+			UpdateNodeRange(idx, idx + 1);
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool _UpdateTransforms(ThreadManager* threads, iAllocator* allocator)
+	{
+		UpdateNodeLayout();
+
+		auto& table = SceneNodeTable;
+
+		table.WT[0].SetToIdentity();// Making sure root is Identity 
+		table.Flags[0] = SceneNodes::CLEAR;
+
+		// Keep accumulating until a consumer has taken the list, updating twice between two refits must not lose the first moves
+		if (table.movedConsumed.exchange(false) || table.movedWatched.size() > SceneNodes::MaxMovedWatched)
+		{
+			table.movedPreviousSize = table.movedWatched.size();
+			table.movedWatched.clear();
+			table.movedGeneration++;
+		}
+
+		constexpr size_t parallelThreshold = 2048;
+
+		// A level only needs visiting if it contains dirty nodes, the level above produced
+		// updates, or it has UPDATED flags left over from the previous pass to clear.
+		bool parentLevelUpdated = false;
+
+		for (size_t level = 1; level < table.LevelFlags.size(); ++level)
+		{
+			if (!parentLevelUpdated && !table.LevelFlags[level])
+				continue;
+
+			const size_t begin	= table.LevelBegin[level];
+			const size_t end	= table.LevelBegin[level + 1];
+
+			bool levelUpdated = false;
+
+			if (threads && end - begin >= parallelThreshold)
+			{
+				std::atomic_bool	anyUpdated	= false;
+				const size_t		blockSize	= Max((end - begin) / (threads->GetThreadCount() * 4), parallelThreshold / 4);
+				char*				flags		= table.Flags.data();
+
+				Parallel_For2(
+					*threads, *allocator,
+					flags + begin, flags + end,
+					blockSize,
+					[&](char* rangeBegin, char* rangeEnd, size_t, iAllocator&)
+					{
+						if (UpdateNodeRange(rangeBegin - flags, rangeEnd - flags))
+							anyUpdated.store(true, std::memory_order_relaxed);
+					});
+
+				levelUpdated = anyUpdated;
 			}
 			else
-				SceneNodeTable.Flags[itr] = scaleFlag;
+				levelUpdated = UpdateNodeRange(begin, end);
 
-			Unused_Nodes += (SceneNodeTable.Flags[itr] & SceneNodes::FREE);
+			table.LevelFlags[level]	= levelUpdated ? SceneNodes::UPDATED : SceneNodes::CLEAR;
+			parentLevelUpdated		= levelUpdated;
 		}
-#endif
 
-		SceneNodeTable.WT[0].SetToIdentity();// Making sure root is Identity 
-		return ((float(Unused_Nodes) / float(SceneNodeTable.size())) > 0.25f);
+		const size_t tailSize = table.size() - table._TailBegin();
+
+		if (tailSize)
+			UpdateTail(allocator ? allocator : table.Nodes.Allocator);
+
+		// Relayout on the next update once a quarter of the nodes have been released, or the
+		// serially updated tail has grown past an eighth of the table. Amortised over the adds
+		// and moves that grew it, this keeps the per node cost of a relayout constant.
+		const bool compact = table.releasedCount * 4 > table.size() || tailSize * 8 > table.size();
+		if (compact)
+			table.layoutDirty = true;
+
+		return compact;
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool UpdateTransforms()
+	{
+		return _UpdateTransforms(nullptr, nullptr);
+	}
+
+
+	/************************************************************************************************/
+
+
+	bool UpdateTransforms(ThreadManager& threads, iAllocator& allocator)
+	{
+		return _UpdateTransforms(&threads, &allocator);
 	}
 
 
@@ -891,7 +1292,11 @@ namespace FlexKit
 		FlexKit::SetWT(node, &WT);
 
 		SceneNodeTable.Nodes[_SNHandleToIndex(node)].Scaleflag  = false;
-		SceneNodeTable.Nodes[_SNHandleToIndex(node)].Parent     = NodeHandle(0);
+
+		if (node != SceneNodeTable.root && SceneNodeTable.root != InvalidHandle)
+			SetParentNode(SceneNodeTable.root, node);
+		else
+			SceneNodeTable.Nodes[_SNHandleToIndex(node)].Parent = NodeHandle(0);
 
 		return node;
 	}
@@ -913,6 +1318,9 @@ namespace FlexKit
 	{
 		auto index = _SNHandleToIndex(node);
 		SceneNodeTable.Flags[index] = SceneNodeTable.Flags[index] | f;
+
+		if (f & SceneNodes::DIRTY)
+			SceneNodeTable._MarkLevelDirty(index);
 	}
 
 
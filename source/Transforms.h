@@ -33,16 +33,16 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "TriggerComponent.h"
 #include "XMMathConversion.h"
 #include <DirectXMath/DirectXMath.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 
 namespace FlexKit
 {
-	typedef static_vector<NodeHandle, 32> ChildrenVector;
-
 	struct Node
 	{
 		NodeHandle	handle; //?
 		NodeHandle	Parent;
-		NodeHandle	ChildrenList;
 		bool		Scaleflag;// Calculates Scale only when set to on, Off By default
 	};
 
@@ -52,7 +52,6 @@ namespace FlexKit
 		DirectX::XMVECTOR T;
 		DirectX::XMVECTOR R;
 		DirectX::XMVECTOR S;
-		DirectX::XMVECTOR Padding;
 
 		static LT_Entry Zero()
 		{
@@ -87,16 +86,36 @@ namespace FlexKit
 			DIRTY   = 0x01,
 			FREE    = 0x02,
 			SCALE   = 0x04,
-			UPDATED = 0x08
+			UPDATED = 0x08,
+			WATCHED = 0x10, // Updates to this node are reported in movedWatched
 		};
 
 		Vector<Node>            Nodes;
 		Vector<LT_Entry>	    LT;
 		Vector<WT_Entry>        WT;
 		Vector<char>            Flags;
-		Vector<ChildrenVector>  Children;
+		Vector<uint32_t>        ParentIndex;
+
+		// Nodes are stored breadth first, depth level N occupies [LevelBegin[N], LevelBegin[N + 1]).
+		// Nodes added or moved since the last relayout are appended after LevelBegin.back(),
+		// that tail is updated serially until the next relayout folds it back into the levels.
+		Vector<uint32_t>        LevelBegin;
+		Vector<char>            LevelFlags;
+
+		// Watched nodes updated since a consumer last took them, lets consumers skip scanning every node.
+		// Accumulates across UpdateTransforms until a consumer marks it consumed, the next update after that
+		// starts a new generation. Consumers compare generations to detect entries cleared before they saw them.
+		Vector<NodeHandle>      movedWatched;
+		std::mutex              movedLock;
+		std::atomic_bool        movedConsumed       = false;
+		uint64_t                movedGeneration     = 0;
+		size_t                  movedPreviousSize   = 0;	// Size of movedWatched when the last generation ended
+
+		static constexpr size_t MaxMovedWatched     = 1 << 16;	// Unconsumed lists are dropped past this, consumers fall back to a full scan
 
 		NodeHandle  root;
+		bool        layoutDirty     = true;
+		size_t      releasedCount   = 0;
 
 		HandleUtilities::HandleTable<NodeHandle> Indexes;
 
@@ -111,7 +130,10 @@ namespace FlexKit
 			LT.Release();
 			WT.Release();
 			Flags.Release();
-			Children.Release();
+			ParentIndex.Release();
+			LevelBegin.Release();
+			LevelFlags.Release();
+			movedWatched.Release();
 			Indexes.Release();
 		}
 
@@ -121,13 +143,32 @@ namespace FlexKit
 			const auto idx1 = LT.emplace_back();
 			const auto idx2 = WT.emplace_back(WT_Entry{DirectX::XMMatrixIdentity()});
 			const auto idx3 = Flags.emplace_back();
-			const auto idx4 = Children.emplace_back();
+			const auto idx4 = ParentIndex.emplace_back(0u);
 
 			FK_ASSERT((idx0 == idx1) && (idx2 == idx3) && (idx1 == idx2) && (idx3 == idx4));
 
 			return idx0;
 		}
 
+		size_t _TailBegin() const
+		{
+			return LevelBegin.empty() ? 0 : LevelBegin.back();
+		}
+
+		// Returns LevelBegin.size() - 1 for nodes in the tail
+		size_t _LevelOf(const size_t index) const
+		{
+			return std::upper_bound(LevelBegin.begin(), LevelBegin.end(), (uint32_t)index) - LevelBegin.begin() - 1;
+		}
+
+		void _MarkLevelDirty(const size_t index)
+		{
+			if (layoutDirty || LevelBegin.empty() || index >= LevelBegin.back())
+				return;
+
+			LevelFlags[_LevelOf(index)] |= DIRTY;
+		}
+
 		size_t size() const { return Nodes.size(); }
 	}inline SceneNodeTable;
 
@@ -135,8 +176,8 @@ namespace FlexKit
 	/************************************************************************************************/
 	// TODO: add no except where applicable
 
-	FLEXKITAPI uint16_t	_SNHandleToIndex	(NodeHandle Node);
-	FLEXKITAPI void		_SNSetHandleIndex	(NodeHandle Node, uint16_t index);
+	FLEXKITAPI uint32_t	_SNHandleToIndex	(NodeHandle Node);
+	FLEXKITAPI void		_SNSetHandleIndex	(NodeHandle Node, uint32_t index);
 
 	FLEXKITAPI void			InitiateSceneNodeBuffer		( iAllocator* persistent );
 	FLEXKITAPI void			SortNodes					( StackAllocator* Temp );
@@ -179,7 +220,9 @@ namespace FlexKit
 	/************************************************************************************************/
 
 
+	FLEXKITAPI void		UpdateNodeLayout();
 	FLEXKITAPI bool		UpdateTransforms();
+	FLEXKITAPI bool		UpdateTransforms(ThreadManager& threads, iAllocator& allocator);
 
 
 	/************************************************************************************************/
@@ -236,13 +279,14 @@ namespace FlexKit
 			[&](auto& Builder, TransformUpdateData& Data)
 			{
 				Builder.SetDebugString("UpdateTransform");
+				Builder.Writes(TransformComponentID);
 			},
-			[](auto& Data, iAllocator& threadAllocator)
+			[threads = Dispatcher.threads](auto& Data, iAllocator& threadAllocator)
 			{
 				ProfileFunction();
 
 				FK_LOG_9("Transform Update");
-				UpdateTransforms();
+				UpdateTransforms(*threads, threadAllocator);
 			});
 
 		return TransformUpdate;
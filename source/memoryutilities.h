@@ -3,6 +3,7 @@
 #include "buildsettings.h"
 #include "Logging.h"
 #include <atomic>
+#include <bit>
 #include <memory>
 #include <mutex>
 #include <type_traits>
@@ -324,6 +325,75 @@ namespace FlexKit
 	};
 
 
+	/************************************************************************************************/
+	// Two level occupancy bitmap, one bit per allocation unit that still has space available.
+	// The summary level holds one bit per non-empty word of the first level, so finding a free
+	// unit takes a couple of bit scans instead of a walk over every block in the pool.
+
+	struct FreeSlotBitmap
+	{
+		static size_t WordsNeeded(const size_t bitCount)
+		{
+			const size_t levelOne = (bitCount + 63) / 64;
+			const size_t summary  = (levelOne + 63) / 64;
+
+			return levelOne + summary;
+		}
+
+		void Initialise(uint64_t* IN_words, const size_t IN_bitCount)
+		{
+			words			= IN_words;
+			bitCount		= IN_bitCount;
+			wordCount		= (bitCount + 63) / 64;
+			summary			= words + wordCount;
+			summaryCount	= (wordCount + 63) / 64;
+
+			memset(words, 0, WordsNeeded(bitCount) * sizeof(uint64_t));
+
+			for (size_t itr = 0; itr < bitCount; ++itr)
+				Set(itr);
+		}
+
+		void Set(const size_t idx)
+		{
+			const size_t word = idx / 64;
+
+			words[word]			|= 1ull << (idx % 64);
+			summary[word / 64]	|= 1ull << (word % 64);
+		}
+
+		void Clear(const size_t idx)
+		{
+			const size_t word = idx / 64;
+
+			words[word] &= ~(1ull << (idx % 64));
+
+			if (!words[word])
+				summary[word / 64] &= ~(1ull << (word % 64));
+		}
+
+		size_t FindFirst() const
+		{
+			for (size_t itr = 0; itr < summaryCount; ++itr)
+			{
+				if (summary[itr])
+				{
+					const size_t word = itr * 64 + std::countr_zero(summary[itr]);
+					return word * 64 + std::countr_zero(words[word]);
+				}
+			}
+
+			return -1;
+		}
+
+		uint64_t*	words			= nullptr;
+		uint64_t*	summary			= nullptr;
+		size_t		bitCount		= 0;
+		size_t		wordCount		= 0;
+		size_t		summaryCount	= 0;
+	};
+
+
 	/************************************************************************************************/
 	// 64 Byte Allocator
 
@@ -333,47 +403,60 @@ namespace FlexKit
 			Blocks	{nullptr},
 			Size	{0}{}
 
-		static int MaxAllocationSize() { return sizeof(Block::BlockSize); }
+		static size_t MaxAllocationSize() { return Block::BlockSize; }
 
 		void Initialise( size_t BufferSize, byte* Buffer )// Size in Bytes
 		{
-			size_t AllocationFootPrint = sizeof(Block);
-			Size = BufferSize / AllocationFootPrint;
-			Blocks = reinterpret_cast<Block*>(Buffer);
-			allocated = 0;
-#ifdef _DEBUG
+			Size = BufferSize / sizeof(Block);
+
+			while (Size && Size * sizeof(Block) + FreeSlotBitmap::WordsNeeded(Size) * sizeof(uint64_t) > BufferSize)
+				--Size;
+
+			Blocks		= reinterpret_cast<Block*>(Buffer);
+			allocated	= 0;
+
 			for (size_t itr = 0; itr < Size; ++itr)
 			{
 				Blocks[itr].BlockFull = false;
-				for (size_t itr2 = 0; itr2 < 4; ++itr2)
+				for (size_t itr2 = 0; itr2 < Block::BlockCount; ++itr2)
 					Blocks[itr].state[itr2] = Block::Free;
 			}
-#endif
+
+			freeBlocks.Initialise(reinterpret_cast<uint64_t*>(Blocks + Size), Size);
 		}
 
-		// TODO: maybe Multi-Thread?
+		// Returns nullptr when the pool is exhausted, caller falls back to the next pool
 		byte* malloc(size_t, bool Aligned = false)
 		{
-			for (size_t itr = 0; itr < Size; ++itr)
+			const size_t blockID = freeBlocks.FindFirst();
+
+			if (blockID >= Size)
+				return nullptr;
+
+			auto& block = Blocks[blockID];
+
+			for (size_t itr = 0; itr < Block::BlockCount; ++itr)
 			{
-				if (!Blocks[itr].BlockFull)
+				if (block.state[itr] == Block::Free)
 				{
-					for (size_t itr2 = 0; itr2 < 7; ++itr2)
+					block.state[itr] = Block::Allocated | (Aligned ? Block::Aligned : 0);
+					allocated++;
+
+					bool full = true;
+					for (size_t itr2 = itr + 1; itr2 < Block::BlockCount && full; ++itr2)
+						full = block.state[itr2] != Block::Free;
+
+					if (full)
 					{
-						auto state = Blocks[itr].state[itr2];
-						if (state == Block::Free)
-						{
-							Blocks[itr].state[itr2] = (Block::Allocated || Aligned) ? Block::Aligned : 0;
-							//if(itr2 == Block::BlockCount) Blocks[itr].BlockFull = true;
-							allocated++;
-							return (byte*)&Blocks[itr].data[itr2];
-						}
+						block.BlockFull = true;
+						freeBlocks.Clear(blockID);
 					}
-					Blocks[itr].BlockFull = true;
+
+					return (byte*)&block.data[itr];
 				}
 			}
 
-			FK_ASSERT(0);
+			FK_ASSERT(0, "SMALL BLOCK BITMAP OUT OF SYNC!");
 
 			return nullptr;
 		}
@@ -382,6 +465,7 @@ namespace FlexKit
 		{
 			Blocks[BlockID].state[SBlockID] = Block::Free;
 			Blocks[BlockID].BlockFull = false;
+			freeBlocks.Set(BlockID);
 
 			allocated--;
 		}
@@ -393,24 +477,28 @@ namespace FlexKit
 			size_t BlockID		= (temp1 - temp2) / sizeof(Block);
 			size_t SBlockID		= (temp1 - temp2) % sizeof(Block) / sizeof(Block::c);
 
-			if ( SBlockID == 0x08 )
-#ifdef _DEBUG
+			if (SBlockID >= Block::BlockCount)
 			{
-				FK_ASSERT( 0, "INVALID ADDRESS!!" );
+				FK_ASSERT(0, "INVALID ADDRESS!!");
 				return;
 			}
-#endif
+
 			_FreeBlock(BlockID, SBlockID);
 		}
 
 		void _aligned_free(void* _ptr)
 		{
-			size_t temp1		= (size_t)_ptr;
-			size_t temp2		= (size_t)Blocks;
-			size_t BlockID		= (temp1 - temp2) / sizeof(Block);
-			size_t SBlockID		= (temp1 - temp2) % sizeof(Block) / sizeof(Block::c);
+			free(_ptr);
+		}
 
-			_FreeBlock(BlockID, SBlockID);
+		// Start of the 64 byte slot containing _ptr
+		byte* SlotAddress(void* _ptr)
+		{
+			const size_t offset		= (size_t)_ptr - (size_t)Blocks;
+			const size_t BlockID	= offset / sizeof(Block);
+			const size_t SBlockID	= offset % sizeof(Block) / sizeof(Block::c);
+
+			return (byte*)&Blocks[BlockID].data[SBlockID];
 		}
 
 		struct Block
@@ -434,8 +522,9 @@ namespace FlexKit
 			size_t	Padding[7];
 		}*Blocks;
 
-		size_t Size;
-		size_t allocated;
+		FreeSlotBitmap	freeBlocks;
+		size_t			Size;
+		size_t			allocated;
 	};
 
 
@@ -448,16 +537,22 @@ namespace FlexKit
 		{
 			size_t AllocationFootPrint = sizeof(Block) + sizeof(BlockData);
 			Size		= (BufferSize / AllocationFootPrint) - 1;
+
+			while (Size && (Size + 1) * AllocationFootPrint + FreeSlotBitmap::WordsNeeded(Size) * sizeof(uint64_t) + sizeof(uint64_t) > BufferSize)
+				--Size;
+
 			Blocks		= reinterpret_cast<Block*>(Buffer);
 			BlockTable	= reinterpret_cast<BlockData*>(Blocks + Size + 1);
 
 			for (size_t I = 0; I < Size; ++I)
 				BlockTable[I].state = BlockData::Free;
 
+			const size_t bitmapOffset = ((size_t)(BlockTable + Size) + 7) & ~size_t(7);
+			freeBlocks.Initialise(reinterpret_cast<uint64_t*>(bitmapOffset), Size);
+
 			blocksAllocated = 0;
 		}
 
-		// TODO: maybe Multi-Thread?
 		byte* malloc(size_t size, bool ALIGNED = false, bool DebugMetaData = false)
 		{
 #ifdef _DEBUG
@@ -468,25 +563,45 @@ namespace FlexKit
 			}
 #endif
 
-			for (size_t i = 0; i < Size; ++i)
-				if (BlockTable[i].state == BlockData::Free)
-				{
-					BlockTable[i].state = 
-						BlockData::Allocated | 
-						(ALIGNED		? BlockData::Aligned : 0) | 
-						(DebugMetaData	? BlockData::DebugMD : 0);
+			const size_t i = freeBlocks.FindFirst();
 
-					blocksAllocated++;
-					return (byte*)&Blocks[i];
-				}
+			if (i >= Size)
+				return nullptr;
 
-			throw(std::bad_alloc());
+			BlockTable[i].state = 
+				BlockData::Allocated | 
+				(ALIGNED		? BlockData::Aligned : 0) | 
+				(DebugMetaData	? BlockData::DebugMD : 0);
 
-			return nullptr;
+			freeBlocks.Clear(i);
+			blocksAllocated++;
+
+			return (byte*)&Blocks[i];
+		}
+
+		size_t BlockIndex(const void* _ptr) const
+		{
+			return ((size_t)_ptr - (size_t)Blocks) / sizeof(Block);
+		}
+
+		// Slab blocks are carved into equally sized slots by the BlockAllocator thread caches
+		void MarkSlab(byte* block, const size_t sizeClass)
+		{
+			BlockTable[BlockIndex(block)].state |= BlockData::Slab | (byte)(sizeClass << BlockData::SizeClassShift);
+		}
+
+		bool IsSlab(const void* _ptr) const
+		{
+			return BlockTable[BlockIndex(_ptr)].state & BlockData::Slab;
+		}
+
+		size_t SlabSizeClass(const void* _ptr) const
+		{
+			return BlockTable[BlockIndex(_ptr)].state >> BlockData::SizeClassShift;
 		}
 
 
-		static size_t MaxBlockSize()
+		static constexpr size_t MaxBlockSize()
 		{
 			return sizeof(Block);
 		}
@@ -502,6 +617,7 @@ namespace FlexKit
 
 			blocksAllocated--;
 			BlockTable[index].state = BlockData::Free;
+			freeBlocks.Set(index);
 		}
 
 		void _aligned_free(void* _ptr)
@@ -519,6 +635,7 @@ namespace FlexKit
 
 			blocksAllocated--;
 			BlockTable[index].state = BlockData::Free;
+			freeBlocks.Set(index);
 		}
 
 		struct Block
@@ -534,12 +651,17 @@ namespace FlexKit
 				Allocated	= 0x01,
 				Aligned		= 0x02,
 				DebugMD		= 0x04,
+				Slab		= 0x08,
 			};
+
+			static constexpr byte SizeClassShift = 4; // upper bits of state hold the slab size class
+
 			byte state;
 		}*BlockTable;
 
-		size_t Size;
-		size_t blocksAllocated;
+		FreeSlotBitmap	freeBlocks;
+		size_t			Size;
+		size_t			blocksAllocated;
 	};
 
 
@@ -693,6 +815,120 @@ namespace FlexKit
 	};
 
 
+	/************************************************************************************************/
+	// Per-thread size class free lists that sit in front of the shared block pools.
+	// The owning thread pops and pushes slots without taking BlockAllocator::mu, the shared
+	// pools are only touched to refill or return slots in batches of BatchSize.
+
+	struct BlockAllocatorThreadCache
+	{
+		static constexpr size_t MaxThreadCount			= 128;
+		static constexpr size_t SizeClassCount			= 4; // 64, 128, 256, 512
+		static constexpr size_t MinSlotSize				= 64;
+		static constexpr size_t MaxCachedAllocation		= MinSlotSize << (SizeClassCount - 1);
+		static constexpr size_t BatchSize				= 16;
+		static constexpr size_t MaxCachedSlots			= 2 * BatchSize;
+
+		struct FreeSlot
+		{
+			FreeSlot* next;
+		};
+
+		struct FreeList
+		{
+			void Push(void* _ptr)
+			{
+				auto slot	= static_cast<FreeSlot*>(_ptr);
+				slot->next	= head;
+				head		= slot;
+				count++;
+			}
+
+			byte* Pop()
+			{
+				auto slot	= head;
+				head		= slot->next;
+				count--;
+
+				return reinterpret_cast<byte*>(slot);
+			}
+
+			FreeSlot*	head	= nullptr;
+			size_t		count	= 0;
+		};
+
+		static constexpr size_t SizeClass(const size_t size)
+		{
+			size_t sizeClass = 0;
+			while ((MinSlotSize << sizeClass) < size)
+				sizeClass++;
+
+			return sizeClass;
+		}
+
+		static constexpr size_t SlotSize(const size_t sizeClass)
+		{
+			return MinSlotSize << sizeClass;
+		}
+
+		static constexpr size_t SlotsPerSlab(const size_t sizeClass)
+		{
+			return MediumBlockAllocator::MaxBlockSize() / SlotSize(sizeClass);
+		}
+
+		// Threads beyond MaxThreadCount use the locked path
+		static size_t ThreadIndex()
+		{
+			return LocalThreadIndex();
+		}
+
+		// Indices are handed back by exiting threads after their caches are flushed
+		static void ReleaseThreadIndex()
+		{
+			auto& threadIndex = LocalThreadIndex();
+
+			if (threadIndex < MaxThreadCount)
+			{
+				std::scoped_lock lock{ indexLock };
+				indexInUse[threadIndex] = false;
+			}
+
+			threadIndex = MaxThreadCount;
+		}
+
+		alignas(64) FreeList lists[SizeClassCount];
+
+	private:
+		static size_t& LocalThreadIndex()
+		{
+			thread_local size_t threadIndex = AcquireThreadIndex();
+			return threadIndex;
+		}
+
+		static size_t AcquireThreadIndex()
+		{
+			std::scoped_lock lock{ indexLock };
+
+			for (size_t I = 0; I < MaxThreadCount; ++I)
+			{
+				if (!indexInUse[I])
+				{
+					indexInUse[I] = true;
+					return I;
+				}
+			}
+
+			return MaxThreadCount;
+		}
+
+		inline static std::mutex	indexLock;
+		inline static bool			indexInUse[MaxThreadCount] = {};
+	};
+
+
+	/************************************************************************************************/
+
+
 	struct BlockAllocator_desc
 	{
 		byte* _ptr;
@@ -701,6 +937,8 @@ namespace FlexKit
 		size_t SmallBlock;
 		size_t MediumBlock;
 		size_t LargeBlock;
+
+		bool ThreadCaching = true;
 	};
 
 
@@ -743,11 +981,44 @@ namespace FlexKit
 			MediumBlockAlloc.Initialise	(in.MediumBlock,	(byte*)::_aligned_malloc(Medium,	0x40));
 			LargeBlockAlloc.Initialise	(in.LargeBlock,		(byte*)::_aligned_malloc(Large,		0x40));
 
+			threadCaching	= in.ThreadCaching;
+			slabFreeSlots	= (uint16_t*)::_aligned_malloc(sizeof(uint16_t) * MediumBlockAlloc.Size, 0x40);
+			memset(slabFreeSlots, 0, sizeof(uint16_t) * MediumBlockAlloc.Size);
+
+			if (threadCaching)
+				RegisterThreadCaching(this);
+
 			new(&AllocatorInterface) iBlockAllocator(this);
 		}
 
+		void Release()
+		{
+			if (threadCaching)
+				UnregisterThreadCaching(this);
+
+			::_aligned_free(slabFreeSlots);
+			slabFreeSlots = nullptr;
+		}
+
 		byte* malloc(const size_t size, bool MarkAligned = false, bool MarkDebugMetaData = false)
 		{
+			if (size <= ThreadCache::MaxCachedAllocation && !MarkDebugMetaData)
+			{
+				if (auto cache = GetThreadCache(); cache)
+				{
+					const size_t sizeClass	= ThreadCache::SizeClass(size);
+					auto& list				= cache->lists[sizeClass];
+
+					if (!list.head)
+						RefillThreadCache(list, sizeClass);
+
+					if (list.head)
+						return list.Pop();
+
+					// Pools are exhausted, fall through to the uncached path
+				}
+			}
+
 			std::unique_lock ul{ mu };
 
 			byte* ret = nullptr;
@@ -755,7 +1026,15 @@ namespace FlexKit
 			if (size <= SmallBlockAllocator::MaxAllocationSize())
 				ret = SmallBlockAlloc.malloc(size, MarkAligned);
 			if (size <=  MediumBlockAllocator::MaxBlockSize() && !ret)
+			{
 				ret = MediumBlockAlloc.malloc(size, MarkAligned, MarkDebugMetaData);
+
+				if (!ret && fullyFreeSlabs)
+				{
+					ReclaimFreeSlabs();
+					ret = MediumBlockAlloc.malloc(size, MarkAligned, MarkDebugMetaData);
+				}
+			}
 			if (!ret)
 				ret = LargeBlockAlloc.malloc(size, MarkAligned);
 
@@ -812,6 +1091,9 @@ namespace FlexKit
 			if (_ptr == nullptr)
 				return;
 
+			if (ReleaseSlot(_ptr))
+				return;
+
 			std::unique_lock ul(mu);
 
 			if (InSmallRange(reinterpret_cast<byte*>(_ptr)))
@@ -831,9 +1113,12 @@ namespace FlexKit
 
 		void _aligned_free(void* _ptr)
 		{
+			if (ReleaseSlot(_ptr))
+				return;
+
 			std::unique_lock ul(mu);
 
-			if (InSmallRange((byte*)_ptr) && false)
+			if (InSmallRange((byte*)_ptr))
 				SmallBlockAlloc._aligned_free(_ptr);
 			else if (InMediumRange(static_cast<byte*>(_ptr)))
 				MediumBlockAlloc._aligned_free(_ptr);
@@ -884,11 +1169,271 @@ namespace FlexKit
 			free(&I);
 		}
 
+		using ThreadCache = BlockAllocatorThreadCache;
+
+		ThreadCache* GetThreadCache()
+		{
+			const size_t threadIndex = ThreadCache::ThreadIndex();
+
+			return (threadCaching && threadIndex < ThreadCache::MaxThreadCount) ? &threadCaches[threadIndex] : nullptr;
+		}
+
+		// Returns every slot held by the calling thread's cache to the shared pools.
+		void FlushThreadCache()
+		{
+			if (auto cache = GetThreadCache(); cache)
+			{
+				std::unique_lock ul{ mu };
+
+				for (auto& list : cache->lists)
+					ReturnSlots(list, list.count);
+			}
+		}
+
+		// Returns every fully free slab to the medium block pool, slabs are otherwise reclaimed once enough sit idle
+		void TrimSlabs()
+		{
+			std::unique_lock ul{ mu };
+			ReclaimFreeSlabs();
+		}
+
+		// Flushes the calling thread's cache in every thread caching BlockAllocator and frees its cache index.
+		// Threads call this on exit, slots left in an exiting thread's cache would be stranded otherwise.
+		static void ReleaseThreadCaches()
+		{
+			{
+				std::scoped_lock lock{ registryLock };
+
+				for (auto allocator : registry)
+				{
+					if (allocator)
+						allocator->FlushThreadCache();
+				}
+			}
+
+			ThreadCache::ReleaseThreadIndex();
+		}
+
+		// Pushes slot allocations back onto the calling thread's cache, returns false for
+		// addresses that do not belong to a size class slot.
+		bool ReleaseSlot(void* _ptr)
+		{
+			byte*	slot		= nullptr;
+			size_t	sizeClass	= 0;
+
+			if (InSmallRange(static_cast<byte*>(_ptr)))
+				slot = SmallBlockAlloc.SlotAddress(_ptr);
+			else if (InMediumRange(static_cast<byte*>(_ptr)) && MediumBlockAlloc.IsSlab(_ptr))
+			{
+				sizeClass = MediumBlockAlloc.SlabSizeClass(_ptr);
+
+				const size_t offset		= (size_t)_ptr - (size_t)MediumBlockAlloc.Blocks;
+				const size_t slotSize	= ThreadCache::SlotSize(sizeClass);
+
+				slot = (byte*)MediumBlockAlloc.Blocks + offset / slotSize * slotSize;
+			}
+			else
+				return false;
+
+			auto cache = GetThreadCache();
+
+			if (!cache)
+			{
+				std::unique_lock ul{ mu };
+				ReturnSlot(slot, sizeClass);
+
+				return true;
+			}
+
+			auto& list = cache->lists[sizeClass];
+			list.Push(slot);
+
+			if (list.count > ThreadCache::MaxCachedSlots)
+			{
+				std::unique_lock ul{ mu };
+				ReturnSlots(list, ThreadCache::BatchSize);
+			}
+
+			return true;
+		}
+
+		void RefillThreadCache(ThreadCache::FreeList& list, const size_t sizeClass)
+		{
+			std::unique_lock ul{ mu };
+
+			if (sizeClass == 0)
+			{
+				while (list.count < ThreadCache::BatchSize)
+				{
+					auto slot = SmallBlockAlloc.malloc(ThreadCache::MinSlotSize);
+					if (!slot)
+						break;
+
+					list.Push(slot);
+				}
+			}
+
+			auto& central = slabFreeLists[sizeClass];
+
+			while (list.count < ThreadCache::BatchSize)
+			{
+				if (!central.head)
+				{
+					byte* block = MediumBlockAlloc.malloc(MediumBlockAllocator::MaxBlockSize());
+
+					if (!block && fullyFreeSlabs)
+					{
+						ReclaimFreeSlabs();
+						block = MediumBlockAlloc.malloc(MediumBlockAllocator::MaxBlockSize());
+					}
+
+					if (!block)
+						return; // Caller falls back to the uncached path
+
+					MediumBlockAlloc.MarkSlab(block, sizeClass);
+					slabCount++;
+
+					const size_t slotSize = ThreadCache::SlotSize(sizeClass);
+					for (size_t offset = 0; offset < MediumBlockAllocator::MaxBlockSize(); offset += slotSize)
+						PushSlabSlot(block + offset, sizeClass);
+				}
+
+				list.Push(PopSlabSlot(sizeClass));
+			}
+		}
+
+		// Caller must hold mu
+		void ReturnSlots(ThreadCache::FreeList& list, size_t count)
+		{
+			for (; count && list.head; --count)
+			{
+				byte* slot = list.Pop();
+				ReturnSlot(slot, InSmallRange(slot) ? 0 : MediumBlockAlloc.SlabSizeClass(slot));
+			}
+
+			// Only sweep once a sizable share of the slabs is idle, keeps the sweep amortized over the slabs it frees
+			if (fullyFreeSlabs >= SlabReclaimThreshold && fullyFreeSlabs * 8 >= slabCount)
+				ReclaimFreeSlabs();
+		}
+
+		// Caller must hold mu
+		void ReturnSlot(byte* slot, const size_t sizeClass)
+		{
+			if (InSmallRange(slot))
+				SmallBlockAlloc.free(slot);
+			else
+				PushSlabSlot(slot, sizeClass);
+		}
+
+		// Caller must hold mu
+		void PushSlabSlot(byte* slot, const size_t sizeClass)
+		{
+			auto& freeSlots = slabFreeSlots[MediumBlockAlloc.BlockIndex(slot)];
+
+			if (++freeSlots == ThreadCache::SlotsPerSlab(sizeClass))
+				fullyFreeSlabs++;
+
+			slabFreeLists[sizeClass].Push(slot);
+		}
+
+		// Caller must hold mu
+		byte* PopSlabSlot(const size_t sizeClass)
+		{
+			byte* slot		= slabFreeLists[sizeClass].Pop();
+			auto& freeSlots	= slabFreeSlots[MediumBlockAlloc.BlockIndex(slot)];
+
+			if (freeSlots-- == ThreadCache::SlotsPerSlab(sizeClass))
+				fullyFreeSlabs--;
+
+			return slot;
+		}
+
+		// Hands slabs with every slot on the central free lists back to the medium block pool.
+		// Caller must hold mu
+		void ReclaimFreeSlabs()
+		{
+			constexpr uint16_t Reclaiming = 0x8000;
+
+			for (size_t sizeClass = 0; sizeClass < ThreadCache::SizeClassCount; ++sizeClass)
+			{
+				auto&			central		= slabFreeLists[sizeClass];
+				const size_t	slotCount	= ThreadCache::SlotsPerSlab(sizeClass);
+
+				for (auto link = &central.head; *link;)
+				{
+					auto		slot		= *link;
+					const auto	blockIdx	= MediumBlockAlloc.BlockIndex(slot);
+					auto&		freeSlots	= slabFreeSlots[blockIdx];
+
+					if (freeSlots == slotCount)
+						freeSlots = Reclaiming | slotCount;
+
+					if (!(freeSlots & Reclaiming))
+					{
+						link = &slot->next;
+						continue;
+					}
+
+					*link = slot->next;
+					central.count--;
+
+					if (--freeSlots == Reclaiming)
+					{
+						freeSlots = 0;
+						fullyFreeSlabs--;
+						slabCount--;
+
+						MediumBlockAlloc.free(&MediumBlockAlloc.Blocks[blockIdx]);
+					}
+				}
+			}
+		}
+
+		static void RegisterThreadCaching(BlockAllocator* allocator)
+		{
+			std::scoped_lock lock{ registryLock };
+
+			for (auto& entry : registry)
+			{
+				if (!entry)
+				{
+					entry = allocator;
+					return;
+				}
+			}
+
+			FK_ASSERT(0, "Too many thread caching BlockAllocators!");
+		}
+
+		static void UnregisterThreadCaching(BlockAllocator* allocator)
+		{
+			std::scoped_lock lock{ registryLock };
+
+			for (auto& entry : registry)
+			{
+				if (entry == allocator)
+					entry = nullptr;
+			}
+		}
+
 		SmallBlockAllocator		SmallBlockAlloc;
 		MediumBlockAllocator	MediumBlockAlloc;
 		LargeBlockAllocator		LargeBlockAlloc;
 		std::mutex				mu;
 
+		static constexpr size_t		SlabReclaimThreshold	= 4;
+		static constexpr size_t		MaxRegisteredAllocators	= 8;
+
+		bool						threadCaching	= true;
+		ThreadCache::FreeList		slabFreeLists[ThreadCache::SizeClassCount];
+		ThreadCache					threadCaches[ThreadCache::MaxThreadCount];
+		uint16_t*					slabFreeSlots	= nullptr; // Slots of each medium block sitting on the central free lists
+		size_t						slabCount		= 0;
+		size_t						fullyFreeSlabs	= 0;
+
+		inline static std::mutex		registryLock;
+		inline static BlockAllocator*	registry[MaxRegisteredAllocators] = {};
+
 		char*	Buffer_ptr;
 		size_t	Small, Medium, Large;
 